@@ -17,7 +17,14 @@
 				"src/utils/string_list.cpp",
 				"src/utils/number_list.cpp",
 				"src/utils/warp_options.cpp",
+				"src/utils/raster_io_args.cpp",
+				"src/utils/point_sampler.cpp",
+				"src/utils/calc_expression.cpp",
+				"src/utils/zonal_statistics.cpp",
+				"src/utils/dataset_statistics.cpp",
 				"src/utils/ptr_manager.cpp",
+				"src/utils/async_worker.cpp",
+				"src/utils/job_pool.cpp",
 				"src/node_gdal.cpp",
 				"src/gdal_common.cpp",
 				"src/gdal_dataset.cpp",
@@ -43,7 +50,9 @@
 				"src/gdal_algorithms.cpp",
 				"src/collections/dataset_bands.cpp",
 				"src/collections/dataset_layers.cpp",
+				"src/collections/dataset_pixels.cpp",
 				"src/collections/layer_features.cpp",
+				"src/collections/layer_feature_cursor.cpp",
 				"src/collections/layer_fields.cpp",
 				"src/collections/feature_fields.cpp",
 				"src/collections/feature_defn_fields.cpp",
@@ -52,6 +61,8 @@
 				"src/collections/linestring_points.cpp",
 				"src/collections/rasterband_overviews.cpp",
 				"src/collections/rasterband_pixels.cpp",
+				"src/collections/rasterband_block_iterator.cpp",
+				"src/collections/rasterband_sampler.cpp",
 				"src/collections/gdal_drivers.cpp"
 			],
 			"include_dirs": [
@@ -1,6 +1,7 @@
 /* eslint no-console: 0 */
 const path = require('path');
 const fs = require('fs');
+const Readable = require('stream').Readable;
 const binary = require('@mapbox/node-pre-gyp');
 const binding_path = binary.find(path.join(__dirname, '../package.json'));
 const data_path = path.resolve(__dirname, '../deps/libgdal/gdal/data');
@@ -175,6 +176,112 @@ gdal.LayerFeatures.prototype.forEach = function(callback) {
  */
 gdal.LayerFeatures.prototype.map = defaultMap;
 
+/**
+ * Iterates through all features asynchronously, reading them in batches on a
+ * background thread. Only one batch is decoded ahead of the consumer.
+ *
+ * @example
+ * ```
+ * for await (const feature of layer.features) { ... }```
+ *
+ * @for gdal.LayerFeatures
+ * @method Symbol.asyncIterator
+ * @return {AsyncIterator}
+ */
+if (typeof Symbol.asyncIterator === 'symbol') {
+	gdal.LayerFeatures.prototype[Symbol.asyncIterator] = function() {
+		var cursor = this.cursor();
+		var batch = [];
+		var i = 0;
+		var done = false;
+
+		var finish = function() {
+			done = true;
+			batch = [];
+			cursor.close();
+			return {value: undefined, done: true};
+		};
+
+		var iterator = {
+			next: function() {
+				if (i < batch.length) return Promise.resolve({value: batch[i++], done: false});
+				if (done) return Promise.resolve({value: undefined, done: true});
+				return cursor.nextBatch().then(function(next) {
+					if (!next || !next.length) return finish();
+					batch = next;
+					i = 0;
+					return {value: batch[i++], done: false};
+				}, function(err) {
+					finish();
+					throw err;
+				});
+			},
+			return: function() {
+				return Promise.resolve(finish());
+			}
+		};
+		iterator[Symbol.asyncIterator] = function() { return this; };
+		return iterator;
+	};
+}
+
+/**
+ * Creates an object mode [Readable](https://nodejs.org/api/stream.html#stream_readable_streams)
+ * stream of the layer's features. A batch is only requested once the stream's
+ * buffer drops below `highWaterMark`, so a slow consumer also pauses reading.
+ *
+ * @example
+ * ```
+ * layer.features.stream({batchSize: 500}).on('data', function(feature) { ... });```
+ *
+ * @for gdal.LayerFeatures
+ * @method stream
+ * @param {Object} [options] Accepts the same options as {{#crossLink "gdal.LayerFeatures/cursor:method"}}cursor(){{/crossLink}}.
+ * @param {Integer} [options.highWaterMark=16] Maximum number of features to buffer.
+ * @return {stream.Readable}
+ */
+gdal.LayerFeatures.prototype.stream = function(options) {
+	options = options || {};
+	var cursor = this.cursor(options);
+	var reading = false;
+
+	var readable = new Readable({
+		objectMode: true,
+		highWaterMark: options.highWaterMark,
+		read: function() {
+			if (reading) return;
+			reading = true;
+			cursor.nextBatch().then(function(batch) {
+				reading = false;
+				if (!batch) {
+					cursor.close();
+					readable.push(null);
+					return;
+				}
+				for (var i = 0; i < batch.length; i++) {
+					readable.push(batch[i]);
+				}
+			}, function(err) {
+				reading = false;
+				readable.destroy(err);
+			});
+		},
+		destroy: function(err, callback) {
+			cursor.close();
+			callback(err);
+		}
+	});
+
+	return readable;
+};
+
+gdal.LayerFeatureCursor.prototype.nextBatch = (function() {
+	var nextBatch = gdal.LayerFeatureCursor.prototype.nextBatch;
+	return function() {
+		return callAsync(this, nextBatch, []);
+	};
+})();
+
 /**
  * Iterates through all fields using a callback function.
  *
@@ -572,6 +679,256 @@ gdal.open = (function() {
 	};
 })();
 
+/**
+ * Wraps a typed array in an in-memory (MEM) raster dataset without copying
+ * it. The bands read and write the array's buffer directly, so a computed
+ * raster can be passed to {{#crossLink "gdal/reprojectImage:method"}}reprojectImage{{/crossLink}},
+ * {{#crossLink "gdal/polygonize:method"}}polygonize{{/crossLink}}, etc. at no
+ * extra cost. The dataset keeps a reference to the array for as long as it
+ * (or one of its bands) is reachable; the array's buffer must not be
+ * transferred or detached while the dataset is in use.
+ *
+ * The band data type follows the array type (`Int8Array` is read as `Byte`).
+ *
+ * @example
+ * ```
+ * var data = new Float32Array(width * height);
+ * // ... fill data ...
+ * var ds = gdal.fromTypedArray(data, {
+ *     width: width,
+ *     height: height,
+ *     geoTransform: [0, 1, 0, 0, 0, -1],
+ *     srs: gdal.SpatialReference.fromEPSG(4326)
+ * });```
+ *
+ * @for gdal
+ * @throws Error
+ * @method fromTypedArray
+ * @static
+ * @param {TypedArray} array
+ * @param {Object} options
+ * @param {Integer} options.width
+ * @param {Integer} options.height
+ * @param {Integer} [options.bands=1]
+ * @param {String} [options.interleave="band"] Layout of the bands in the array: `"band"` (each band stored whole, one after another), `"line"` (one row of each band at a time) or `"pixel"` (the values of each pixel stored together)
+ * @param {Number[]} [options.geoTransform]
+ * @param {gdal.SpatialReference} [options.srs]
+ * @return {gdal.Dataset}
+ */
+gdal.fromTypedArray = (function() {
+	var fromTypedArray = gdal.fromTypedArray;
+	return function(array, options) {
+		if (!ArrayBuffer.isView(array)) throw new TypeError('array must be a TypedArray');
+		if (!options) throw new Error('options must be given');
+
+		array._gdal_type = getTypedArrayType(array);
+		var ds = fromTypedArray(array, options.width, options.height, options.bands, options.interleave);
+		if (options.geoTransform) ds.geoTransform = options.geoTransform;
+		if (options.srs) ds.srs = options.srs;
+		return ds;
+	};
+})();
+
+// calls a native method taking a trailing node-style callback, returning a
+// promise. the native method returns a job id, which is cancelled when the
+// (optional) options.signal AbortSignal fires. a job that finished before
+// noticing the abort still resolves, since its work was done. options.priority
+// sets the scheduling class of the job the method queues.
+function callAsync(self, fn, args, options) {
+	var signal = options && options.signal;
+	var priority = options && options.priority;
+	return new Promise(function(resolve, reject) {
+		if (signal && signal.aborted) {
+			reject(abortError());
+			return;
+		}
+
+		var onAbort;
+		var callback = function(err, result) {
+			if (onAbort) signal.removeEventListener('abort', onAbort);
+			if (err) reject(signal && signal.aborted ? abortError() : err);
+			else resolve(result);
+		};
+
+		var id;
+		if (priority) gdal._setNextJobPriority(priority);
+		try {
+			id = fn.apply(self, args.concat([callback]));
+		} finally {
+			if (priority) gdal._setNextJobPriority('normal');
+		}
+
+		if (signal) {
+			onAbort = function() { gdal._cancelJob(id); };
+			signal.addEventListener('abort', onAbort);
+		}
+	});
+}
+
+function abortError() {
+	var err = new Error('Operation cancelled');
+	err.name = 'AbortError';
+	return err;
+}
+
+/**
+ * Opens a dataset on a background thread, leaving the event loop free while
+ * drivers probe the file.
+ *
+ * @example
+ * ```
+ * gdal.openAsync('./data.vrt', 'r', {allowedDrivers: ['VRT']}).then(function(dataset) { ... });```
+ *
+ * @for gdal
+ * @method openAsync
+ * @static
+ * @param {String} path Path to dataset to open
+ * @param {String} [mode="r"] The mode to use to open the file: `"r"` or `"r+"`
+ * @param {Object} [options]
+ * @param {String[]|object} [options.openOptions] Driver-specific open options.
+ * @param {String|String[]} [options.allowedDrivers] Driver name, or list of driver names to attempt to use.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the {{#crossLink "gdal.Dataset"}}Dataset{{/crossLink}}.
+ */
+gdal.openAsync = (function() {
+	var openAsync = gdal.openAsync;
+	return function(filename, mode, options) {
+		if (!options) options = {};
+		var drivers = options.allowedDrivers;
+		if (typeof drivers === 'string') drivers = [drivers];
+		return callAsync(gdal, openAsync, [filename, mode, options.openOptions, drivers], options);
+	};
+})();
+
+gdal.Driver.prototype.openAsync = (function() {
+	var openAsync = gdal.Driver.prototype.openAsync;
+	return function(filename, mode, options) {
+		if (!options) options = {};
+		return callAsync(this, openAsync, [filename, mode, options.openOptions], options);
+	};
+})();
+
+/**
+ * Reprojects a dataset on a background thread. Takes the same options as
+ * {{#crossLink "gdal/reprojectImage:method"}}gdal.reprojectImage(){{/crossLink}}.
+ *
+ * @example
+ * ```
+ * var controller = new AbortController();
+ * gdal.reprojectImageAsync({
+ *     src: src, dst: dst, s_srs: src.srs, t_srs: dst.srs,
+ *     progress: function(complete) { console.log(Math.round(complete * 100) + '%'); },
+ *     signal: controller.signal
+ * }).then(function() { ... });```
+ *
+ * @for gdal
+ * @method reprojectImageAsync
+ * @static
+ * @param {object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1), at most every 100ms.
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted. The promise rejects with an `AbortError`.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+gdal.reprojectImageAsync = (function() {
+	var reprojectImageAsync = gdal.reprojectImageAsync;
+	return function(options) {
+		if (!options) options = {};
+		return callAsync(gdal, reprojectImageAsync, [options, options.progress], options);
+	};
+})();
+
+['fillNodata', 'contourGenerate', 'sieveFilter', 'polygonize', 'zonalStatistics'].forEach(function(name) {
+	var fn = gdal[name + 'Async'];
+	gdal[name + 'Async'] = function(options) {
+		if (!options) options = {};
+		return callAsync(gdal, fn, [options, options.progress], options);
+	};
+});
+
+gdal.checksumImageAsync = (function() {
+	var checksumImageAsync = gdal.checksumImageAsync;
+	return function(src, x, y, w, h, options) {
+		if (!options) options = {};
+		return callAsync(gdal, checksumImageAsync, [src, x, y, w, h, options.progress], options);
+	};
+})();
+
+// gdal.calc() writes to a new in-memory band shaped like the first input
+// when no output is given
+function calcOptions(options) {
+	if (!options || options.output || !options.inputs) return options;
+	var first = options.inputs[Object.keys(options.inputs)[0]];
+	if (!(first instanceof gdal.RasterBand)) return options;
+
+	var ds = gdal.open('temp', 'w', 'MEM', first.size.x, first.size.y, 1, options.type || gdal.GDT_Float64);
+	var geoTransform = first.ds.geoTransform;
+	if (geoTransform) ds.geoTransform = geoTransform;
+	var srs = first.ds.srs;
+	if (srs) ds.srs = srs;
+	var output = ds.bands.get(1);
+	if (typeof options.nodata === 'number') output.noDataValue = options.nodata;
+
+	return Object.assign({}, options, {output: output});
+}
+
+gdal.calc = (function() {
+	var calc = gdal.calc;
+	return function(options) {
+		if (!options) return calc.call(gdal); // throws "options must be given"
+		options = calcOptions(options);
+		calc.call(gdal, options);
+		return options.output;
+	};
+})();
+
+gdal.calcAsync = (function() {
+	var calcAsync = gdal.calcAsync;
+	return function(options) {
+		if (!options) options = {};
+		try {
+			options = calcOptions(options);
+		} catch (err) {
+			return Promise.reject(err);
+		}
+		return callAsync(gdal, calcAsync, [options, options.progress], options).then(function() {
+			return options.output;
+		});
+	};
+})();
+
+gdal.Driver.prototype.createCopyAsync = (function() {
+	var createCopyAsync = gdal.Driver.prototype.createCopyAsync;
+	return function(filename, src, options) {
+		if (!options) options = {};
+		return callAsync(this, createCopyAsync, [filename, src, options.options, options.progress], options);
+	};
+})();
+
+gdal.RasterBand.prototype.getHistogramAsync = (function() {
+	var getHistogramAsync = gdal.RasterBand.prototype.getHistogramAsync;
+	return function(options) {
+		if (!options) options = {};
+		return callAsync(this, getHistogramAsync, [options, options.progress], options);
+	};
+})();
+
+gdal.Dataset.prototype.buildOverviewsAsync = (function() {
+	var buildOverviewsAsync = gdal.Dataset.prototype.buildOverviewsAsync;
+	return function(resampling, overviews, options) {
+		if (!options) options = {};
+		return callAsync(this, buildOverviewsAsync, [resampling, overviews, options.bands, options.progress], options);
+	};
+})();
+
+gdal.Dataset.prototype.computeStatisticsAsync = (function() {
+	var computeStatisticsAsync = gdal.Dataset.prototype.computeStatisticsAsync;
+	return function(options) {
+		if (!options) options = {};
+		return callAsync(this, computeStatisticsAsync, [options, options.progress], options);
+	};
+})();
+
 function fieldTypeFromValue(val) {
 	var type = typeof val;
 	if (type === 'number') {
@@ -669,7 +1026,7 @@ gdal.RasterBandPixels.prototype.read = (function() {
 	return function(x, y, width, height, data, options) {
 		if (!options) options = {};
 		if (data) data._gdal_type = getTypedArrayType(data);
-		return read.apply(this, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.type, options.pixel_space, options.line_space]);
+		return read.apply(this, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.type, options.pixel_space, options.line_space, options.shared, options.resampling, options.useOverviews, options.stats]);
 	};
 })();
 
@@ -684,9 +1041,14 @@ gdal.RasterBandPixels.prototype.write = (function() {
 
 gdal.RasterBandPixels.prototype.readBlock = (function() {
 	var readBlock = gdal.RasterBandPixels.prototype.readBlock;
-	return function(x, y, data) {
+	return function(x, y, data, options) {
+		if (data && !ArrayBuffer.isView(data)) {
+			options = data;
+			data = undefined;
+		}
+		if (!options) options = {};
 		if (data) data._gdal_type = getTypedArrayType(data);
-		return readBlock.apply(this, arguments);
+		return readBlock.apply(this, [x, y, data, options.shared]);
 	};
 })();
 
@@ -697,3 +1059,115 @@ gdal.RasterBandPixels.prototype.writeBlock = (function() {
 		return writeBlock.apply(this, arguments);
 	};
 })();
+
+gdal.RasterBandPixels.prototype.readAsync = (function() {
+	var readAsync = gdal.RasterBandPixels.prototype.readAsync;
+	return function(x, y, width, height, data, options) {
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return callAsync(this, readAsync, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.type, options.pixel_space, options.line_space, options.shared, options.resampling, options.useOverviews, options.stats], options);
+	};
+})();
+
+gdal.RasterBandPixels.prototype.writeAsync = (function() {
+	var writeAsync = gdal.RasterBandPixels.prototype.writeAsync;
+	return function(x, y, width, height, data, options) {
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return callAsync(this, writeAsync, [x, y, width, height, data, options.buffer_width, options.buffer_height, options.pixel_space, options.line_space], options);
+	};
+})();
+
+gdal.RasterBandPixels.prototype.readBlockAsync = (function() {
+	var readBlockAsync = gdal.RasterBandPixels.prototype.readBlockAsync;
+	return function(x, y, data, options) {
+		if (data && !ArrayBuffer.isView(data)) {
+			options = data;
+			data = undefined;
+		}
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return callAsync(this, readBlockAsync, [x, y, data, options.shared], options);
+	};
+})();
+
+gdal.RasterBandPixels.prototype.writeBlockAsync = (function() {
+	var writeBlockAsync = gdal.RasterBandPixels.prototype.writeBlockAsync;
+	return function(x, y, data, options) {
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return callAsync(this, writeBlockAsync, [x, y, data], options);
+	};
+})();
+
+gdal.RasterBandPixels.prototype.lockBlock = (function() {
+	var lockBlock = gdal.RasterBandPixels.prototype.lockBlock;
+	return function(x, y) {
+		var pixels = this;
+		var data = lockBlock.call(this, x, y);
+		Object.defineProperty(data, 'release', {
+			value: function() { pixels.releaseBlock(data); }
+		});
+		return data;
+	};
+})();
+
+/**
+ * Returns the iterator itself, so it can be used in `for...of` loops.
+ *
+ * @example
+ * ```
+ * for (var block of band.pixels.blocks()) { ... }```
+ *
+ * @for gdal.RasterBandBlockIterator
+ * @method Symbol.iterator
+ * @return {gdal.RasterBandBlockIterator}
+ */
+if (typeof Symbol === 'function' && typeof Symbol.iterator === 'symbol') {
+	gdal.RasterBandBlockIterator.prototype[Symbol.iterator] = function() {
+		return this;
+	};
+}
+
+gdal.RasterBandSampler.prototype.getMany = (function() {
+	var getMany = gdal.RasterBandSampler.prototype.getMany;
+	return function(x, y, data) {
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return getMany.call(this, x, y, data);
+	};
+})();
+
+gdal.DatasetPixels.prototype.read = (function() {
+	var read = gdal.DatasetPixels.prototype.read;
+	return function(x, y, width, height, data, options) {
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return read.apply(this, [x, y, width, height, data, options.bands, options.interleave, options.data_type, options.buffer_width, options.buffer_height, options.shared, options.resampling, options.useOverviews, options.stats]);
+	};
+})();
+
+gdal.DatasetPixels.prototype.write = (function() {
+	var write = gdal.DatasetPixels.prototype.write;
+	return function(x, y, width, height, data, options) {
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return write.apply(this, [x, y, width, height, data, options.bands, options.interleave, options.buffer_width, options.buffer_height]);
+	};
+})();
+
+gdal.DatasetPixels.prototype.readAsync = (function() {
+	var readAsync = gdal.DatasetPixels.prototype.readAsync;
+	return function(x, y, width, height, data, options) {
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return callAsync(this, readAsync, [x, y, width, height, data, options.bands, options.interleave, options.data_type, options.buffer_width, options.buffer_height, options.shared, options.resampling, options.useOverviews, options.stats], options);
+	};
+})();
+
+gdal.DatasetPixels.prototype.writeAsync = (function() {
+	var writeAsync = gdal.DatasetPixels.prototype.writeAsync;
+	return function(x, y, width, height, data, options) {
+		if (!options) options = {};
+		if (data) data._gdal_type = getTypedArrayType(data);
+		return callAsync(this, writeAsync, [x, y, width, height, data, options.bands, options.interleave, options.buffer_width, options.buffer_height], options);
+	};
+})();
@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> DatasetBands::constructor;
+thread_local Nan::Persistent<FunctionTemplate> DatasetBands::constructor;
 
 void DatasetBands::Initialize(Local<Object> target)
 {
@@ -171,6 +171,7 @@ NAN_METHOD(DatasetBands::create)
 		return; //error parsing creation options
 	}
 
+	DatasetLock lock(ds->uid);
 	CPLErr err = raw->AddBand(type, options.get());
 
 	if(err) {
@@ -7,7 +7,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> DatasetLayers::constructor;
+thread_local Nan::Persistent<FunctionTemplate> DatasetLayers::constructor;
 
 void DatasetLayers::Initialize(Local<Object> target)
 {
@@ -189,6 +189,7 @@ NAN_METHOD(DatasetLayers::create)
 	OGRSpatialReference *srs = NULL;
 	if(spatial_ref) srs = spatial_ref->get();
 
+	DatasetLock lock(ds->uid);
 	OGRLayer *layer = raw->CreateLayer(layer_name.c_str(),
 					  srs,
 					  geom_type,
@@ -275,6 +276,7 @@ NAN_METHOD(DatasetLayers::copy)
 		return; //error parsing string list
 	}
 
+	DatasetLock lock({ds->uid, layer_to_copy->uid});
 	OGRLayer *layer = raw->CopyLayer(layer_to_copy->get(),
 										   new_name.c_str(),
 										   options.get());
@@ -319,6 +321,8 @@ NAN_METHOD(DatasetLayers::remove)
 
 	int i;
 	NODE_ARG_INT(0, "layer index", i);
+
+	DatasetLock lock(ds->uid);
 	OGRErr err = raw->DeleteLayer(i);
 	if(err) {
 		NODE_THROW_OGRERR(err);
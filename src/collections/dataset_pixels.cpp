@@ -0,0 +1,594 @@
+#include "../gdal_common.hpp"
+#include "../gdal_dataset.hpp"
+#include "dataset_pixels.hpp"
+#include "../utils/typed_array.hpp"
+#include "../utils/async_worker.hpp"
+#include "../utils/raster_io_args.hpp"
+
+#include <climits>
+#include <vector>
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> DatasetPixels::constructor;
+
+// Reads the window of each band into the buffer. With use_overviews, picks
+// the overview level best matching the buffer size for the first band and
+// reads every band from that level, one band at a time (there is no
+// dataset-level RasterIO on overviews). The level is only used if every band
+// has a matching overview. Sets `overview` to the level read from, or -1,
+// and rescales the window to it.
+static CPLErr readPixels(GDALDataset *raw, std::vector<int> &bands, bool use_overviews, int &overview,
+	int &x, int &y, int &w, int &h, void *data, int buffer_w, int buffer_h, GDALDataType type,
+	GSpacing pixel_space, GSpacing line_space, GSpacing band_space, GDALRasterIOExtraArg *extra)
+{
+	overview = -1;
+
+	if(use_overviews) {
+		int ovr_x = x, ovr_y = y, ovr_w = w, ovr_h = h;
+		GDALRasterIOExtraArg ovr_extra = *extra;
+		GDALRasterBand *first = raw->GetRasterBand(bands[0]);
+		int level = GDALBandGetBestOverviewLevel2(first, ovr_x, ovr_y, ovr_w, ovr_h, buffer_w, buffer_h, &ovr_extra);
+
+		for(unsigned int i = 0; level >= 0 && i < bands.size(); i++) {
+			GDALRasterBand *ovr = raw->GetRasterBand(bands[i])->GetOverview(level);
+			if(!ovr || ovr->GetXSize() != first->GetOverview(level)->GetXSize() || ovr->GetYSize() != first->GetOverview(level)->GetYSize()) {
+				level = -1;
+			}
+		}
+
+		if(level >= 0) {
+			overview = level;
+			x = ovr_x;
+			y = ovr_y;
+			w = ovr_w;
+			h = ovr_h;
+			*extra = ovr_extra;
+			for(unsigned int i = 0; i < bands.size(); i++) {
+				GDALRasterBand *ovr = raw->GetRasterBand(bands[i])->GetOverview(level);
+				CPLErr err = ovr->RasterIO(GF_Read, x, y, w, h, static_cast<GByte*>(data) + i * band_space, buffer_w, buffer_h, type, pixel_space, line_space, extra);
+				if(err) return err;
+			}
+			return CE_None;
+		}
+	}
+
+	return raw->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, bands.size(), &bands[0], pixel_space, line_space, band_space, extra);
+}
+
+/*
+ * Performs a multi-band read / write on the job pool. The dataset object and
+ * the typed array are kept alive in persistent handles until the callback
+ * fires.
+ */
+class DatasetPixelsWorker : public AsyncWorker {
+public:
+	DatasetPixelsWorker(Nan::Callback *callback, GDALRWFlag flag, Dataset *ds, Local<Object> ds_obj, Local<Object> array, void *data)
+		: AsyncWorker(callback, "gdal:DatasetPixels"), flag(flag), raw(ds->getDataset()), data(data),
+		  x(0), y(0), w(0), h(0), buffer_w(0), buffer_h(0), type(GDT_Unknown), bands(),
+		  pixel_space(0), line_space(0), band_space(0), use_overviews(false), overview(-1)
+	{
+		SaveToPersistent("dataset", ds_obj);
+		SaveToPersistent("array", array);
+		useDataset(ds->uid);
+		INIT_RASTERIO_EXTRA_ARG(extra);
+	}
+
+	void setWindow(int x, int y, int w, int h, int buffer_w, int buffer_h, GDALDataType type, const std::vector<int> &bands, GSpacing pixel_space, GSpacing line_space, GSpacing band_space)
+	{
+		this->x = x;
+		this->y = y;
+		this->w = w;
+		this->h = h;
+		this->buffer_w = buffer_w;
+		this->buffer_h = buffer_h;
+		this->type = type;
+		this->bands = bands;
+		this->pixel_space = pixel_space;
+		this->line_space = line_space;
+		this->band_space = band_space;
+	}
+
+	void setExtraArg(const GDALRasterIOExtraArg *extra)
+	{
+		this->extra = *extra;
+	}
+
+	void setUseOverviews(bool use_overviews, Local<Object> stats)
+	{
+		this->use_overviews = use_overviews;
+		if(!stats.IsEmpty()) {
+			SaveToPersistent("stats", stats);
+		}
+	}
+
+protected:
+	void Run()
+	{
+		CPLErr err;
+		if(flag == GF_Read) {
+			err = readPixels(raw, bands, use_overviews, overview, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, band_space, &extra);
+		} else {
+			err = raw->RasterIO(GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, bands.size(), &bands[0], pixel_space, line_space, band_space, &extra);
+		}
+		if(err) {
+			SetErrorFromCPL("Error performing raster I/O");
+		}
+	}
+
+	Local<Value> Result()
+	{
+		if(flag == GF_Read) {
+			Local<Value> stats = GetFromPersistent("stats");
+			if(stats->IsObject()) {
+				RasterIOArgs::setStats(stats.As<Object>(), overview, w, h, bands.size(), raw->GetRasterBand(bands[0])->GetRasterDataType());
+			}
+			return GetFromPersistent("array");
+		}
+		return Nan::Undefined();
+	}
+
+private:
+	GDALRWFlag flag;
+	GDALDataset *raw;
+	void *data;
+	int x, y, w, h;
+	int buffer_w, buffer_h;
+	GDALDataType type;
+	std::vector<int> bands;
+	GSpacing pixel_space, line_space, band_space;
+	GDALRasterIOExtraArg extra;
+	bool use_overviews;
+	int overview;
+};
+
+// Fills `bands` with the 1-based band ids in `value`, or every band of the
+// dataset if it's undefined. Throws and returns false if a band is invalid.
+static bool parseBands(GDALDataset *raw, Local<Value> value, std::vector<int> &bands)
+{
+	int count = raw->GetRasterCount();
+
+	if(value.IsEmpty() || value->IsUndefined() || value->IsNull()) {
+		for(int i = 1; i <= count; i++) {
+			bands.push_back(i);
+		}
+	} else if(value->IsArray()) {
+		Local<Array> arr = value.As<Array>();
+		for(unsigned int i = 0; i < arr->Length(); i++) {
+			Local<Value> val = Nan::Get(arr, i).ToLocalChecked();
+			if(!val->IsInt32()) {
+				Nan::ThrowTypeError("bands array must only contain integers");
+				return false;
+			}
+			int band = Nan::To<int32_t>(val).ToChecked();
+			if(band < 1 || band > count) {
+				Nan::ThrowRangeError("invalid band id");
+				return false;
+			}
+			bands.push_back(band);
+		}
+	} else {
+		Nan::ThrowTypeError("bands must be an array");
+		return false;
+	}
+
+	if(bands.empty()) {
+		Nan::ThrowError("No bands to read / write");
+		return false;
+	}
+	return true;
+}
+
+// Computes the buffer layout for an interleave mode. Throws and returns false
+// if the mode is unknown.
+static bool getSpacing(const std::string &interleave, int bytes_per_pixel, int band_count, int buffer_w, int buffer_h, GSpacing &pixel_space, GSpacing &line_space, GSpacing &band_space)
+{
+	if(interleave == "pixel") {
+		pixel_space = (GSpacing) bytes_per_pixel * band_count;
+		line_space  = pixel_space * buffer_w;
+		band_space  = bytes_per_pixel;
+	} else if(interleave == "line") {
+		pixel_space = bytes_per_pixel;
+		band_space  = pixel_space * buffer_w;
+		line_space  = band_space * band_count;
+	} else if(interleave == "band") {
+		pixel_space = bytes_per_pixel;
+		line_space  = pixel_space * buffer_w;
+		band_space  = line_space * buffer_h;
+	} else {
+		Nan::ThrowError("interleave must be \"pixel\", \"line\" or \"band\"");
+		return false;
+	}
+	return true;
+}
+
+void DatasetPixels::Initialize(Local<Object> target)
+{
+	Nan::HandleScope scope;
+
+	Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(DatasetPixels::New);
+	lcons->InstanceTemplate()->SetInternalFieldCount(1);
+	lcons->SetClassName(Nan::New("DatasetPixels").ToLocalChecked());
+
+	Nan::SetPrototypeMethod(lcons, "toString", toString);
+	Nan::SetPrototypeMethod(lcons, "read", read);
+	Nan::SetPrototypeMethod(lcons, "write", write);
+	Nan::SetPrototypeMethod(lcons, "readAsync", readAsync);
+	Nan::SetPrototypeMethod(lcons, "writeAsync", writeAsync);
+
+	Nan::Set(target, Nan::New("DatasetPixels").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+	constructor.Reset(lcons);
+}
+
+DatasetPixels::DatasetPixels()
+	: Nan::ObjectWrap()
+{}
+
+DatasetPixels::~DatasetPixels()
+{}
+
+/**
+ * A representation of a {{#crossLink "gdal.Dataset"}}Dataset{{/crossLink}}'s
+ * pixels across several bands at once. Reads and writes go through a single
+ * `GDALDataset::RasterIO()` call, so drivers storing bands interleaved (e.g.
+ * RGB GeoTIFFs) only decode each block once.
+ *
+ * ```
+ * var ds = gdal.open('rgb.tif');
+ * // r, g, b, r, g, b, ...
+ * var rgb = ds.pixels.read(0, 0, 256, 256, null, {bands: [1, 2, 3], interleave: 'pixel'});```
+ *
+ * @class gdal.DatasetPixels
+ */
+NAN_METHOD(DatasetPixels::New)
+{
+	Nan::HandleScope scope;
+
+	if (!info.IsConstructCall()) {
+		Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+		return;
+	}
+	if (info[0]->IsExternal()) {
+		Local<External> ext = info[0].As<External>();
+		void* ptr = ext->Value();
+		DatasetPixels *f = static_cast<DatasetPixels *>(ptr);
+		f->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+		return;
+	} else {
+		Nan::ThrowError("Cannot create DatasetPixels directly");
+		return;
+	}
+}
+
+Local<Value> DatasetPixels::New(Local<Value> ds_obj)
+{
+	Nan::EscapableHandleScope scope;
+
+	DatasetPixels *wrapped = new DatasetPixels();
+
+	v8::Local<v8::Value> ext = Nan::New<External>(wrapped);
+	v8::Local<v8::Object> obj = Nan::NewInstance(Nan::GetFunction(Nan::New(DatasetPixels::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
+	Nan::SetPrivate(obj, Nan::New("parent_").ToLocalChecked(), ds_obj);
+
+	return scope.Escape(obj);
+}
+
+NAN_METHOD(DatasetPixels::toString)
+{
+	Nan::HandleScope scope;
+	info.GetReturnValue().Set(Nan::New("DatasetPixels").ToLocalChecked());
+}
+
+/**
+ * Reads a region of pixels from several bands into one array. As with
+ * {{#crossLink "gdal.RasterBandPixels/read:method"}}RasterBandPixels.read(){{/crossLink}},
+ * the window may have fractional coordinates.
+ *
+ * @method read
+ * @throws Error
+ * @param {Number} x
+ * @param {Number} y
+ * @param {Number} width
+ * @param {Number} height
+ * @param {TypedArray} [data] The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {Object} [options]
+ * @param {Integer[]} [options.bands] Band ids (1-based) to read, in buffer order. Defaults to every band.
+ * @param {String} [options.interleave="pixel"] Buffer layout: `"pixel"` (`r, g, b, r, g, b, ...`), `"line"` (one row of each band in turn) or `"band"` (each band's window in turn).
+ * @param {String} [options.data_type] See {{#crossLink "Constants (GDT)"}}GDT constants{{/crossLink}}. Defaults to the type of the first band.
+ * @param {Integer} [options.buffer_width=x_size]
+ * @param {Integer} [options.buffer_height=y_size]
+ * @param {String} [options.resampling="nearest"] `"nearest"`, `"bilinear"`, `"cubic"`, `"cubicspline"`, `"lanczos"`, `"average"`, `"mode"` or `"gauss"`.
+ * @param {Boolean} [options.useOverviews=false] Read from the overview level best matching the buffer size. Only used if every band has that level.
+ * @param {Object} [options.stats] An object to fill with the `overview` level read from (`-1` for full resolution) and the estimated `bytesDecoded` of the source windows.
+ * @param {Boolean} [options.shared=false] Allocate the array on a `SharedArrayBuffer`. Ignored if `data` is given.
+ * @return {TypedArray} A [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of `width * height * bands.length` values.
+ */
+NAN_METHOD(DatasetPixels::read)
+{
+	readImpl(info, false);
+}
+
+/**
+ * Reads a region of pixels from several bands on a background thread. Takes
+ * the same arguments as {{#crossLink "gdal.DatasetPixels/read:method"}}read(){{/crossLink}}.
+ *
+ * @method readAsync
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {Integer} width
+ * @param {Integer} height
+ * @param {TypedArray} [data]
+ * @param {Object} [options]
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
+ */
+NAN_METHOD(DatasetPixels::readAsync)
+{
+	readImpl(info, true);
+}
+
+void DatasetPixels::readImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	Dataset *ds = Nan::ObjectWrap::Unwrap<Dataset>(parent);
+	if (!ds->isAlive()) {
+		Nan::ThrowError("Dataset object has already been destroyed");
+		return;
+	}
+
+	#if GDAL_VERSION_MAJOR < 2
+	if (ds->uses_ogr) {
+		Nan::ThrowError("Dataset does not support raster I/O");
+		return;
+	}
+	#endif
+
+	GDALDataset *raw = ds->getDataset();
+	int x, y, w, h;
+	int buffer_w, buffer_h;
+	int bytes_per_pixel;
+	GSpacing pixel_space, line_space, band_space;
+	double length;
+	bool shared = false;
+	void *data;
+	Local<Value>  array;
+	Local<Object> obj;
+	GDALDataType type;
+	std::vector<int> bands;
+	std::string interleave = "pixel";
+	std::string type_name = "";
+	RasterIOArgs args;
+	bool use_overviews = false;
+	Local<Object> stats;
+
+	if(args.parseWindow(info[0], info[1], info[2], info[3])) {
+		return; // error parsing window
+	}
+	if(args.parseResampling(info[11])) {
+		return; // error parsing resampling
+	}
+	x = args.x();
+	y = args.y();
+	w = args.width();
+	h = args.height();
+
+	if(!parseBands(raw, info[5], bands)) {
+		return;
+	}
+	NODE_ARG_OPT_STR(6, "interleave", interleave);
+	NODE_ARG_OPT_STR(7, "data_type", type_name);
+
+	buffer_w = w;
+	buffer_h = h;
+	type     = raw->GetRasterBand(bands[0])->GetRasterDataType();
+	NODE_ARG_INT_OPT(8, "buffer_width", buffer_w);
+	NODE_ARG_INT_OPT(9, "buffer_height", buffer_h);
+	NODE_ARG_BOOL_OPT(10, "shared", shared);
+	NODE_ARG_BOOL_OPT(12, "useOverviews", use_overviews);
+	if(info.Length() > 13 && !info[13]->IsUndefined() && !info[13]->IsNull()) {
+		NODE_ARG_OBJECT(13, "stats", stats);
+	}
+	if(!type_name.empty()) {
+		type = GDALGetDataTypeByName(type_name.c_str());
+	}
+
+	if(info.Length() >= 5 && !info[4]->IsUndefined() && !info[4]->IsNull()) {
+		NODE_ARG_OBJECT(4, "data", obj);
+		type = TypedArray::Identify(obj);
+		if(type == GDT_Unknown) {
+			Nan::ThrowError("Invalid array");
+			return;
+		}
+	}
+
+	bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+	if(!getSpacing(interleave, bytes_per_pixel, bands.size(), buffer_w, buffer_h, pixel_space, line_space, band_space)) {
+		return;
+	}
+
+	length = (double) buffer_w * buffer_h * bands.size();
+	if(length > INT_MAX) {
+		Nan::ThrowRangeError("Buffer is too large");
+		return;
+	}
+
+	//create array if no array was passed
+	if(obj.IsEmpty()){
+		array = TypedArray::New(type, length, shared);
+		if(array.IsEmpty() || !array->IsObject()) {
+			return; //TypedArray::New threw an error
+		}
+		obj = array.As<Object>();
+	}
+
+	data = TypedArray::Validate(obj, type, length);
+	if(!data) {
+		return; //TypedArray::Validate threw an error
+	}
+
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(14, "callback", callback);
+
+		DatasetPixelsWorker *worker = new DatasetPixelsWorker(callback, GF_Read, ds, parent, obj, data);
+		worker->setWindow(x, y, w, h, buffer_w, buffer_h, type, bands, pixel_space, line_space, band_space);
+		worker->setExtraArg(args.get());
+		worker->setUseOverviews(use_overviews, stats);
+		job_pool.queue(worker);
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	int overview;
+	CPLErr err;
+	{
+		DatasetLock lock(ds->uid);
+		err = readPixels(raw, bands, use_overviews, overview, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, band_space, args.get());
+	}
+	if(err) {
+		NODE_THROW_CPLERR(err);
+		return;
+	}
+
+	if(!stats.IsEmpty()) {
+		RasterIOArgs::setStats(stats, overview, w, h, bands.size(), raw->GetRasterBand(bands[0])->GetRasterDataType());
+	}
+
+	info.GetReturnValue().Set(obj);
+}
+
+/**
+ * Writes a region of pixels to several bands from one array.
+ *
+ * @method write
+ * @throws Error
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {Integer} width
+ * @param {Integer} height
+ * @param {TypedArray} data The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to write, laid out as given by `options.interleave`.
+ * @param {Object} [options]
+ * @param {Integer[]} [options.bands] Band ids (1-based) to write, in buffer order. Defaults to every band.
+ * @param {String} [options.interleave="pixel"] `"pixel"`, `"line"` or `"band"`. See {{#crossLink "gdal.DatasetPixels/read:method"}}read(){{/crossLink}}.
+ * @param {Integer} [options.buffer_width=x_size]
+ * @param {Integer} [options.buffer_height=y_size]
+ */
+NAN_METHOD(DatasetPixels::write)
+{
+	writeImpl(info, false);
+}
+
+/**
+ * Writes a region of pixels to several bands on a background thread. Takes
+ * the same arguments as {{#crossLink "gdal.DatasetPixels/write:method"}}write(){{/crossLink}}.
+ * The array must not be modified until the returned promise settles.
+ *
+ * @method writeAsync
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {Integer} width
+ * @param {Integer} height
+ * @param {TypedArray} data
+ * @param {Object} [options]
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(DatasetPixels::writeAsync)
+{
+	writeImpl(info, true);
+}
+
+void DatasetPixels::writeImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	Dataset *ds = Nan::ObjectWrap::Unwrap<Dataset>(parent);
+	if (!ds->isAlive()) {
+		Nan::ThrowError("Dataset object has already been destroyed");
+		return;
+	}
+
+	#if GDAL_VERSION_MAJOR < 2
+	if (ds->uses_ogr) {
+		Nan::ThrowError("Dataset does not support raster I/O");
+		return;
+	}
+	#endif
+
+	GDALDataset *raw = ds->getDataset();
+	int x, y, w, h;
+	int buffer_w, buffer_h;
+	int bytes_per_pixel;
+	GSpacing pixel_space, line_space, band_space;
+	double length;
+	void *data;
+	Local<Object> passed_array;
+	GDALDataType type;
+	std::vector<int> bands;
+	std::string interleave = "pixel";
+
+	NODE_ARG_INT(0, "x_offset", x);
+	NODE_ARG_INT(1, "y_offset", y);
+	NODE_ARG_INT(2, "x_size", w);
+	NODE_ARG_INT(3, "y_size", h);
+	NODE_ARG_OBJECT(4, "data", passed_array);
+
+	if(!parseBands(raw, info[5], bands)) {
+		return;
+	}
+	NODE_ARG_OPT_STR(6, "interleave", interleave);
+
+	buffer_w = w;
+	buffer_h = h;
+	NODE_ARG_INT_OPT(7, "buffer_width", buffer_w);
+	NODE_ARG_INT_OPT(8, "buffer_height", buffer_h);
+
+	type = TypedArray::Identify(passed_array);
+	if(type == GDT_Unknown) {
+		Nan::ThrowError("Invalid array");
+		return;
+	}
+
+	bytes_per_pixel = GDALGetDataTypeSize(type) / 8;
+	if(!getSpacing(interleave, bytes_per_pixel, bands.size(), buffer_w, buffer_h, pixel_space, line_space, band_space)) {
+		return;
+	}
+
+	length = (double) buffer_w * buffer_h * bands.size();
+	if(length > INT_MAX) {
+		Nan::ThrowRangeError("Buffer is too large");
+		return;
+	}
+
+	data = TypedArray::Validate(passed_array, type, length);
+	if(!data){
+		return; //TypedArray::Validate threw an error
+	}
+
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(9, "callback", callback);
+
+		DatasetPixelsWorker *worker = new DatasetPixelsWorker(callback, GF_Write, ds, parent, passed_array, data);
+		worker->setWindow(x, y, w, h, buffer_w, buffer_h, type, bands, pixel_space, line_space, band_space);
+		job_pool.queue(worker);
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	DatasetLock lock(ds->uid);
+	CPLErr err = raw->RasterIO(GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, bands.size(), &bands[0], pixel_space, line_space, band_space);
+	if(err) {
+		NODE_THROW_CPLERR(err);
+		return;
+	}
+
+	return;
+}
+
+} // namespace node_gdal
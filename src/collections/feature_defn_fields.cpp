@@ -5,7 +5,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> FeatureDefnFields::constructor;
+thread_local Nan::Persistent<FunctionTemplate> FeatureDefnFields::constructor;
 
 void FeatureDefnFields::Initialize(Local<Object> target)
 {
@@ -23,7 +23,7 @@ namespace node_gdal {
 
 class FeatureDefnFields: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
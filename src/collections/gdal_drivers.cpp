@@ -4,7 +4,19 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> GDALDrivers::constructor;
+thread_local Nan::Persistent<FunctionTemplate> GDALDrivers::constructor;
+
+// drivers are registered once per process, the first time any isolate loads
+// the module
+static uv_once_t register_once = UV_ONCE_INIT;
+
+static void registerDrivers()
+{
+	GDALAllRegister();
+	#if GDAL_VERSION_MAJOR < 2
+	OGRRegisterAll();
+	#endif
+}
 
 void GDALDrivers::Initialize(Local<Object> target)
 {
@@ -19,10 +31,7 @@ void GDALDrivers::Initialize(Local<Object> target)
 	Nan::SetPrototypeMethod(lcons, "get", get);
 	Nan::SetPrototypeMethod(lcons, "getNames", getNames);
 
-	GDALAllRegister();
-	#if GDAL_VERSION_MAJOR < 2
-	OGRRegisterAll();
-	#endif
+	uv_once(&register_once, registerDrivers);
 
 	Nan::Set(target, Nan::New("GDALDrivers").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
 	
@@ -0,0 +1,308 @@
+#include "../gdal_common.hpp"
+#include "../gdal_layer.hpp"
+#include "../gdal_feature.hpp"
+#include "../utils/async_worker.hpp"
+#include "layer_feature_cursor.hpp"
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> LayerFeatureCursor::constructor;
+
+/*
+ * Decodes the next batch of features on the threadpool and hands them to
+ * the cursor once back on the main thread.
+ */
+class FeatureBatchWorker : public AsyncWorker {
+public:
+	FeatureBatchWorker(LayerFeatureCursor *cursor, Local<Object> cursor_obj, Layer *layer, int batch_size, const std::vector<std::string> &ignored_fields, bool reset)
+		: AsyncWorker(NULL, "gdal:LayerFeatureCursor"), cursor(cursor), layer(layer->get()),
+		  batch_size(batch_size), ignored_fields(ignored_fields), reset(reset), eof(false), features()
+	{
+		SaveToPersistent("cursor", cursor_obj);
+		useDataset(layer->uid);
+	}
+
+	~FeatureBatchWorker()
+	{
+		for(unsigned int i = 0; i < features.size(); i++) {
+			OGRFeature::DestroyFeature(features[i]);
+		}
+	}
+
+protected:
+	void Run()
+	{
+		std::vector<const char*> ignored;
+		for(unsigned int i = 0; i < ignored_fields.size(); i++) {
+			ignored.push_back(ignored_fields[i].c_str());
+		}
+		ignored.push_back(NULL);
+
+		if(reset) layer->ResetReading();
+		if(ignored_fields.size()) layer->SetIgnoredFields(&ignored[0]);
+
+		while((int)features.size() < batch_size && !stopIfCancelled()) {
+			OGRFeature *feature = layer->GetNextFeature();
+			if(!feature) {
+				if(CPLGetLastErrorType() == CE_Failure) {
+					SetErrorFromCPL("Error reading feature");
+				}
+				eof = true;
+				break;
+			}
+			features.push_back(feature);
+		}
+
+		if(ignored_fields.size()) layer->SetIgnoredFields(NULL);
+	}
+
+	void HandleOKCallback()
+	{
+		Nan::HandleScope scope;
+		cursor->batchReady(features, eof, NULL, async_resource);
+	}
+
+	void HandleErrorCallback()
+	{
+		Nan::HandleScope scope;
+		cursor->batchReady(features, true, ErrorMessage(), async_resource);
+	}
+
+private:
+	LayerFeatureCursor *cursor;
+	OGRLayer *layer;
+	int batch_size;
+	std::vector<std::string> ignored_fields;
+	bool reset;
+	bool eof;
+	std::vector<OGRFeature*> features;
+};
+
+void LayerFeatureCursor::Initialize(Local<Object> target)
+{
+	Nan::HandleScope scope;
+
+	Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(LayerFeatureCursor::New);
+	lcons->InstanceTemplate()->SetInternalFieldCount(1);
+	lcons->SetClassName(Nan::New("LayerFeatureCursor").ToLocalChecked());
+
+	Nan::SetPrototypeMethod(lcons, "toString", toString);
+	Nan::SetPrototypeMethod(lcons, "nextBatch", nextBatch);
+	Nan::SetPrototypeMethod(lcons, "close", close);
+
+	ATTR(lcons, "batchSize", batchSizeGetter, READ_ONLY_SETTER);
+
+	Nan::Set(target, Nan::New("LayerFeatureCursor").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+	constructor.Reset(lcons);
+}
+
+LayerFeatureCursor::LayerFeatureCursor()
+	: Nan::ObjectWrap(), batch_size(0), ignored_fields(), priority(PRIORITY_NORMAL), batch(), error(),
+	  ready(false), prefetching(false), eof(false), closed(false), started(false), pending(NULL)
+{}
+
+LayerFeatureCursor::~LayerFeatureCursor()
+{
+	discard();
+	if(pending) delete pending;
+}
+
+/**
+ * Reads a {{#crossLink "gdal.Layer"}}Layer{{/crossLink}}'s features in batches,
+ * decoding the next batch on a background thread while the current one is
+ * being processed. Created with {{#crossLink "gdal.LayerFeatures/cursor:method"}}layer.features.cursor(){{/crossLink}}.
+ *
+ * The cursor shares the layer's read position, so `layer.features.next()`
+ * shouldn't be used on the same layer while a cursor is open.
+ *
+ * @class gdal.LayerFeatureCursor
+ */
+NAN_METHOD(LayerFeatureCursor::New)
+{
+	Nan::HandleScope scope;
+
+	if (!info.IsConstructCall()) {
+		Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+		return;
+	}
+	if (info[0]->IsExternal()) {
+		Local<External> ext = info[0].As<External>();
+		void* ptr = ext->Value();
+		LayerFeatureCursor *f = static_cast<LayerFeatureCursor *>(ptr);
+		f->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+		return;
+	} else {
+		Nan::ThrowError("Cannot create LayerFeatureCursor directly");
+		return;
+	}
+}
+
+Local<Value> LayerFeatureCursor::New(Local<Object> layer_obj, int batch_size, std::vector<std::string> ignored_fields, JobPriority priority)
+{
+	Nan::EscapableHandleScope scope;
+
+	LayerFeatureCursor *wrapped = new LayerFeatureCursor();
+	wrapped->batch_size = batch_size;
+	wrapped->ignored_fields = ignored_fields;
+	wrapped->priority = priority;
+
+	v8::Local<v8::Value> ext = Nan::New<External>(wrapped);
+	v8::Local<v8::Object> obj = Nan::NewInstance(Nan::GetFunction(Nan::New(LayerFeatureCursor::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
+	Nan::SetPrivate(obj, Nan::New("parent_").ToLocalChecked(), layer_obj);
+
+	// start decoding the first batch right away
+	wrapped->prefetch();
+
+	return scope.Escape(obj);
+}
+
+NAN_METHOD(LayerFeatureCursor::toString)
+{
+	Nan::HandleScope scope;
+	info.GetReturnValue().Set(Nan::New("LayerFeatureCursor").ToLocalChecked());
+}
+
+/**
+ * Fetches the next batch of features. Resolves with `null` once all
+ * features have been read.
+ *
+ * @method nextBatch
+ * @return {Promise} Resolves with an array of {{#crossLink "gdal.Feature"}}Feature{{/crossLink}} objects.
+ */
+NAN_METHOD(LayerFeatureCursor::nextBatch)
+{
+	Nan::HandleScope scope;
+
+	LayerFeatureCursor *cursor = Nan::ObjectWrap::Unwrap<LayerFeatureCursor>(info.This());
+	if (cursor->pending) {
+		Nan::ThrowError("nextBatch() is already pending");
+		return;
+	}
+
+	Nan::Callback *callback;
+	NODE_ARG_CALLBACK(0, "callback", callback);
+
+	if (cursor->ready || cursor->closed || (cursor->eof && !cursor->prefetching)) {
+		cursor->deliver(callback, NULL);
+		return;
+	}
+
+	cursor->pending = callback;
+	if (!cursor->prefetching) {
+		cursor->prefetch();
+	}
+}
+
+/**
+ * Stops reading and frees any prefetched features.
+ *
+ * @method close
+ */
+NAN_METHOD(LayerFeatureCursor::close)
+{
+	Nan::HandleScope scope;
+
+	LayerFeatureCursor *cursor = Nan::ObjectWrap::Unwrap<LayerFeatureCursor>(info.This());
+	cursor->closed = true;
+	cursor->discard();
+
+	if (cursor->pending) {
+		Nan::Callback *callback = cursor->pending;
+		cursor->pending = NULL;
+		cursor->deliver(callback, NULL);
+	}
+}
+
+/**
+ * @readOnly
+ * @attribute batchSize
+ * @type {Integer}
+ */
+NAN_GETTER(LayerFeatureCursor::batchSizeGetter)
+{
+	Nan::HandleScope scope;
+	LayerFeatureCursor *cursor = Nan::ObjectWrap::Unwrap<LayerFeatureCursor>(info.This());
+	info.GetReturnValue().Set(Nan::New<Integer>(cursor->batch_size));
+}
+
+void LayerFeatureCursor::prefetch()
+{
+	Local<Object> obj = handle();
+	Local<Object> parent = Nan::GetPrivate(obj, Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	Layer *layer = Nan::ObjectWrap::Unwrap<Layer>(parent);
+	if (!layer->isAlive()) {
+		error = "Layer object already destroyed";
+		eof = true;
+		ready = true;
+		return;
+	}
+
+	prefetching = true;
+	FeatureBatchWorker *worker = new FeatureBatchWorker(this, obj, layer, batch_size, ignored_fields, !started);
+	worker->setPriority(priority);
+	job_pool.queue(worker);
+	started = true;
+}
+
+void LayerFeatureCursor::batchReady(std::vector<OGRFeature*> &features, bool eof, const char *error, Nan::AsyncResource *resource)
+{
+	prefetching = false;
+	if (closed) return; // the worker frees the features
+
+	batch.swap(features);
+	this->eof = eof;
+	if (error) this->error = error;
+	ready = true;
+
+	if (pending) {
+		Nan::Callback *callback = pending;
+		pending = NULL;
+		deliver(callback, resource);
+	}
+}
+
+// Passes the current batch (or error / null at the end) to the callback and
+// starts decoding the next one.
+void LayerFeatureCursor::deliver(Nan::Callback *callback, Nan::AsyncResource *resource)
+{
+	Nan::HandleScope scope;
+
+	Local<Value> argv[2] = { Nan::Null(), Nan::Null() };
+
+	if (!error.empty()) {
+		argv[0] = Nan::Error(error.c_str());
+		error.clear();
+	} else if (!closed && !batch.empty()) {
+		Local<Array> features = Nan::New<Array>(batch.size());
+		for (unsigned int i = 0; i < batch.size(); i++) {
+			Nan::Set(features, i, Feature::New(batch[i]));
+		}
+		batch.clear();
+		argv[1] = features;
+	}
+	ready = false;
+
+	if (!eof && !closed && !prefetching) {
+		prefetch();
+	}
+
+	if (resource) {
+		callback->Call(2, argv, resource);
+	} else {
+		Nan::Call(*callback, 2, argv);
+	}
+	delete callback;
+}
+
+void LayerFeatureCursor::discard()
+{
+	for (unsigned int i = 0; i < batch.size(); i++) {
+		OGRFeature::DestroyFeature(batch[i]);
+	}
+	batch.clear();
+	ready = false;
+}
+
+}
@@ -0,0 +1,69 @@
+#ifndef __NODE_GDAL_FEATURE_CURSOR_H__
+#define __NODE_GDAL_FEATURE_CURSOR_H__
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+// ogr
+#include <ogrsf_frmts.h>
+
+#include "../utils/job_pool.hpp"
+
+#include <string>
+#include <vector>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Reads a layer's features in batches on the threadpool. While JS consumes
+// one batch, the next one is decoded in the background.
+
+class LayerFeatureCursor: public Nan::ObjectWrap {
+public:
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
+
+	static void Initialize(Local<Object> target);
+	static NAN_METHOD(New);
+	static Local<Value> New(Local<Object> layer_obj, int batch_size, std::vector<std::string> ignored_fields, JobPriority priority);
+	static NAN_METHOD(toString);
+	static NAN_METHOD(nextBatch);
+	static NAN_METHOD(close);
+
+	static NAN_GETTER(batchSizeGetter);
+
+	void batchReady(std::vector<OGRFeature*> &features, bool eof, const char *error, Nan::AsyncResource *resource);
+
+	LayerFeatureCursor();
+private:
+	~LayerFeatureCursor();
+	void prefetch();
+	void deliver(Nan::Callback *callback, Nan::AsyncResource *resource);
+	void discard();
+
+	int batch_size;
+	std::vector<std::string> ignored_fields;
+	JobPriority priority;
+	std::vector<OGRFeature*> batch;
+	std::string error;
+	bool ready;
+	bool prefetching;
+	bool eof;
+	bool closed;
+	bool started;
+	Nan::Callback *pending;
+};
+
+}
+#endif
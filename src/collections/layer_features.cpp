@@ -2,10 +2,14 @@
 #include "../gdal_layer.hpp"
 #include "../gdal_feature.hpp"
 #include "layer_features.hpp"
+#include "layer_feature_cursor.hpp"
+
+#include <string>
+#include <vector>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LayerFeatures::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LayerFeatures::constructor;
 
 void LayerFeatures::Initialize(Local<Object> target)
 {
@@ -23,6 +27,7 @@ void LayerFeatures::Initialize(Local<Object> target)
 	Nan::SetPrototypeMethod(lcons, "first", first);
 	Nan::SetPrototypeMethod(lcons, "next", next);
 	Nan::SetPrototypeMethod(lcons, "remove", remove);
+	Nan::SetPrototypeMethod(lcons, "cursor", cursor);
 
 	ATTR_DONT_ENUM(lcons, "layer", layerGetter, READ_ONLY_SETTER);
 
@@ -106,6 +111,8 @@ NAN_METHOD(LayerFeatures::get)
 
 	int feature_id;
 	NODE_ARG_INT(0, "feature id", feature_id);
+
+	DatasetLock lock(layer->uid);
 	OGRFeature *feature = layer->get()->GetFeature(feature_id);
 
 	info.GetReturnValue().Set(Feature::New(feature));
@@ -129,6 +136,7 @@ NAN_METHOD(LayerFeatures::first)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	layer->get()->ResetReading();
 	OGRFeature *feature = layer->get()->GetNextFeature();
 
@@ -156,11 +164,98 @@ NAN_METHOD(LayerFeatures::next)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeature *feature = layer->get()->GetNextFeature();
 
 	info.GetReturnValue().Set(Feature::New(feature));
 }
 
+/**
+ * Creates a cursor that reads features in batches, decoding the next batch
+ * on a background thread while the current one is processed. Reading
+ * restarts from the first feature.
+ *
+ * @example
+ * ```
+ * var cursor = layer.features.cursor({batchSize: 500, fields: ['name']});
+ * cursor.nextBatch().then(function(features) { ... });```
+ *
+ * @method cursor
+ * @throws Error
+ * @param {Object} [options]
+ * @param {Integer} [options.batchSize=1000] Number of features per batch.
+ * @param {String[]} [options.fields] Only read these fields. All fields are read if not given.
+ * @param {Boolean} [options.ignoreGeometry=false] Skip reading geometries.
+ * @param {String} [options.priority="normal"] Scheduling priority of the batch reads: `"interactive"`, `"normal"` or `"background"`.
+ * @return {gdal.LayerFeatureCursor}
+ */
+NAN_METHOD(LayerFeatures::cursor)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	Layer *layer = Nan::ObjectWrap::Unwrap<Layer>(parent);
+	if (!layer->isAlive()) {
+		Nan::ThrowError("Layer object already destroyed");
+		return;
+	}
+
+	int batch_size = 1000;
+	std::vector<std::string> ignored_fields;
+	std::string priority_name = "normal";
+	JobPriority priority;
+
+	if (info.Length() > 0 && !info[0]->IsUndefined() && !info[0]->IsNull()) {
+		Local<Object> obj;
+		Local<Value> prop;
+		NODE_ARG_OBJECT(0, "options", obj);
+		NODE_INT_FROM_OBJ_OPT(obj, "batchSize", batch_size);
+
+		if (batch_size < 1) {
+			Nan::ThrowRangeError("batchSize must be greater than 0");
+			return;
+		}
+
+		prop = Nan::Get(obj, Nan::New("fields").ToLocalChecked()).ToLocalChecked();
+		if (prop->IsArray()) {
+			Local<Array> fields = prop.As<Array>();
+			DatasetLock lock(layer->uid);
+			OGRFeatureDefn *def = layer->get()->GetLayerDefn();
+			std::vector<bool> keep(def->GetFieldCount(), false);
+
+			for (unsigned int i = 0; i < fields->Length(); i++) {
+				std::string name = *Nan::Utf8String(Nan::Get(fields, i).ToLocalChecked());
+				int field_index = def->GetFieldIndex(name.c_str());
+				if (field_index < 0) {
+					Nan::ThrowError(("Specified field name does not exist: " + name).c_str());
+					return;
+				}
+				keep[field_index] = true;
+			}
+			for (int i = 0; i < def->GetFieldCount(); i++) {
+				if (!keep[i]) ignored_fields.push_back(def->GetFieldDefn(i)->GetNameRef());
+			}
+		} else if (!prop->IsUndefined() && !prop->IsNull()) {
+			Nan::ThrowTypeError("fields property must be an array of field names");
+			return;
+		}
+
+		prop = Nan::Get(obj, Nan::New("ignoreGeometry").ToLocalChecked()).ToLocalChecked();
+		if (Nan::To<bool>(prop).FromMaybe(false)) {
+			ignored_fields.push_back("OGR_GEOMETRY");
+		}
+
+		NODE_STR_FROM_OBJ_OPT(obj, "priority", priority_name);
+	}
+
+	if (!JobPool::parsePriority(priority_name, priority)) {
+		Nan::ThrowError("priority must be \"interactive\", \"normal\" or \"background\"");
+		return;
+	}
+
+	info.GetReturnValue().Set(LayerFeatureCursor::New(parent, batch_size, ignored_fields, priority));
+}
+
 /**
  * Adds a feature to the layer. The feature should be created using the current layer as the definition.
  *
@@ -189,6 +284,7 @@ NAN_METHOD(LayerFeatures::add)
 	Feature *f;
 	NODE_ARG_WRAPPED(0, "feature", Feature, f)
 
+	DatasetLock lock(layer->uid);
 	int err = layer->get()->CreateFeature(f->get());
 	if(err) {
 		NODE_THROW_OGRERR(err);
@@ -218,6 +314,7 @@ NAN_METHOD(LayerFeatures::count)
 	int force = 1;
 	NODE_ARG_BOOL_OPT(0, "force", force);
 
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(Nan::New<Number>(layer->get()->GetFeatureCount(force)));
 }
 
@@ -264,6 +361,7 @@ NAN_METHOD(LayerFeatures::set)
 		Nan::ThrowError("Feature already destroyed");
 		return;
 	}
+	DatasetLock lock(layer->uid);
 	err = layer->get()->SetFeature(f->get());
 	if(err) {
 		NODE_THROW_OGRERR(err);
@@ -292,6 +390,8 @@ NAN_METHOD(LayerFeatures::remove)
 
 	int i;
 	NODE_ARG_INT(0, "feature id", i);
+
+	DatasetLock lock(layer->uid);
 	int err = layer->get()->DeleteFeature(i);
 	if(err) {
 		NODE_THROW_OGRERR(err);
@@ -21,7 +21,7 @@ namespace node_gdal {
 
 class LayerFeatures: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
@@ -35,6 +35,7 @@ public:
 	static NAN_METHOD(add);
 	static NAN_METHOD(set);
 	static NAN_METHOD(remove);
+	static NAN_METHOD(cursor);
 
 	static NAN_GETTER(layerGetter);
 
@@ -5,7 +5,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LayerFields::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LayerFields::constructor;
 
 void LayerFields::Initialize(Local<Object> target)
 {
@@ -99,6 +99,7 @@ NAN_METHOD(LayerFields::count)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		Nan::ThrowError("Layer has no layer definition set");
@@ -126,6 +127,7 @@ NAN_METHOD(LayerFields::indexOf)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		Nan::ThrowError("Layer has no layer definition set");
@@ -162,6 +164,7 @@ NAN_METHOD(LayerFields::get)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		Nan::ThrowError("Layer has no layer definition set");
@@ -192,6 +195,7 @@ NAN_METHOD(LayerFields::getNames)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		Nan::ThrowError("Layer has no layer definition set");
@@ -232,6 +236,7 @@ NAN_METHOD(LayerFields::remove)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		Nan::ThrowError("Layer has no layer definition set");
@@ -278,6 +283,8 @@ NAN_METHOD(LayerFields::add)
 	int approx = 1;
 	NODE_ARG_BOOL_OPT(1, "approx", approx);
 
+	DatasetLock lock(layer->uid);
+
 	if (info[0]->IsArray()) {
 		Local<Array> array = info[0].As<Array>();
 		int n = array->Length();
@@ -333,6 +340,7 @@ NAN_METHOD(LayerFields::reorder)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	OGRFeatureDefn *def = layer->get()->GetLayerDefn();
 	if (!def) {
 		Nan::ThrowError("Layer has no layer definition set");
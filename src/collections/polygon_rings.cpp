@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> PolygonRings::constructor;
+thread_local Nan::Persistent<FunctionTemplate> PolygonRings::constructor;
 
 void PolygonRings::Initialize(Local<Object> target)
 {
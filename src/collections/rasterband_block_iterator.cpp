@@ -0,0 +1,222 @@
+#include "../gdal_common.hpp"
+#include "../gdal_rasterband.hpp"
+#include "rasterband_block_iterator.hpp"
+#include "../utils/typed_array.hpp"
+
+#include <algorithm>
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> RasterBandBlockIterator::constructor;
+
+void RasterBandBlockIterator::Initialize(Local<Object> target)
+{
+	Nan::HandleScope scope;
+
+	Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(RasterBandBlockIterator::New);
+	lcons->InstanceTemplate()->SetInternalFieldCount(1);
+	lcons->SetClassName(Nan::New("RasterBandBlockIterator").ToLocalChecked());
+
+	Nan::SetPrototypeMethod(lcons, "toString", toString);
+	Nan::SetPrototypeMethod(lcons, "next", next);
+
+	ATTR(lcons, "order", orderGetter, READ_ONLY_SETTER);
+
+	Nan::Set(target, Nan::New("RasterBandBlockIterator").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+	constructor.Reset(lcons);
+}
+
+RasterBandBlockIterator::RasterBandBlockIterator()
+	: Nan::ObjectWrap(), x(0), y(0), w(0), h(0), block_w(0), block_h(0),
+	  block_x(0), block_y(0), rows(false), reuse(false), done(false)
+{}
+
+RasterBandBlockIterator::~RasterBandBlockIterator()
+{}
+
+/**
+ * Iterates over a window of a {{#crossLink "gdal.RasterBand"}}RasterBand{{/crossLink}}
+ * in the order its blocks are stored, so each block is read from disk once.
+ * Created with {{#crossLink "gdal.RasterBandPixels/blocks:method"}}band.pixels.blocks(){{/crossLink}}.
+ *
+ * Follows the ES6 iterator protocol: `next()` returns `{value, done}`, where
+ * `value` is an object with `x`, `y`, `width`, `height` and `data` properties.
+ *
+ * @class gdal.RasterBandBlockIterator
+ */
+NAN_METHOD(RasterBandBlockIterator::New)
+{
+	Nan::HandleScope scope;
+
+	if (!info.IsConstructCall()) {
+		Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+		return;
+	}
+	if (info[0]->IsExternal()) {
+		Local<External> ext = info[0].As<External>();
+		void* ptr = ext->Value();
+		RasterBandBlockIterator *f = static_cast<RasterBandBlockIterator *>(ptr);
+		f->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+		return;
+	} else {
+		Nan::ThrowError("Cannot create RasterBandBlockIterator directly");
+		return;
+	}
+}
+
+Local<Value> RasterBandBlockIterator::New(Local<Value> band_obj, int x, int y, int w, int h, bool rows, bool reuse)
+{
+	Nan::EscapableHandleScope scope;
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(band_obj.As<Object>());
+
+	RasterBandBlockIterator *wrapped = new RasterBandBlockIterator();
+	wrapped->x = x;
+	wrapped->y = y;
+	wrapped->w = w;
+	wrapped->h = h;
+	wrapped->rows = rows;
+	wrapped->reuse = reuse;
+	band->get()->GetBlockSize(&wrapped->block_w, &wrapped->block_h);
+	wrapped->block_x = x / wrapped->block_w;
+	wrapped->block_y = y / wrapped->block_h;
+	wrapped->done = w <= 0 || h <= 0;
+
+	v8::Local<v8::Value> ext = Nan::New<External>(wrapped);
+	v8::Local<v8::Object> obj = Nan::NewInstance(Nan::GetFunction(Nan::New(RasterBandBlockIterator::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
+	Nan::SetPrivate(obj, Nan::New("parent_").ToLocalChecked(), band_obj);
+
+	return scope.Escape(obj);
+}
+
+NAN_METHOD(RasterBandBlockIterator::toString)
+{
+	Nan::HandleScope scope;
+	info.GetReturnValue().Set(Nan::New("RasterBandBlockIterator").ToLocalChecked());
+}
+
+/**
+ * Reads the next block. Blocks on the edge of the window (or raster) are
+ * clipped, so `data` always holds exactly `width * height` values.
+ *
+ * @throws Error
+ * @method next
+ * @return {Object} `{value: {x, y, width, height, data}, done: false}`, or `{value: undefined, done: true}` once all blocks have been read.
+ */
+NAN_METHOD(RasterBandBlockIterator::next)
+{
+	Nan::HandleScope scope;
+
+	RasterBandBlockIterator *iter = Nan::ObjectWrap::Unwrap<RasterBandBlockIterator>(info.This());
+
+	Local<Object> result = Nan::New<Object>();
+	if (iter->done) {
+		Nan::Set(result, Nan::New("value").ToLocalChecked(), Nan::Undefined());
+		Nan::Set(result, Nan::New("done").ToLocalChecked(), Nan::True());
+		info.GetReturnValue().Set(result);
+		return;
+	}
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	// clip the block to the window
+	int x0 = iter->rows ? iter->x : std::max(iter->block_x * iter->block_w, iter->x);
+	int x1 = iter->rows ? iter->x + iter->w : std::min((iter->block_x + 1) * iter->block_w, iter->x + iter->w);
+	int y0 = std::max(iter->block_y * iter->block_h, iter->y);
+	int y1 = std::min((iter->block_y + 1) * iter->block_h, iter->y + iter->h);
+	int w = x1 - x0;
+	int h = y1 - y0;
+
+	GDALDataType type = band->get()->GetRasterDataType();
+	Local<Value> array;
+	bool partial = false;
+
+	if (iter->reuse) {
+		array = Nan::GetPrivate(info.This(), Nan::New("buffer_").ToLocalChecked()).ToLocalChecked();
+		int max_w = iter->rows ? iter->w : std::min(iter->block_w, iter->w);
+		int max_h = std::min(iter->block_h, iter->h);
+		if (!array->IsObject()) {
+			array = TypedArray::New(type, max_w * max_h);
+			if (array.IsEmpty() || !array->IsObject()) {
+				return; //TypedArray::New threw an error
+			}
+			Nan::SetPrivate(info.This(), Nan::New("buffer_").ToLocalChecked(), array);
+		}
+		partial = w * h < max_w * max_h;
+	} else {
+		array = TypedArray::New(type, w * h);
+		if (array.IsEmpty() || !array->IsObject()) {
+			return; //TypedArray::New threw an error
+		}
+	}
+
+	void *data = TypedArray::Validate(array.As<Object>(), type, w * h);
+	if (!data) {
+		return; //TypedArray::Validate threw an error
+	}
+
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		err = band->get()->RasterIO(GF_Read, x0, y0, w, h, data, w, h, type, 0, 0, NULL);
+	}
+	if (err) {
+		iter->done = true;
+		NODE_THROW_CPLERR(err);
+		return;
+	}
+
+	if (partial) {
+		// a view on the start of the shared buffer, no copy is made
+		Local<Object> buffer = array.As<Object>();
+		Local<Value> subarray = Nan::Get(buffer, Nan::New("subarray").ToLocalChecked()).ToLocalChecked();
+		Local<Value> argv[2] = { Nan::New<Integer>(0), Nan::New<Integer>(w * h) };
+		if (!Nan::Call(subarray.As<Function>(), buffer, 2, argv).ToLocal(&array)) {
+			return;
+		}
+		Nan::Set(array.As<Object>(), Nan::New("_gdal_type").ToLocalChecked(), Nan::New(type));
+	}
+
+	// advance in the order blocks are stored: left to right, then top to bottom
+	if (!iter->rows && x1 < iter->x + iter->w) {
+		iter->block_x++;
+	} else {
+		iter->block_x = iter->x / iter->block_w;
+		iter->block_y++;
+		iter->done = y1 >= iter->y + iter->h;
+	}
+
+	Local<Object> value = Nan::New<Object>();
+	Nan::Set(value, Nan::New("x").ToLocalChecked(), Nan::New<Integer>(x0));
+	Nan::Set(value, Nan::New("y").ToLocalChecked(), Nan::New<Integer>(y0));
+	Nan::Set(value, Nan::New("width").ToLocalChecked(), Nan::New<Integer>(w));
+	Nan::Set(value, Nan::New("height").ToLocalChecked(), Nan::New<Integer>(h));
+	Nan::Set(value, Nan::New("data").ToLocalChecked(), array);
+
+	Nan::Set(result, Nan::New("value").ToLocalChecked(), value);
+	Nan::Set(result, Nan::New("done").ToLocalChecked(), Nan::False());
+	info.GetReturnValue().Set(result);
+}
+
+/**
+ * `"tile"` or `"row"`.
+ *
+ * @readOnly
+ * @attribute order
+ * @type {String}
+ */
+NAN_GETTER(RasterBandBlockIterator::orderGetter)
+{
+	Nan::HandleScope scope;
+	RasterBandBlockIterator *iter = Nan::ObjectWrap::Unwrap<RasterBandBlockIterator>(info.This());
+	info.GetReturnValue().Set(Nan::New(iter->rows ? "row" : "tile").ToLocalChecked());
+}
+
+}
@@ -0,0 +1,58 @@
+#ifndef __NODE_GDAL_BAND_BLOCK_ITERATOR_H__
+#define __NODE_GDAL_BAND_BLOCK_ITERATOR_H__
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Walks a window of a band in block order, reading each block (clipped to
+// the window) with a single RasterIO call.
+
+class RasterBandBlockIterator: public Nan::ObjectWrap {
+public:
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
+
+	static void Initialize(Local<Object> target);
+	static NAN_METHOD(New);
+	static Local<Value> New(Local<Value> band_obj, int x, int y, int w, int h, bool rows, bool reuse);
+	static NAN_METHOD(toString);
+	static NAN_METHOD(next);
+
+	static NAN_GETTER(orderGetter);
+
+	RasterBandBlockIterator();
+private:
+	~RasterBandBlockIterator();
+
+	// window
+	int x;
+	int y;
+	int w;
+	int h;
+	// block size
+	int block_w;
+	int block_h;
+	// next block to read
+	int block_x;
+	int block_y;
+	bool rows;
+	bool reuse;
+	bool done;
+};
+
+}
+#endif
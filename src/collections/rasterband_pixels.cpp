@@ -1,13 +1,131 @@
 #include "../gdal_common.hpp"
 #include "../gdal_rasterband.hpp"
 #include "rasterband_pixels.hpp"
+#include "rasterband_block_iterator.hpp"
+#include "rasterband_sampler.hpp"
 #include "../utils/typed_array.hpp"
+#include "../utils/async_worker.hpp"
+#include "../utils/raster_io_args.hpp"
 
 #include <sstream>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBandPixels::constructor;
+thread_local Nan::Persistent<FunctionTemplate> RasterBandPixels::constructor;
+
+/*
+ * Performs a pixel read / write on the libuv threadpool. The band object and
+ * the typed array are kept alive in persistent handles until the callback
+ * fires.
+ */
+class RasterBandPixelsWorker : public AsyncWorker {
+public:
+	enum Operation { READ, WRITE, READ_BLOCK, WRITE_BLOCK };
+
+	RasterBandPixelsWorker(Nan::Callback *callback, Operation op, RasterBand *band, Local<Object> band_obj, Local<Object> array, void *data)
+		: AsyncWorker(callback, "gdal:RasterBandPixels"), op(op), raw(band->get()), data(data),
+		  x(0), y(0), w(0), h(0), buffer_w(0), buffer_h(0), type(GDT_Unknown), pixel_space(0), line_space(0),
+		  use_overviews(false), overview(-1)
+	{
+		SaveToPersistent("band", band_obj);
+		SaveToPersistent("array", array);
+		useDataset(band->uid);
+		INIT_RASTERIO_EXTRA_ARG(extra);
+	}
+
+	void setWindow(int x, int y, int w, int h, int buffer_w, int buffer_h, GDALDataType type, int pixel_space, int line_space)
+	{
+		this->x = x;
+		this->y = y;
+		this->w = w;
+		this->h = h;
+		this->buffer_w = buffer_w;
+		this->buffer_h = buffer_h;
+		this->type = type;
+		this->pixel_space = pixel_space;
+		this->line_space = line_space;
+	}
+
+	void setExtraArg(const GDALRasterIOExtraArg *extra)
+	{
+		this->extra = *extra;
+	}
+
+	void setUseOverviews(bool use_overviews, Local<Object> stats)
+	{
+		this->use_overviews = use_overviews;
+		if(!stats.IsEmpty()) {
+			SaveToPersistent("stats", stats);
+		}
+	}
+
+	void setBlock(int x, int y)
+	{
+		this->x = x;
+		this->y = y;
+	}
+
+protected:
+	void Run()
+	{
+		CPLErr err = CE_None;
+		GDALRasterBand *src = raw;
+
+		switch(op) {
+			case READ:
+				if(use_overviews) {
+					overview = GDALBandGetBestOverviewLevel2(raw, x, y, w, h, buffer_w, buffer_h, &extra);
+					if(overview >= 0) src = raw->GetOverview(overview);
+				}
+				err = src->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, &extra);
+				break;
+			case WRITE:
+				err = raw->RasterIO(GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+				break;
+			case READ_BLOCK:
+				err = raw->ReadBlock(x, y, data);
+				break;
+			case WRITE_BLOCK:
+				err = raw->WriteBlock(x, y, data);
+				break;
+		}
+		if(err) {
+			SetErrorFromCPL("Error performing raster I/O");
+		}
+	}
+
+	Local<Value> Result()
+	{
+		Local<Value> stats = GetFromPersistent("stats");
+		if(op == READ && stats->IsObject()) {
+			RasterIOArgs::setStats(stats.As<Object>(), overview, w, h, 1, raw->GetRasterDataType());
+		}
+		if(op == READ || op == READ_BLOCK) {
+			return GetFromPersistent("array");
+		}
+		return Nan::Undefined();
+	}
+
+private:
+	Operation op;
+	GDALRasterBand *raw;
+	void *data;
+	int x, y, w, h;
+	int buffer_w, buffer_h;
+	GDALDataType type;
+	int pixel_space, line_space;
+	GDALRasterIOExtraArg extra;
+	bool use_overviews;
+	int overview;
+};
+
+// Called when the array of a block pinned with lockBlock() is collected
+static void onLockedBlockCollected(char *data, void *hint)
+{
+	long *uid = static_cast<long*>(hint);
+	ptr_manager.releaseBlock(*uid, false);
+	delete uid;
+}
 
 void RasterBandPixels::Initialize(Local<Object> target)
 {
@@ -24,6 +142,14 @@ void RasterBandPixels::Initialize(Local<Object> target)
 	Nan::SetPrototypeMethod(lcons, "write", write);
 	Nan::SetPrototypeMethod(lcons, "readBlock", readBlock);
 	Nan::SetPrototypeMethod(lcons, "writeBlock", writeBlock);
+	Nan::SetPrototypeMethod(lcons, "readAsync", readAsync);
+	Nan::SetPrototypeMethod(lcons, "writeAsync", writeAsync);
+	Nan::SetPrototypeMethod(lcons, "readBlockAsync", readBlockAsync);
+	Nan::SetPrototypeMethod(lcons, "writeBlockAsync", writeBlockAsync);
+	Nan::SetPrototypeMethod(lcons, "lockBlock", lockBlock);
+	Nan::SetPrototypeMethod(lcons, "releaseBlock", releaseBlock);
+	Nan::SetPrototypeMethod(lcons, "blocks", blocks);
+	Nan::SetPrototypeMethod(lcons, "sampler", sampler);
 
 	Nan::Set(target, Nan::New("RasterBandPixels").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
 
@@ -115,6 +241,7 @@ NAN_METHOD(RasterBandPixels::get)
 	NODE_ARG_INT(0, "x", x);
 	NODE_ARG_INT(1, "y", y);
 
+	DatasetLock lock(band->uid);
 	CPLErr err = band->get()->RasterIO(GF_Read, x, y, 1, 1, &val, 1, 1, GDT_Float64, 0, 0);
 	if(err) {
 		NODE_THROW_CPLERR(err);
@@ -150,6 +277,7 @@ NAN_METHOD(RasterBandPixels::set)
 	NODE_ARG_INT(1, "y", y);
 	NODE_ARG_DOUBLE(2, "val", val);
 
+	DatasetLock lock(band->uid);
 	CPLErr err = band->get()->RasterIO(GF_Write, x, y, 1, 1, &val, 1, 1, GDT_Float64, 0, 0);
 	if(err) {
 		NODE_THROW_CPLERR(err);
@@ -162,12 +290,20 @@ NAN_METHOD(RasterBandPixels::set)
 /**
  * Reads a region of pixels.
  *
+ * The window may have fractional coordinates, in which case the pixels are
+ * resampled from the exact window:
+ * ```
+ * // 64x64 thumbnail of a 1000x1000 band
+ * var thumb = band.pixels.read(0, 0, 1000, 1000, null, {buffer_width: 64, buffer_height: 64, resampling: 'average'});
+ * // 256x256 tile from a window not aligned to the pixel grid
+ * var tile = band.pixels.read(10.5, 20.25, 300.5, 300.5, null, {buffer_width: 256, buffer_height: 256, resampling: 'bilinear'});```
+ *
  * @method read
  * @throws Error
- * @param {Integer} x
- * @param {Integer} y
- * @param {Integer} width
- * @param {Integer} height
+ * @param {Number} x
+ * @param {Number} y
+ * @param {Number} width
+ * @param {Number} height
  * @param {TypedArray} [data] The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
  * @param {Object} [options]
  * @param {Integer} [options.buffer_width=x_size]
@@ -175,9 +311,37 @@ NAN_METHOD(RasterBandPixels::set)
  * @param {String} [options.data_type] See {{#crossLink "Constants (GDT)"}}GDT constants{{/crossLink}}.
  * @param {Integer} [options.pixel_space]
  * @param {Integer} [options.line_space]
+ * @param {String} [options.resampling="nearest"] Resampling used when the buffer size differs from the window size: `"nearest"`, `"bilinear"`, `"cubic"`, `"cubicspline"`, `"lanczos"`, `"average"`, `"mode"` or `"gauss"`.
+ * @param {Boolean} [options.useOverviews=false] Read from the overview best matching the buffer size, with the window rescaled to it. Some drivers otherwise decode the full resolution window.
+ * @param {Object} [options.stats] An object to fill with the `overview` level read from (`-1` for full resolution) and the estimated `bytesDecoded` of the source window.
+ * @param {Boolean} [options.shared=false] Allocate the array on a `SharedArrayBuffer`, so it can be shared with worker threads without copying. Ignored if `data` is given.
  * @return {TypedArray} A [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
  */
 NAN_METHOD(RasterBandPixels::read)
+{
+	readImpl(info, false);
+}
+
+/**
+ * Reads a region of pixels on a background thread. Takes the same
+ * arguments as {{#crossLink "gdal.RasterBandPixels/read:method"}}read(){{/crossLink}}.
+ *
+ * @method readAsync
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {Integer} width
+ * @param {Integer} height
+ * @param {TypedArray} [data] The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {Object} [options]
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
+ */
+NAN_METHOD(RasterBandPixels::readAsync)
+{
+	readImpl(info, true);
+}
+
+void RasterBandPixels::readImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -193,16 +357,25 @@ NAN_METHOD(RasterBandPixels::read)
 	int bytes_per_pixel;
 	int pixel_space, line_space;
 	int size, length, min_size, min_length;
+	bool shared = false;
 	void *data;
 	Local<Value>  array;
 	Local<Object> obj;
 	GDALDataType type;
+	RasterIOArgs args;
+	bool use_overviews = false;
+	Local<Object> stats;
 
-
-	NODE_ARG_INT(0, "x_offset", x);
-	NODE_ARG_INT(1, "y_offset", y);
-	NODE_ARG_INT(2, "x_size", w);
-	NODE_ARG_INT(3, "y_size", h);
+	if(args.parseWindow(info[0], info[1], info[2], info[3])) {
+		return; // error parsing window
+	}
+	if(args.parseResampling(info[11])) {
+		return; // error parsing resampling
+	}
+	x = args.x();
+	y = args.y();
+	w = args.width();
+	h = args.height();
 
 	std::string type_name = "";
 
@@ -230,6 +403,11 @@ NAN_METHOD(RasterBandPixels::read)
 	NODE_ARG_INT_OPT(8, "pixel_space", pixel_space);
 	line_space = pixel_space * buffer_w;
 	NODE_ARG_INT_OPT(9, "line_space", line_space);
+	NODE_ARG_BOOL_OPT(10, "shared", shared);
+	NODE_ARG_BOOL_OPT(12, "useOverviews", use_overviews);
+	if(info.Length() > 13 && !info[13]->IsUndefined() && !info[13]->IsNull()) {
+		NODE_ARG_OBJECT(13, "stats", stats);
+	}
 
 	if(pixel_space < bytes_per_pixel) {
 		Nan::ThrowError("pixel_space must be greater than or equal to size of data_type");
@@ -247,7 +425,7 @@ NAN_METHOD(RasterBandPixels::read)
 
 	//create array if no array was passed
 	if(obj.IsEmpty()){
-		array = TypedArray::New(type, length);
+		array = TypedArray::New(type, length, shared);
 		if(array.IsEmpty() || !array->IsObject()) {
 			return; //TypedArray::New threw an error
 		}
@@ -259,12 +437,39 @@ NAN_METHOD(RasterBandPixels::read)
 		return; //TypedArray::Validate threw an error
 	}
 
-	CPLErr err = band->get()->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(14, "callback", callback);
+
+		RasterBandPixelsWorker *worker = new RasterBandPixelsWorker(callback, RasterBandPixelsWorker::READ, band, parent, obj, data);
+		worker->setWindow(x, y, w, h, buffer_w, buffer_h, type, pixel_space, line_space);
+		worker->setExtraArg(args.get());
+		worker->setUseOverviews(use_overviews, stats);
+		job_pool.queue(worker);
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	GDALRasterBand *src = band->get();
+	int overview = -1;
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		if(use_overviews) {
+			overview = GDALBandGetBestOverviewLevel2(band->get(), x, y, w, h, buffer_w, buffer_h, args.get());
+			if(overview >= 0) src = band->get()->GetOverview(overview);
+		}
+		err = src->RasterIO(GF_Read, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space, args.get());
+	}
 	if(err) {
 		NODE_THROW_CPLERR(err);
 		return;
 	}
 
+	if(!stats.IsEmpty()) {
+		RasterIOArgs::setStats(stats, overview, w, h, 1, band->get()->GetRasterDataType());
+	}
+
 	info.GetReturnValue().Set(obj);
 }
 
@@ -285,6 +490,31 @@ NAN_METHOD(RasterBandPixels::read)
  * @param {Integer} [options.line_space]
  */
 NAN_METHOD(RasterBandPixels::write)
+{
+	writeImpl(info, false);
+}
+
+/**
+ * Writes a region of pixels on a background thread. Takes the same
+ * arguments as {{#crossLink "gdal.RasterBandPixels/write:method"}}write(){{/crossLink}}.
+ * The array must not be modified until the returned promise settles.
+ *
+ * @method writeAsync
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {Integer} width
+ * @param {Integer} height
+ * @param {TypedArray} data The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to write to the band.
+ * @param {Object} [options]
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(RasterBandPixels::writeAsync)
+{
+	writeImpl(info, true);
+}
+
+void RasterBandPixels::writeImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -345,6 +575,18 @@ NAN_METHOD(RasterBandPixels::write)
 		return; //TypedArray::Validate threw an error
 	}
 
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(9, "callback", callback);
+
+		RasterBandPixelsWorker *worker = new RasterBandPixelsWorker(callback, RasterBandPixelsWorker::WRITE, band, parent, passed_array, data);
+		worker->setWindow(x, y, w, h, buffer_w, buffer_h, type, pixel_space, line_space);
+		job_pool.queue(worker);
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	DatasetLock lock(band->uid);
 	CPLErr err = band->get()->RasterIO(GF_Write, x, y, w, h, data, buffer_w, buffer_h, type, pixel_space, line_space);
 	if(err) {
 		NODE_THROW_CPLERR(err);
@@ -362,9 +604,32 @@ NAN_METHOD(RasterBandPixels::write)
  * @param {Integer} x
  * @param {Integer} y
  * @param {TypedArray} [data] The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {Object} [options]
+ * @param {Boolean} [options.shared=false] Allocate the array on a `SharedArrayBuffer`. Ignored if `data` is given.
  * @return {TypedArray} A [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
  */
 NAN_METHOD(RasterBandPixels::readBlock)
+{
+	readBlockImpl(info, false);
+}
+
+/**
+ * Reads a block of pixels on a background thread.
+ *
+ * @method readBlockAsync
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {TypedArray} [data] The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) to put the data in. A new array is created if not given.
+ * @param {Object} [options]
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values.
+ */
+NAN_METHOD(RasterBandPixels::readBlockAsync)
+{
+	readBlockImpl(info, true);
+}
+
+void RasterBandPixels::readBlockImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -385,12 +650,15 @@ NAN_METHOD(RasterBandPixels::readBlock)
 
 	Local<Value> array;
 	Local<Object> obj;
+	bool shared = false;
 
-	if(info.Length() == 3 && !info[2]->IsUndefined() && !info[2]->IsNull()) {
+	NODE_ARG_BOOL_OPT(3, "shared", shared);
+
+	if(info.Length() >= 3 && !info[2]->IsUndefined() && !info[2]->IsNull() && !info[2]->IsFunction()) {
 		NODE_ARG_OBJECT(2, "data", obj);
  		array = obj;
 	} else {
-		array = TypedArray::New(type, w * h);
+		array = TypedArray::New(type, w * h, shared);
 		if(array.IsEmpty() || !array->IsObject()) {
 			return; //TypedArray::New threw an error
 		}
@@ -403,6 +671,18 @@ NAN_METHOD(RasterBandPixels::readBlock)
 		return; //TypedArray::Validate threw an error
 	}
 
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(4, "callback", callback);
+
+		RasterBandPixelsWorker *worker = new RasterBandPixelsWorker(callback, RasterBandPixelsWorker::READ_BLOCK, band, parent, obj, data);
+		worker->setBlock(x, y);
+		job_pool.queue(worker);
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	DatasetLock lock(band->uid);
 	CPLErr err = band->get()->ReadBlock(x, y, data);
 	if(err) {
 		NODE_THROW_CPLERR(err);
@@ -422,6 +702,27 @@ NAN_METHOD(RasterBandPixels::readBlock)
  * @param {TypedArray} data The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values to write to the band.
  */
 NAN_METHOD(RasterBandPixels::writeBlock)
+{
+	writeBlockImpl(info, false);
+}
+
+/**
+ * Writes a block of pixels on a background thread.
+ *
+ * @method writeBlockAsync
+ * @param {Integer} x
+ * @param {Integer} y
+ * @param {TypedArray} data The [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values to write to the band.
+ * @param {Object} [options]
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(RasterBandPixels::writeBlockAsync)
+{
+	writeBlockImpl(info, true);
+}
+
+void RasterBandPixels::writeBlockImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -448,6 +749,18 @@ NAN_METHOD(RasterBandPixels::writeBlock)
 		return; //TypedArray::Validate threw an error
 	}
 
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(3, "callback", callback);
+
+		RasterBandPixelsWorker *worker = new RasterBandPixelsWorker(callback, RasterBandPixelsWorker::WRITE_BLOCK, band, parent, obj, data);
+		worker->setBlock(x, y);
+		job_pool.queue(worker);
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	DatasetLock lock(band->uid);
 	CPLErr err = band->get()->WriteBlock(x, y, data);
 
 	if(err) {
@@ -458,5 +771,235 @@ NAN_METHOD(RasterBandPixels::writeBlock)
 	return;
 }
 
+/**
+ * Pins a block in GDAL's block cache and returns a
+ * [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses)
+ * viewing the cached data directly, without copying it. Edge blocks have
+ * the full block size; pixels outside the raster are undefined.
+ *
+ * The array must be treated as read-only: changes aren't written back to
+ * the band. The block stays pinned until the array's `release()` method is
+ * called, the array is garbage collected, or the band / dataset is flushed or
+ * closed. The array is detached (its length becomes 0) once released.
+ * Blocks must be released before the band is flushed from another thread,
+ * e.g. by `buildOverviewsAsync()`.
+ *
+ * Not supported on in-memory (MEM) datasets: the MEM driver flushes the block
+ * cache on every read and write, which would wait forever on a pinned block.
+ *
+ * ```
+ * var data = band.pixels.lockBlock(0, 0);
+ * var sum = 0;
+ * for (var i = 0; i < data.length; i++) sum += data[i];
+ * data.release();```
+ *
+ * @method lockBlock
+ * @throws Error
+ * @param {Integer} x
+ * @param {Integer} y
+ * @return {TypedArray} A [TypedArray](https://developer.mozilla.org/en-US/docs/Web/API/ArrayBufferView#Typed_array_subclasses) of values, with a `release()` method.
+ */
+NAN_METHOD(RasterBandPixels::lockBlock)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	int x, y;
+	NODE_ARG_INT(0, "block_x_offset", x);
+	NODE_ARG_INT(1, "block_y_offset", y);
+
+	GDALRasterBlock *block;
+	long uid;
+	Local<ArrayBuffer> array_buffer = pinBlock(band, x, y, block, uid);
+	if(array_buffer.IsEmpty()) {
+		return; //pinBlock threw an error
+	}
+
+	Local<Value> array = TypedArray::New(block->GetDataType(), array_buffer);
+	if(array.IsEmpty() || !array->IsObject()) {
+		ptr_manager.releaseBlock(uid);
+		return; //TypedArray::New threw an error
+	}
+	Nan::SetPrivate(array.As<Object>(), Nan::New("block_uid_").ToLocalChecked(), Nan::New<Number>(uid));
+
+	info.GetReturnValue().Set(array);
+}
+
+// The MEM driver flushes the block cache in IRasterIO, waiting for every
+// locked block of the dataset to be unlocked, so its blocks can't be pinned
+// across calls.
+bool RasterBandPixels::canPinBlocks(RasterBand *band)
+{
+	GDALDataset *ds = band->getParent();
+	GDALDriver *driver = ds ? ds->GetDriver() : NULL;
+	return !driver || !EQUAL(driver->GetDescription(), "MEM");
+}
+
+// Locks a block in the cache and wraps its data in an ArrayBuffer registered
+// with the ptr_manager. The block is unlocked when the buffer is collected,
+// or earlier by ptr_manager.releaseBlock(uid). Returns an empty handle and
+// throws on failure.
+Local<ArrayBuffer> RasterBandPixels::pinBlock(RasterBand *band, int x, int y, GDALRasterBlock *&block, long &uid)
+{
+	Nan::EscapableHandleScope scope;
+
+	if(!canPinBlocks(band)) {
+		Nan::ThrowError("Blocks of in-memory (MEM) datasets can't be locked");
+		return Local<ArrayBuffer>();
+	}
+
+	{
+		DatasetLock lock(band->uid);
+		block = band->get()->GetLockedBlockRef(x, y);
+	}
+	if(!block) {
+		NODE_THROW_LAST_CPLERR();
+		return Local<ArrayBuffer>();
+	}
+
+	long *collected_uid = new long(0);
+	Local<Object> buffer;
+	if(!Nan::NewBuffer(static_cast<char*>(block->GetDataRef()), block->GetBlockSize(), onLockedBlockCollected, collected_uid).ToLocal(&buffer)) {
+		delete collected_uid;
+		block->DropLock();
+		Nan::ThrowError("Error creating block buffer");
+		return Local<ArrayBuffer>();
+	}
+
+	// track the block before anything else can throw, so it gets unlocked
+	Local<ArrayBuffer> array_buffer = buffer.As<ArrayBufferView>()->Buffer();
+	uid = *collected_uid = ptr_manager.add(block, band->uid, array_buffer);
+
+	return scope.Escape(array_buffer);
+}
+
+/**
+ * Unpins a block locked with {{#crossLink "gdal.RasterBandPixels/lockBlock:method"}}lockBlock(){{/crossLink}}
+ * and detaches its array. Same as calling the array's `release()` method.
+ * Does nothing if the block was already released.
+ *
+ * @method releaseBlock
+ * @param {TypedArray} data The array returned by `lockBlock()`.
+ */
+NAN_METHOD(RasterBandPixels::releaseBlock)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> obj;
+	NODE_ARG_OBJECT(0, "data", obj);
+
+	Local<Value> uid = Nan::GetPrivate(obj, Nan::New("block_uid_").ToLocalChecked()).ToLocalChecked();
+	if(!uid->IsNumber()) {
+		Nan::ThrowError("Array was not returned by lockBlock()");
+		return;
+	}
+
+	ptr_manager.releaseBlock(static_cast<long>(Nan::To<int64_t>(uid).ToChecked()));
+}
+
+/**
+ * Returns an iterator over the band's blocks, each read with a single call
+ * and clipped to the raster (or `window`) edges. Reading in block order keeps
+ * GDAL's block cache effective, and is the fastest way to stream through a
+ * whole band.
+ *
+ * With `order: "tile"` each block is yielded on its own, left to right then
+ * top to bottom. With `order: "row"` a full-width strip one block tall is
+ * yielded instead, which suits scanline-organized rasters.
+ *
+ * ```
+ * for (var block of band.pixels.blocks({reuse: true})) {
+ *   // block.x, block.y, block.width, block.height, block.data
+ * }```
+ *
+ * @method blocks
+ * @throws Error
+ * @param {Object} [options]
+ * @param {String} [options.order="tile"] `"tile"` or `"row"`.
+ * @param {Object} [options.window] Only iterate over part of the band: `{x, y, width, height}`. The whole band is used by default.
+ * @param {Boolean} [options.reuse=false] Read every block into the same buffer instead of allocating a new array for each one. Each `data` array is then only valid until `next()` is called again.
+ * @return {gdal.RasterBandBlockIterator}
+ */
+NAN_METHOD(RasterBandPixels::blocks)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	int x = 0, y = 0;
+	int w = band->get()->GetXSize();
+	int h = band->get()->GetYSize();
+	std::string order = "tile";
+	bool reuse = false;
+
+	if (info.Length() > 0 && !info[0]->IsUndefined() && !info[0]->IsNull()) {
+		Local<Object> obj;
+		Local<Value> prop;
+		NODE_ARG_OBJECT(0, "options", obj);
+		NODE_STR_FROM_OBJ_OPT(obj, "order", order);
+
+		prop = Nan::Get(obj, Nan::New("window").ToLocalChecked()).ToLocalChecked();
+		if (prop->IsObject()) {
+			Local<Object> window = prop.As<Object>();
+			NODE_INT_FROM_OBJ(window, "x", x);
+			NODE_INT_FROM_OBJ(window, "y", y);
+			NODE_INT_FROM_OBJ(window, "width", w);
+			NODE_INT_FROM_OBJ(window, "height", h);
+		} else if (!prop->IsUndefined() && !prop->IsNull()) {
+			Nan::ThrowTypeError("window property must be an object");
+			return;
+		}
+
+		prop = Nan::Get(obj, Nan::New("reuse").ToLocalChecked()).ToLocalChecked();
+		reuse = Nan::To<bool>(prop).FromMaybe(false);
+	}
+
+	if (order != "tile" && order != "row") {
+		Nan::ThrowError("order must be \"tile\" or \"row\"");
+		return;
+	}
+	if (x < 0 || y < 0 || w < 0 || h < 0 || x + w > band->get()->GetXSize() || y + h > band->get()->GetYSize()) {
+		Nan::ThrowRangeError("window is outside of the raster");
+		return;
+	}
+
+	info.GetReturnValue().Set(RasterBandBlockIterator::New(parent, x, y, w, h, order == "row", reuse));
+}
+
+/**
+ * Returns a sampler for reading many individual pixels. Unlike
+ * {{#crossLink "gdal.RasterBandPixels/get:method"}}get(){{/crossLink}}, it
+ * reads straight from the cached block instead of calling `RasterIO` for
+ * every pixel (except on in-memory (MEM) datasets, whose blocks can't be
+ * locked).
+ *
+ * @method sampler
+ * @throws Error
+ * @return {gdal.RasterBandSampler}
+ */
+NAN_METHOD(RasterBandPixels::sampler)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> parent = Nan::GetPrivate(info.This(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(parent);
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	info.GetReturnValue().Set(RasterBandSampler::New(parent));
+}
 
 }
@@ -19,9 +19,11 @@ using namespace node;
 
 namespace node_gdal {
 
+class RasterBand;
+
 class RasterBandPixels: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
@@ -34,10 +36,25 @@ public:
 	static NAN_METHOD(write);
 	static NAN_METHOD(readBlock);
 	static NAN_METHOD(writeBlock);
-	
+	static NAN_METHOD(readAsync);
+	static NAN_METHOD(writeAsync);
+	static NAN_METHOD(readBlockAsync);
+	static NAN_METHOD(writeBlockAsync);
+	static NAN_METHOD(lockBlock);
+	static NAN_METHOD(releaseBlock);
+	static NAN_METHOD(blocks);
+	static NAN_METHOD(sampler);
+
+	static bool canPinBlocks(RasterBand *band);
+	static Local<ArrayBuffer> pinBlock(RasterBand *band, int x, int y, GDALRasterBlock *&block, long &uid);
+
 	RasterBandPixels();
 private:
 	~RasterBandPixels();
+	static void readImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	static void writeImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	static void readBlockImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	static void writeBlockImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
 };
 
 }
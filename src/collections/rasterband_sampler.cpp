@@ -0,0 +1,301 @@
+#include "../gdal_common.hpp"
+#include "../gdal_rasterband.hpp"
+#include "rasterband_pixels.hpp"
+#include "rasterband_sampler.hpp"
+#include "../utils/typed_array.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace node_gdal {
+
+thread_local Nan::Persistent<FunctionTemplate> RasterBandSampler::constructor;
+
+void RasterBandSampler::Initialize(Local<Object> target)
+{
+	Nan::HandleScope scope;
+
+	Local<FunctionTemplate> lcons = Nan::New<FunctionTemplate>(RasterBandSampler::New);
+	lcons->InstanceTemplate()->SetInternalFieldCount(1);
+	lcons->SetClassName(Nan::New("RasterBandSampler").ToLocalChecked());
+
+	Nan::SetPrototypeMethod(lcons, "toString", toString);
+	Nan::SetPrototypeMethod(lcons, "get", get);
+	Nan::SetPrototypeMethod(lcons, "getMany", getMany);
+	Nan::SetPrototypeMethod(lcons, "release", release);
+
+	Nan::Set(target, Nan::New("RasterBandSampler").ToLocalChecked(), Nan::GetFunction(lcons).ToLocalChecked());
+
+	constructor.Reset(lcons);
+}
+
+RasterBandSampler::RasterBandSampler()
+	: Nan::ObjectWrap(), band_uid(0), raster_w(0), raster_h(0), block_w(0), block_h(0),
+	  type(GDT_Unknown), type_size(0), pin_blocks(true), block_uid(0), block_x(0), block_y(0), block_data(NULL)
+{}
+
+RasterBandSampler::~RasterBandSampler()
+{}
+
+/**
+ * Reads individual pixels of a {{#crossLink "gdal.RasterBand"}}RasterBand{{/crossLink}}
+ * straight from GDAL's block cache. The block holding the last pixel read
+ * stays locked in the cache, so reading nearby pixels doesn't go through
+ * `RasterIO` at all. Created with {{#crossLink "gdal.RasterBandPixels/sampler:method"}}band.pixels.sampler(){{/crossLink}}.
+ *
+ * The block is unlocked when {{#crossLink "gdal.RasterBandSampler/release:method"}}release(){{/crossLink}}
+ * is called, when the sampler is garbage collected, or when the band or
+ * dataset is flushed or closed. Blocks of in-memory (MEM) datasets can't be
+ * locked, so on those each pixel is read with `RasterIO`.
+ *
+ * ```
+ * var sampler = band.pixels.sampler();
+ * var value = sampler.get(10, 20);
+ * var values = sampler.getMany(new Int32Array([10, 11, 500]), new Int32Array([20, 20, 300]));
+ * sampler.release();```
+ *
+ * @class gdal.RasterBandSampler
+ */
+NAN_METHOD(RasterBandSampler::New)
+{
+	Nan::HandleScope scope;
+
+	if (!info.IsConstructCall()) {
+		Nan::ThrowError("Cannot call constructor as function, you need to use 'new' keyword");
+		return;
+	}
+	if (info[0]->IsExternal()) {
+		Local<External> ext = info[0].As<External>();
+		void* ptr = ext->Value();
+		RasterBandSampler *f = static_cast<RasterBandSampler *>(ptr);
+		f->Wrap(info.This());
+		info.GetReturnValue().Set(info.This());
+		return;
+	} else {
+		Nan::ThrowError("Cannot create RasterBandSampler directly");
+		return;
+	}
+}
+
+Local<Value> RasterBandSampler::New(Local<Value> band_obj)
+{
+	Nan::EscapableHandleScope scope;
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(band_obj.As<Object>());
+	GDALRasterBand *raw = band->get();
+
+	RasterBandSampler *wrapped = new RasterBandSampler();
+	wrapped->band_uid = band->uid;
+	wrapped->raster_w = raw->GetXSize();
+	wrapped->raster_h = raw->GetYSize();
+	raw->GetBlockSize(&wrapped->block_w, &wrapped->block_h);
+	wrapped->type = raw->GetRasterDataType();
+	wrapped->type_size = GDALGetDataTypeSizeBytes(wrapped->type);
+	wrapped->pin_blocks = RasterBandPixels::canPinBlocks(band);
+
+	v8::Local<v8::Value> ext = Nan::New<External>(wrapped);
+	v8::Local<v8::Object> obj = Nan::NewInstance(Nan::GetFunction(Nan::New(RasterBandSampler::constructor)).ToLocalChecked(), 1, &ext).ToLocalChecked();
+	Nan::SetPrivate(obj, Nan::New("parent_").ToLocalChecked(), band_obj);
+
+	return scope.Escape(obj);
+}
+
+NAN_METHOD(RasterBandSampler::toString)
+{
+	Nan::HandleScope scope;
+	info.GetReturnValue().Set(Nan::New("RasterBandSampler").ToLocalChecked());
+}
+
+/**
+ * Returns the value at the x, y coordinate.
+ *
+ * @method get
+ * @throws Error
+ * @param {Integer} x
+ * @param {Integer} y
+ * @return {Number}
+ */
+NAN_METHOD(RasterBandSampler::get)
+{
+	Nan::HandleScope scope;
+
+	RasterBandSampler *sampler = Nan::ObjectWrap::Unwrap<RasterBandSampler>(info.This());
+
+	int x, y;
+	double value;
+	NODE_ARG_INT(0, "x", x);
+	NODE_ARG_INT(1, "y", y);
+
+	if (!sampler->sample(x, y, value)) {
+		return; //sample() threw an error
+	}
+
+	info.GetReturnValue().Set(Nan::New<Number>(value));
+}
+
+/**
+ * Returns the values at many x, y coordinates at once. The points are read
+ * grouped by block, so each block is only locked once whatever the order of
+ * the coordinates.
+ *
+ * @method getMany
+ * @throws Error
+ * @param {Int32Array} x
+ * @param {Int32Array} y
+ * @param {Float64Array} [data] The array to put the values in. A new array is created if not given.
+ * @return {Float64Array} The values, in the order of the coordinates.
+ */
+NAN_METHOD(RasterBandSampler::getMany)
+{
+	Nan::HandleScope scope;
+
+	RasterBandSampler *sampler = Nan::ObjectWrap::Unwrap<RasterBandSampler>(info.This());
+
+	Local<Object> xs_obj, ys_obj;
+	NODE_ARG_OBJECT(0, "x", xs_obj);
+	NODE_ARG_OBJECT(1, "y", ys_obj);
+
+	if (!xs_obj->IsInt32Array() || !ys_obj->IsInt32Array()) {
+		Nan::ThrowTypeError("x and y must be Int32Array objects");
+		return;
+	}
+	Nan::TypedArrayContents<int32_t> xs(xs_obj);
+	Nan::TypedArrayContents<int32_t> ys(ys_obj);
+	if (xs.length() != ys.length()) {
+		Nan::ThrowError("x and y must have the same length");
+		return;
+	}
+	int n = xs.length();
+
+	Local<Value> array;
+	if (info.Length() > 2 && !info[2]->IsUndefined() && !info[2]->IsNull()) {
+		NODE_ARG_OBJECT(2, "data", array);
+	} else {
+		array = TypedArray::New(GDT_Float64, n);
+		if (array.IsEmpty() || !array->IsObject()) {
+			return; //TypedArray::New threw an error
+		}
+	}
+	double *values = static_cast<double*>(TypedArray::Validate(array.As<Object>(), GDT_Float64, n));
+	if (!values) {
+		return; //TypedArray::Validate threw an error
+	}
+
+	// visit the points block by block, in the order blocks are stored
+	std::vector<int> order(n);
+	std::vector<int> keys(n);
+	int blocks_per_row = (sampler->raster_w + sampler->block_w - 1) / sampler->block_w;
+	for (int i = 0; i < n; i++) {
+		order[i] = i;
+		keys[i] = (ys[i] / sampler->block_h) * blocks_per_row + xs[i] / sampler->block_w;
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) { return keys[a] < keys[b]; });
+
+	for (int i = 0; i < n; i++) {
+		int j = order[i];
+		if (!sampler->sample(xs[j], ys[j], values[j])) {
+			return; //sample() threw an error
+		}
+	}
+
+	info.GetReturnValue().Set(array);
+}
+
+/**
+ * Unlocks the block held by the sampler. The sampler can still be used; the
+ * next read locks a block again.
+ *
+ * @method release
+ */
+NAN_METHOD(RasterBandSampler::release)
+{
+	Nan::HandleScope scope;
+
+	RasterBandSampler *sampler = Nan::ObjectWrap::Unwrap<RasterBandSampler>(info.This());
+	sampler->unlockBlock();
+}
+
+// Reads a pixel as a double. Throws and returns false on failure.
+bool RasterBandSampler::sample(int x, int y, double &value)
+{
+	if (x < 0 || y < 0 || x >= raster_w || y >= raster_h) {
+		Nan::ThrowRangeError("Pixel coordinates are outside of the raster");
+		return false;
+	}
+
+	if (!pin_blocks) return read(x, y, value);
+
+	int bx = x / block_w;
+	int by = y / block_h;
+
+	// the ptr_manager forgets the block once it has been unlocked by a flush
+	if (!block_uid || bx != block_x || by != block_y || !ptr_manager.isAlive(block_uid)) {
+		if (!lockBlock(bx, by)) return false;
+	}
+
+	int offset = (y - by * block_h) * block_w + (x - bx * block_w);
+	GDALCopyWords(block_data + offset * type_size, type, 0, &value, GDT_Float64, 0, 1);
+	return true;
+}
+
+bool RasterBandSampler::read(int x, int y, double &value)
+{
+	if (!ptr_manager.isAlive(band_uid)) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return false;
+	}
+
+	Local<Object> parent = Nan::GetPrivate(handle(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(parent);
+
+	CPLErr err;
+	{
+		DatasetLock lock(band_uid);
+		err = band->get()->RasterIO(GF_Read, x, y, 1, 1, &value, 1, 1, GDT_Float64, 0, 0);
+	}
+	if (err) {
+		NODE_THROW_CPLERR(err);
+		return false;
+	}
+	return true;
+}
+
+bool RasterBandSampler::lockBlock(int bx, int by)
+{
+	unlockBlock();
+
+	if (!ptr_manager.isAlive(band_uid)) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return false;
+	}
+
+	Local<Object> parent = Nan::GetPrivate(handle(), Nan::New("parent_").ToLocalChecked()).ToLocalChecked().As<Object>();
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(parent);
+
+	GDALRasterBlock *block;
+	Local<ArrayBuffer> buffer = RasterBandPixels::pinBlock(band, bx, by, block, block_uid);
+	if (buffer.IsEmpty()) {
+		block_uid = 0;
+		return false; //pinBlock threw an error
+	}
+
+	// keeps the block locked until the sampler is collected
+	Nan::SetPrivate(handle(), Nan::New("block_").ToLocalChecked(), buffer);
+
+	block_x = bx;
+	block_y = by;
+	block_data = static_cast<char*>(block->GetDataRef());
+	return true;
+}
+
+void RasterBandSampler::unlockBlock()
+{
+	if (block_uid) {
+		ptr_manager.releaseBlock(block_uid);
+		Nan::DeletePrivate(handle(), Nan::New("block_").ToLocalChecked());
+	}
+	block_uid = 0;
+	block_data = NULL;
+}
+
+}
@@ -0,0 +1,63 @@
+#ifndef __NODE_GDAL_BAND_SAMPLER_H__
+#define __NODE_GDAL_BAND_SAMPLER_H__
+
+// node
+#include <node.h>
+#include <node_object_wrap.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+using namespace v8;
+using namespace node;
+
+namespace node_gdal {
+
+// Reads single pixels of a band, keeping the block of the last pixel read
+// locked in the block cache so neighbouring reads skip RasterIO entirely.
+// Blocks of MEM datasets can't be pinned, so those are read with RasterIO.
+
+class RasterBandSampler: public Nan::ObjectWrap {
+public:
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
+
+	static void Initialize(Local<Object> target);
+	static NAN_METHOD(New);
+	static Local<Value> New(Local<Value> band_obj);
+	static NAN_METHOD(toString);
+	static NAN_METHOD(get);
+	static NAN_METHOD(getMany);
+	static NAN_METHOD(release);
+
+	bool sample(int x, int y, double &value);
+
+	RasterBandSampler();
+private:
+	~RasterBandSampler();
+	bool read(int x, int y, double &value);
+	bool lockBlock(int block_x, int block_y);
+	void unlockBlock();
+
+	long band_uid;
+	int raster_w;
+	int raster_h;
+	int block_w;
+	int block_h;
+	GDALDataType type;
+	int type_size;
+	bool pin_blocks;
+	// currently locked block
+	long block_uid;
+	int block_x;
+	int block_y;
+	char *block_data;
+};
+
+}
+#endif
@@ -10,6 +10,9 @@
 #include <nan.h>
 #pragma GCC diagnostic pop
 
+// gdal
+#include <cpl_string.h>
+
 // ogr
 #include <ogr_api.h>
 #include <ogrsf_frmts.h>
@@ -18,6 +21,8 @@
 #include "gdal_common.hpp"
 #include "gdal_driver.hpp"
 #include "gdal_dataset.hpp"
+#include "utils/string_list.hpp"
+#include "utils/typed_array.hpp"
 
 using namespace v8;
 using namespace node;
@@ -76,6 +81,139 @@ namespace node_gdal {
 		return;
 	}
 
+	static NAN_METHOD(openAsync)
+	{
+		Nan::HandleScope scope;
+
+		std::string path;
+		std::string mode = "r";
+		StringList open_options;
+		StringList allowed_drivers;
+
+		NODE_ARG_STR(0, "path", path);
+		NODE_ARG_OPT_STR(1, "mode", mode);
+
+		GDALAccess access = GA_ReadOnly;
+		if (mode == "r+") {
+			access = GA_Update;
+		} else if (mode != "r") {
+			Nan::ThrowError("Invalid open mode. Must be \"r\" or \"r+\"");
+			return;
+		}
+
+		if (info.Length() > 2 && open_options.parse(info[2])) {
+			return; // error parsing string list
+		}
+		if (info.Length() > 3 && allowed_drivers.parse(info[3])) {
+			return; // error parsing string list
+		}
+
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(4, "callback", callback);
+
+		DatasetOpenWorker *worker = new DatasetOpenWorker(callback, path, access, open_options.get(), allowed_drivers.get());
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+	}
+
+	// Wraps a typed array in a MEM dataset without copying it: every band
+	// points into the array's buffer with the DATAPOINTER band option. The
+	// array is kept alive as a private of the returned Dataset object (bands
+	// keep the dataset object alive in turn).
+	static NAN_METHOD(fromTypedArray)
+	{
+		Nan::HandleScope scope;
+
+		Local<Object> array;
+		int width, height, n_bands = 1;
+		std::string interleave = "band";
+
+		NODE_ARG_OBJECT(0, "array", array);
+		NODE_ARG_INT(1, "width", width);
+		NODE_ARG_INT(2, "height", height);
+		NODE_ARG_INT_OPT(3, "bands", n_bands);
+		NODE_ARG_OPT_STR(4, "interleave", interleave);
+
+		if (!array->IsArrayBufferView()) {
+			Nan::ThrowTypeError("array must be a TypedArray");
+			return;
+		}
+		if (width <= 0 || height <= 0 || n_bands <= 0) {
+			Nan::ThrowError("width, height and bands must be greater than zero");
+			return;
+		}
+
+		GDALDataType type = TypedArray::Identify(array);
+		int type_size = GDALGetDataTypeSize(type) / 8;
+		if (type == GDT_Unknown || type_size == 0) {
+			Nan::ThrowTypeError("Unable to identify GDAL datatype of passed array object");
+			return;
+		}
+
+		GIntBig length = static_cast<GIntBig>(width) * height * n_bands;
+		if (length > INT_MAX) {
+			Nan::ThrowError("Array is too large");
+			return;
+		}
+		GByte *data = static_cast<GByte*>(TypedArray::Validate(array, type, static_cast<int>(length)));
+		if (!data) return; // TypedArray::Validate() throws error
+
+		// byte offsets between pixels, lines and bands
+		GIntBig pixel_offset, line_offset, band_offset;
+		if (interleave == "band") {
+			pixel_offset = type_size;
+			line_offset = pixel_offset * width;
+			band_offset = line_offset * height;
+		} else if (interleave == "line") {
+			pixel_offset = type_size;
+			band_offset = pixel_offset * width;
+			line_offset = band_offset * n_bands;
+		} else if (interleave == "pixel") {
+			band_offset = type_size;
+			pixel_offset = band_offset * n_bands;
+			line_offset = pixel_offset * width;
+		} else {
+			Nan::ThrowError("interleave must be \"band\", \"line\" or \"pixel\"");
+			return;
+		}
+
+		GDALDriver *driver = GetGDALDriverManager()->GetDriverByName("MEM");
+		if (!driver) {
+			Nan::ThrowError("MEM driver not available");
+			return;
+		}
+		GDALDataset *ds = driver->Create("", width, height, 0, type, NULL);
+		if (!ds) {
+			NODE_THROW_LAST_CPLERR();
+			return;
+		}
+
+		for (int i = 0; i < n_bands; i++) {
+			char pointer[64];
+			int n = CPLPrintPointer(pointer, data + band_offset * i, sizeof(pointer));
+			pointer[n] = '\0';
+
+			char **options = NULL;
+			options = CSLSetNameValue(options, "DATAPOINTER", pointer);
+			options = CSLSetNameValue(options, "PIXELOFFSET", CPLSPrintf(CPL_FRMT_GIB, pixel_offset));
+			options = CSLSetNameValue(options, "LINEOFFSET", CPLSPrintf(CPL_FRMT_GIB, line_offset));
+			CPLErr err = ds->AddBand(type, options);
+			CSLDestroy(options);
+
+			if (err) {
+				GDALClose(ds);
+				NODE_THROW_CPLERR(err);
+				return;
+			}
+		}
+
+		Local<Object> obj = Dataset::New(ds).As<Object>();
+		Nan::SetPrivate(obj, Nan::New("array_").ToLocalChecked(), array);
+
+		info.GetReturnValue().Set(obj);
+	}
+
 	static NAN_METHOD(setConfigOption)
 	{
 		Nan::HandleScope scope;
@@ -4,9 +4,158 @@
 #include "gdal_dataset.hpp"
 #include "gdal_rasterband.hpp"
 #include "utils/number_list.hpp"
+#include "utils/async_worker.hpp"
+#include "utils/calc_expression.hpp"
+#include "utils/zonal_statistics.hpp"
+
+#include <cpl_multiproc.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <string>
+#include <vector>
+
+// rows per checksum chunk. must be a multiple of 11 so that each chunk starts
+// at the beginning of GDALChecksumImage's prime cycle
+#define CHECKSUM_CHUNK_ROWS 176
+
+// pixels gdal.calc reads per batch of blocks, to be split between threads
+#define CALC_BATCH_PIXELS (1 << 20)
+// pixels each calc thread evaluates at a time, so the stack stays in cache
+#define CALC_CHUNK_PIXELS 4096
 
 namespace node_gdal {
 
+/*
+ * Runs an algorithm on the threadpool. The job is given the progress
+ * function and argument to pass to GDAL.
+ */
+class AlgorithmWorker : public AsyncWorker {
+public:
+	typedef std::function<CPLErr(GDALProgressFunc, void*)> Job;
+
+	AlgorithmWorker(Nan::Callback *callback, const char *resource_name, Job job)
+		: AsyncWorker(callback, resource_name), job(job)
+	{}
+
+protected:
+	void Run()
+	{
+		if(job(progressFunc, this)) {
+			SetErrorFromCPL("Error running algorithm");
+		}
+	}
+
+private:
+	Job job;
+};
+
+/*
+ * Computes an image checksum on the threadpool. GDALChecksumImage doesn't
+ * report progress, so the region is processed in chunks whose checksums
+ * are summed (the checksum is additive mod 2^16).
+ */
+class ChecksumWorker : public AsyncWorker {
+public:
+	ChecksumWorker(Nan::Callback *callback, GDALRasterBand *band, int x, int y, int w, int h)
+		: AsyncWorker(callback, "gdal:checksumImage"), band(band), x(x), y(y), w(w), h(h), checksum(0)
+	{}
+
+protected:
+	void Run()
+	{
+		for(int row = 0; row < h; row += CHECKSUM_CHUNK_ROWS) {
+			if(!progressFunc((double)row / h, NULL, this)) {
+				return;
+			}
+			int rows = row + CHECKSUM_CHUNK_ROWS > h ? h - row : CHECKSUM_CHUNK_ROWS;
+			checksum = (checksum + GDALChecksumImage(band, x, y + row, w, rows)) & 0xffff;
+			if(CPLGetLastErrorType() == CE_Failure) {
+				SetErrorFromCPL("Error computing checksum");
+				return;
+			}
+		}
+		progressFunc(1.0, NULL, this);
+	}
+
+	Local<Value> Result()
+	{
+		return Nan::New<Integer>(checksum);
+	}
+
+private:
+	GDALRasterBand *band;
+	int x, y, w, h;
+	int checksum;
+};
+
+/*
+ * Computes zonal statistics on the threadpool, resolving with the columns.
+ */
+class ZonalStatisticsWorker : public AsyncWorker {
+public:
+	ZonalStatisticsWorker(Nan::Callback *callback, ZonalStatistics *stats)
+		: AsyncWorker(callback, "gdal:zonalStatistics"), stats(stats)
+	{}
+	~ZonalStatisticsWorker()
+	{
+		delete stats;
+	}
+
+protected:
+	void Run()
+	{
+		if(stats->run(progressFunc, this)) {
+			SetErrorFromCPL("Error computing zonal statistics");
+		}
+	}
+
+	Local<Value> Result()
+	{
+		return stats->result();
+	}
+
+private:
+	ZonalStatistics *stats;
+};
+
+// Runs the job synchronously, or queues it when called from an *Async()
+// method with (options, progress, callback) arguments.
+static void runAlgorithm(Nan::NAN_METHOD_ARGS_TYPE info, bool async, const char *resource_name, AlgorithmWorker::Job job, std::vector<long> uids)
+{
+	if(!async) {
+		CPLErr err;
+		{
+			DatasetLock lock(uids);
+			err = job(NULL, NULL);
+		}
+		if(err) {
+			NODE_THROW_CPLERR(err);
+		}
+		return;
+	}
+
+	Nan::Callback *callback;
+	NODE_ARG_CALLBACK(2, "callback", callback);
+
+	AlgorithmWorker *worker = new AlgorithmWorker(callback, resource_name, job);
+	// keeps the bands / layers from being collected
+	worker->SaveToPersistent("options", info[0]);
+	for(unsigned int i = 0; i < uids.size(); i++) {
+		worker->useDataset(uids[i]);
+	}
+	if(info[1]->IsFunction()) {
+		worker->setProgressCallback(info[1].As<Function>());
+	}
+	job_pool.queue(worker);
+
+	info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+}
+
 void Algorithms::Initialize(Local<Object> target)
 {
 	Nan::SetMethod(target, "fillNodata", fillNodata);
@@ -14,6 +163,15 @@ void Algorithms::Initialize(Local<Object> target)
 	Nan::SetMethod(target, "sieveFilter", sieveFilter);
 	Nan::SetMethod(target, "checksumImage", checksumImage);
 	Nan::SetMethod(target, "polygonize", polygonize);
+	Nan::SetMethod(target, "calc", calc);
+	Nan::SetMethod(target, "zonalStatistics", zonalStatistics);
+	Nan::SetMethod(target, "fillNodataAsync", fillNodataAsync);
+	Nan::SetMethod(target, "contourGenerateAsync", contourGenerateAsync);
+	Nan::SetMethod(target, "sieveFilterAsync", sieveFilterAsync);
+	Nan::SetMethod(target, "checksumImageAsync", checksumImageAsync);
+	Nan::SetMethod(target, "polygonizeAsync", polygonizeAsync);
+	Nan::SetMethod(target, "calcAsync", calcAsync);
+	Nan::SetMethod(target, "zonalStatisticsAsync", zonalStatisticsAsync);
 }
 
 /**
@@ -30,6 +188,28 @@ void Algorithms::Initialize(Local<Object> target)
  * @param {integer} [options.smoothingIterations=0] The number of 3x3 average filter smoothing iterations to run after the interpolation to dampen artifacts.
  */
 NAN_METHOD(Algorithms::fillNodata)
+{
+	fillNodataImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/fillNodata:method"}}fillNodata(){{/crossLink}}.
+ *
+ * @method fillNodataAsync
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(Algorithms::fillNodataAsync)
+{
+	fillNodataImpl(info, true);
+}
+
+void Algorithms::fillNodataImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -46,14 +226,13 @@ NAN_METHOD(Algorithms::fillNodata)
 	NODE_DOUBLE_FROM_OBJ(obj, "searchDist", search_dist);
 	NODE_INT_FROM_OBJ_OPT(obj, "smoothIterations", smooth_iterations)
 
-	CPLErr err = GDALFillNodata(src->get(), mask ? mask->get() : NULL, search_dist, 0, smooth_iterations, NULL, NULL, NULL);
+	GDALRasterBand *src_raw = src->get();
+	GDALRasterBand *mask_raw = mask ? mask->get() : NULL;
+	AlgorithmWorker::Job job = [=](GDALProgressFunc progress, void *progress_arg) {
+		return GDALFillNodata(src_raw, mask_raw, search_dist, 0, smooth_iterations, NULL, progress, progress_arg);
+	};
 
-	if(err) {
-		NODE_THROW_CPLERR(err);
-		return;
-	}
-
-	return;
+	runAlgorithm(info, async, "gdal:fillNodata", job, {src->uid, mask ? mask->uid : 0});
 }
 
 /**
@@ -79,6 +258,28 @@ NAN_METHOD(Algorithms::fillNodata)
  * @param {integer} [options.elevField] A field index to indicate where the elevation value of the contour should be written.
  */
 NAN_METHOD(Algorithms::contourGenerate)
+{
+	contourGenerateImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/contourGenerate:method"}}contourGenerate(){{/crossLink}}.
+ *
+ * @method contourGenerateAsync
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(Algorithms::contourGenerateAsync)
+{
+	contourGenerateImpl(info, true);
+}
+
+void Algorithms::contourGenerateImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -120,14 +321,14 @@ NAN_METHOD(Algorithms::contourGenerate)
 		}
 	}
 
-	CPLErr err = GDALContourGenerate(src->get(), interval, base, n_fixed_levels, fixed_levels, use_nodata, nodata, dst->get(), id_field, elev_field, NULL, NULL);
-
-	if(err) {
-		NODE_THROW_CPLERR(err);
-		return;
-	}
+	GDALRasterBand *src_raw = src->get();
+	OGRLayer *dst_raw = dst->get();
+	std::vector<double> levels(fixed_levels, fixed_levels + n_fixed_levels);
+	AlgorithmWorker::Job job = [=](GDALProgressFunc progress, void *progress_arg) mutable {
+		return GDALContourGenerate(src_raw, interval, base, n_fixed_levels, levels.empty() ? NULL : &levels[0], use_nodata, nodata, dst_raw, id_field, elev_field, progress, progress_arg);
+	};
 
-	return;
+	runAlgorithm(info, async, "gdal:contourGenerate", job, {src->uid, dst->uid});
 }
 
 /**
@@ -145,6 +346,28 @@ NAN_METHOD(Algorithms::contourGenerate)
  * @param {integer} [options.connectedness=4] Either 4 indicating that diagonal pixels are not considered directly adjacent for polygon membership purposes or 8 indicating they are.
  */
 NAN_METHOD(Algorithms::sieveFilter)
+{
+	sieveFilterImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/sieveFilter:method"}}sieveFilter(){{/crossLink}}.
+ *
+ * @method sieveFilterAsync
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(Algorithms::sieveFilterAsync)
+{
+	sieveFilterImpl(info, true);
+}
+
+void Algorithms::sieveFilterImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -168,14 +391,14 @@ NAN_METHOD(Algorithms::sieveFilter)
 		return;
 	}
 
-	CPLErr err = GDALSieveFilter(src->get(), mask ? mask->get() : NULL, dst->get(), threshold, connectedness, NULL, NULL, NULL);
+	GDALRasterBand *src_raw = src->get();
+	GDALRasterBand *dst_raw = dst->get();
+	GDALRasterBand *mask_raw = mask ? mask->get() : NULL;
+	AlgorithmWorker::Job job = [=](GDALProgressFunc progress, void *progress_arg) {
+		return GDALSieveFilter(src_raw, mask_raw, dst_raw, threshold, connectedness, NULL, progress, progress_arg);
+	};
 
-	if(err) {
-		NODE_THROW_CPLERR(err);
-		return;
-	}
-
-	return;
+	runAlgorithm(info, async, "gdal:sieveFilter", job, {src->uid, dst->uid, mask ? mask->uid : 0});
 }
 
 /**
@@ -193,6 +416,33 @@ NAN_METHOD(Algorithms::sieveFilter)
  * @return integer
  */
 NAN_METHOD(Algorithms::checksumImage)
+{
+	checksumImageImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/checksumImage:method"}}checksumImage(){{/crossLink}}.
+ *
+ * @method checksumImageAsync
+ * @static
+ * @for gdal
+ * @param {gdal.RasterBand} src
+ * @param {integer} [x=0]
+ * @param {integer} [y=0]
+ * @param {integer} [w=src.width]
+ * @param {integer} [h=src.height]
+ * @param {Object} [options]
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the checksum.
+ */
+NAN_METHOD(Algorithms::checksumImageAsync)
+{
+	checksumImageImpl(info, true);
+}
+
+void Algorithms::checksumImageImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -222,7 +472,27 @@ NAN_METHOD(Algorithms::checksumImage)
 		return;
 	}
 
-	int checksum = GDALChecksumImage(src->get(), x, y, w, h);
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(6, "callback", callback);
+
+		ChecksumWorker *worker = new ChecksumWorker(callback, src->get(), x, y, w, h);
+		worker->SaveToPersistent("src", info[0]);
+		worker->useDataset(src->uid);
+		if(info[5]->IsFunction()) {
+			worker->setProgressCallback(info[5].As<Function>());
+		}
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	int checksum;
+	{
+		DatasetLock lock(src->uid);
+		checksum = GDALChecksumImage(src->get(), x, y, w, h);
+	}
 
 	info.GetReturnValue().Set(Nan::New<Integer>(checksum));
 }
@@ -246,6 +516,28 @@ NAN_METHOD(Algorithms::checksumImage)
  * @param {Boolean} [options.useFloats=false] Use floating point buffers instead of int buffers.
  */
 NAN_METHOD(Algorithms::polygonize)
+{
+	polygonizeImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/polygonize:method"}}polygonize(){{/crossLink}}.
+ *
+ * @method polygonizeAsync
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(Algorithms::polygonizeAsync)
+{
+	polygonizeImpl(info, true);
+}
+
+void Algorithms::polygonizeImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 
@@ -255,7 +547,7 @@ NAN_METHOD(Algorithms::polygonize)
 	Layer* dst;
 	int connectedness = 4;
 	int pix_val_field = 0;
-	char** papszOptions = NULL;
+	bool use_floats = false;
 
 	NODE_ARG_OBJECT(0, "options", obj);
 
@@ -265,28 +557,458 @@ NAN_METHOD(Algorithms::polygonize)
 	NODE_INT_FROM_OBJ_OPT(obj, "connectedness", connectedness)
 	NODE_INT_FROM_OBJ(obj, "pixValField", pix_val_field);
 
-	if(connectedness == 8) {
-		papszOptions = CSLSetNameValue(papszOptions, "8CONNECTED", "8");
-	} else if (connectedness != 4) {
+	if (connectedness != 4 && connectedness != 8) {
 		Nan::ThrowError("connectedness must be 4 or 8");
 		return;
 	}
 
-	CPLErr err;
-	if(Nan::HasOwnProperty(obj, Nan::New("useFloats").ToLocalChecked()).FromMaybe(false) && Nan::To<bool>(Nan::Get(obj, Nan::New("useFloats").ToLocalChecked()).ToLocalChecked()).ToChecked()){
-		err = GDALFPolygonize(src->get(), mask ? mask->get() : NULL, reinterpret_cast<OGRLayerH>(dst->get()), pix_val_field, papszOptions, NULL, NULL);
-	} else {
-		err = GDALPolygonize(src->get(), mask ? mask->get() : NULL, reinterpret_cast<OGRLayerH>(dst->get()), pix_val_field, papszOptions, NULL, NULL);
+	if(Nan::HasOwnProperty(obj, Nan::New("useFloats").ToLocalChecked()).FromMaybe(false)){
+		use_floats = Nan::To<bool>(Nan::Get(obj, Nan::New("useFloats").ToLocalChecked()).ToLocalChecked()).ToChecked();
+	}
+
+	GDALRasterBand *src_raw = src->get();
+	GDALRasterBand *mask_raw = mask ? mask->get() : NULL;
+	OGRLayerH dst_raw = reinterpret_cast<OGRLayerH>(dst->get());
+	AlgorithmWorker::Job job = [=](GDALProgressFunc progress, void *progress_arg) {
+		char** papszOptions = NULL;
+		if(connectedness == 8) {
+			papszOptions = CSLSetNameValue(papszOptions, "8CONNECTED", "8");
+		}
+
+		CPLErr err;
+		if(use_floats) {
+			err = GDALFPolygonize(src_raw, mask_raw, dst_raw, pix_val_field, papszOptions, progress, progress_arg);
+		} else {
+			err = GDALPolygonize(src_raw, mask_raw, dst_raw, pix_val_field, papszOptions, progress, progress_arg);
+		}
+
+		if(papszOptions) CSLDestroy(papszOptions);
+		return err;
+	};
+
+	runAlgorithm(info, async, "gdal:polygonize", job, {src->uid, dst->uid, mask ? mask->uid : 0});
+}
+
+// Number of threads to split the CPU-bound part of an algorithm between, from
+// GDAL's GDAL_NUM_THREADS config option ("ALL_CPUS" by default)
+static int numThreads()
+{
+	const char *value = CPLGetConfigOption("GDAL_NUM_THREADS", "ALL_CPUS");
+	int n = EQUAL(value, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(value);
+	return n < 1 ? 1 : n;
+}
+
+/*
+ * Evaluates a calc expression over a range of a batch of pixels already
+ * read from the inputs, and sets nodata pixels. The slices of a batch are
+ * evaluated on separate threads, each with its own copy of the expression
+ * (and so of its evaluation stack).
+ */
+struct CalcSlice {
+	CalcExpression expression;
+	const std::vector<double*> *inputs;
+	const std::vector<int> *has_input_nodata;
+	const std::vector<double> *input_nodata;
+	double nodata;
+	double *result;
+	int start;
+	int end;
+
+	static void run(void *arg)
+	{
+		CalcSlice *slice = static_cast<CalcSlice*>(arg);
+		size_t n_inputs = slice->inputs->size();
+		std::vector<const double*> data(n_inputs);
+
+		for(int start = slice->start; start < slice->end; start += CALC_CHUNK_PIXELS) {
+			int n = std::min(CALC_CHUNK_PIXELS, slice->end - start);
+			double *result = slice->result + start;
+			for(size_t k = 0; k < n_inputs; k++) data[k] = (*slice->inputs)[k] + start;
+
+			slice->expression.evaluate(data, n, result);
+
+			for(int i = 0; i < n; i++) {
+				if(std::isnan(result[i])) result[i] = slice->nodata;
+			}
+			for(size_t k = 0; k < n_inputs; k++) {
+				if(!(*slice->has_input_nodata)[k]) continue;
+				const double *values = data[k];
+				double value = (*slice->input_nodata)[k];
+				if(std::isnan(value)) {
+					for(int i = 0; i < n; i++) {
+						if(std::isnan(values[i])) result[i] = slice->nodata;
+					}
+				} else {
+					for(int i = 0; i < n; i++) {
+						if(values[i] == value) result[i] = slice->nodata;
+					}
+				}
+			}
+		}
+	}
+};
+
+/**
+ * Evaluates a map algebra expression over one or more bands, writing the
+ * result to an output band.
+ *
+ * The expression is compiled once. The inputs are read in batches of whole
+ * blocks, and each batch is split between threads that evaluate the
+ * expression on their part of it at the same time. The number of threads is
+ * set by the `GDAL_NUM_THREADS` config option (a number or `"ALL_CPUS"`, the
+ * default). Reading and writing the bands stays on a single thread. It
+ * supports `+ - * / % ^`, comparisons
+ * (`== != < <= > >=`), `&& || !`, `cond ? a : b`, and the functions `abs`,
+ * `sqrt`, `exp`, `log`, `log10`, `sin`, `cos`, `tan`, `asin`, `acos`,
+ * `atan`, `floor`, `ceil`, `round`, `isnan`, `min`, `max`, `pow` and
+ * `atan2`. Comparisons evaluate to 1 or 0.
+ *
+ * Pixels where any input is nodata, or where the result is NaN, are set to
+ * the output nodata value.
+ *
+ * ```
+ * var ndvi = gdal.calc({
+ * 	inputs: {nir: ds.bands.get(4), red: ds.bands.get(3)},
+ * 	expr: '(nir - red) / (nir + red)'
+ * });```
+ *
+ * @throws Error
+ * @method calc
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Object} options.inputs Bands keyed by the variable names used in the expression. All must be the size of the output.
+ * @param {String} options.expr
+ * @param {gdal.RasterBand} [options.output] The band to write to. If omitted, a band of the first input's size and georeferencing is created in a new in-memory dataset.
+ * @param {String} [options.type="Float64"] Data type of the created output band (see {{#crossLink "Constants (GDT)"}}GDT constants{{/crossLink}}).
+ * @param {Number} [options.nodata] Value written for nodata pixels. Defaults to the output band's nodata value, or NaN.
+ * @return {gdal.RasterBand} The output band.
+ */
+NAN_METHOD(Algorithms::calc)
+{
+	calcImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/calc:method"}}calc(){{/crossLink}}.
+ *
+ * @method calcAsync
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the output band.
+ */
+NAN_METHOD(Algorithms::calcAsync)
+{
+	calcImpl(info, true);
+}
+
+void Algorithms::calcImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> obj;
+	Local<Object> inputs_obj;
+	RasterBand* output;
+	std::string expr;
+
+	NODE_ARG_OBJECT(0, "options", obj);
+
+	NODE_STR_FROM_OBJ(obj, "expr", expr);
+	NODE_WRAPPED_FROM_OBJ(obj, "output", RasterBand, output);
+
+	Local<String> inputs_key = Nan::New("inputs").ToLocalChecked();
+	Local<Value> inputs_val = Nan::Get(obj, inputs_key).ToLocalChecked();
+	if(!inputs_val->IsObject() || inputs_val->IsNull()) {
+		Nan::ThrowTypeError("Property \"inputs\" must be an object");
+		return;
+	}
+	inputs_obj = inputs_val.As<Object>();
+
+	GDALRasterBand *output_raw = output->get();
+	int width = output_raw->GetXSize();
+	int height = output_raw->GetYSize();
+
+	std::vector<std::string> names;
+	std::vector<GDALRasterBand*> inputs;
+	std::vector<long> uids;
+	Local<Array> keys = Nan::GetOwnPropertyNames(inputs_obj).ToLocalChecked();
+	for(unsigned int i = 0; i < keys->Length(); i++) {
+		Local<Value> key = Nan::Get(keys, i).ToLocalChecked();
+		std::string name = *Nan::Utf8String(key);
+		Local<Value> val = Nan::Get(inputs_obj, key).ToLocalChecked();
+		if(!val->IsObject() || val->IsNull() || !Nan::New(RasterBand::constructor)->HasInstance(val)) {
+			Nan::ThrowTypeError(("Input \"" + name + "\" must be a RasterBand object").c_str());
+			return;
+		}
+		RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(val.As<Object>());
+		if(!band->isAlive()) {
+			Nan::ThrowError(("Input \"" + name + "\": RasterBand object has already been destroyed").c_str());
+			return;
+		}
+		if(band->get()->GetXSize() != width || band->get()->GetYSize() != height) {
+			Nan::ThrowError(("Input \"" + name + "\" must be the same size as the output band").c_str());
+			return;
+		}
+		names.push_back(name);
+		inputs.push_back(band->get());
+		uids.push_back(band->uid);
+	}
+	if(inputs.empty()) {
+		Nan::ThrowError("At least one input band is required");
+		return;
+	}
+
+	std::shared_ptr<CalcExpression> expression(new CalcExpression());
+	std::string error;
+	if(!expression->parse(expr, names, error)) {
+		Nan::ThrowError(error.c_str());
+		return;
 	}
 
-	if(papszOptions) CSLDestroy(papszOptions);
+	double nodata = std::numeric_limits<double>::quiet_NaN();
+	int has_nodata = 0;
+	double output_nodata = output_raw->GetNoDataValue(&has_nodata);
+	if(has_nodata) nodata = output_nodata;
+	NODE_DOUBLE_FROM_OBJ_OPT(obj, "nodata", nodata);
+
+	uids.push_back(output->uid);
+
+	int n_threads = numThreads();
+
+	AlgorithmWorker::Job job = [=](GDALProgressFunc progress, void *progress_arg) {
+		int block_w, block_h;
+		output_raw->GetBlockSize(&block_w, &block_h);
+		size_t n_inputs = inputs.size();
+
+		// batches of whole blocks: along the row of blocks first, then
+		// several rows of blocks once a batch spans the full width
+		GIntBig blocks = std::max<GIntBig>(1, CALC_BATCH_PIXELS / (static_cast<GIntBig>(block_w) * block_h));
+		int batch_w = static_cast<int>(std::min<GIntBig>(width, block_w * blocks));
+		GIntBig block_rows = std::max<GIntBig>(1, CALC_BATCH_PIXELS / (static_cast<GIntBig>(batch_w) * block_h));
+		int batch_h = static_cast<int>(std::min<GIntBig>(height, block_h * block_rows));
+		size_t batch_pixels = static_cast<size_t>(batch_w) * batch_h;
+		double total = static_cast<double>(width) * height;
+		double done = 0;
+
+		std::vector<int> has_input_nodata(n_inputs);
+		std::vector<double> input_nodata(n_inputs);
+		for(size_t k = 0; k < n_inputs; k++) {
+			input_nodata[k] = inputs[k]->GetNoDataValue(&has_input_nodata[k]);
+		}
+
+		std::vector<std::vector<double> > buffers(n_inputs, std::vector<double>(batch_pixels));
+		std::vector<double*> data(n_inputs);
+		for(size_t k = 0; k < n_inputs; k++) data[k] = &buffers[k][0];
+		std::vector<double> result(batch_pixels);
+
+		int max_slices = static_cast<int>(std::min<size_t>(n_threads, (batch_pixels + CALC_CHUNK_PIXELS - 1) / CALC_CHUNK_PIXELS));
+		std::vector<CalcSlice> slices(max_slices);
+		for(int t = 0; t < max_slices; t++) {
+			slices[t].expression = *expression;
+			slices[t].inputs = &data;
+			slices[t].has_input_nodata = &has_input_nodata;
+			slices[t].input_nodata = &input_nodata;
+			slices[t].nodata = nodata;
+			slices[t].result = &result[0];
+		}
+		std::vector<uv_thread_t> threads(max_slices);
+
+		for(int y = 0; y < height; y += batch_h) {
+			for(int x = 0; x < width; x += batch_w) {
+				if(progress && !progress(done / total, NULL, progress_arg)) {
+					CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+					return CE_Failure;
+				}
+
+				int w = x + batch_w > width ? width - x : batch_w;
+				int h = y + batch_h > height ? height - y : batch_h;
+				int n = w * h;
+
+				for(size_t k = 0; k < n_inputs; k++) {
+					CPLErr err = inputs[k]->RasterIO(GF_Read, x, y, w, h, data[k], w, h, GDT_Float64, 0, 0, NULL);
+					if(err) return err;
+				}
+
+				// split into slices of whole chunks. The last slice is
+				// evaluated on this thread, as is any that a thread couldn't
+				// be started for.
+				int chunks = (n + CALC_CHUNK_PIXELS - 1) / CALC_CHUNK_PIXELS;
+				int n_slices = std::min(max_slices, chunks);
+				for(int t = 0; t < n_slices; t++) {
+					slices[t].start = chunks * t / n_slices * CALC_CHUNK_PIXELS;
+					slices[t].end = std::min(n, chunks * (t + 1) / n_slices * CALC_CHUNK_PIXELS);
+				}
+				std::vector<bool> started(n_slices, false);
+				for(int t = 0; t < n_slices - 1; t++) {
+					started[t] = uv_thread_create(&threads[t], CalcSlice::run, &slices[t]) == 0;
+					if(!started[t]) CalcSlice::run(&slices[t]);
+				}
+				CalcSlice::run(&slices[n_slices - 1]);
+				for(int t = 0; t < n_slices - 1; t++) {
+					if(started[t]) uv_thread_join(&threads[t]);
+				}
+
+				CPLErr err = output_raw->RasterIO(GF_Write, x, y, w, h, &result[0], w, h, GDT_Float64, 0, 0, NULL);
+				if(err) return err;
+				done += n;
+			}
+		}
+
+		if(progress) progress(1.0, NULL, progress_arg);
+		return CE_None;
+	};
+
+	runAlgorithm(info, async, "gdal:calc", job, uids);
+}
+
+/**
+ * Computes statistics of a band's pixels under each feature of a layer.
+ *
+ * Pixels are those whose center is inside the feature's geometry (or that
+ * the geometry touches, with `allTouched`). Nodata and NaN pixels are left
+ * out. If the layer and band have different spatial references, the
+ * geometries are transformed to the band's.
+ *
+ * Features are grouped by the block of the band they start in, and the groups
+ * are split between threads that rasterize the geometries at the same time
+ * (reading the bands stays serialized). The number of threads is set by the
+ * `GDAL_NUM_THREADS` config option, as for {{#crossLink "gdal/calc:method"}}calc(){{/crossLink}}.
+ *
+ * The result has a typed array for each statistic, indexed like the `fid`
+ * array. Features without pixels get a count of 0 and NaN for the mean, min,
+ * max and stddev.
+ *
+ * ```
+ * var stats = gdal.zonalStatistics({layer: parcels, band: elevation, stats: ['mean', 'max']});
+ * for (var i = 0; i < stats.fid.length; i++) {
+ * 	console.log(stats.fid[i], stats.mean[i], stats.max[i]);
+ * }```
+ *
+ * @throws Error
+ * @method zonalStatistics
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {gdal.Layer} options.layer
+ * @param {gdal.RasterBand} options.band
+ * @param {String[]} [options.stats=["count","sum","mean","min","max","stddev"]] Any of `"count"`, `"sum"`, `"mean"`, `"min"`, `"max"`, `"stddev"` and `"histogram"`.
+ * @param {Boolean} [options.allTouched=false] Include every pixel the geometry touches.
+ * @param {gdal.RasterBand} [options.weights] A band of the same size whose values weight the sum, mean and stddev.
+ * @param {integer} [options.buckets=256] Number of histogram buckets.
+ * @param {Number[]} [options.range] `[min, max]` of the histogram. Required for `"histogram"`; values outside it aren't counted.
+ * @return {Object} `fid` (Float64Array), `count` (Uint32Array), `sum`, `mean`, `min`, `max`, `stddev` (Float64Array), and `histogram` (Uint32Array of `buckets` counts per feature).
+ */
+NAN_METHOD(Algorithms::zonalStatistics)
+{
+	zonalStatisticsImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal/zonalStatistics:method"}}zonalStatistics(){{/crossLink}}.
+ *
+ * @method zonalStatisticsAsync
+ * @static
+ * @for gdal
+ * @param {Object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the statistics.
+ */
+NAN_METHOD(Algorithms::zonalStatisticsAsync)
+{
+	zonalStatisticsImpl(info, true);
+}
 
+void Algorithms::zonalStatisticsImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> obj;
+	Layer* layer;
+	RasterBand* band;
+	RasterBand* weights = NULL;
+	int stats;
+	bool all_touched = false;
+	int buckets = 256;
+	DoubleList range("range");
+	Nan::Callback *callback = NULL;
+
+	NODE_ARG_OBJECT(0, "options", obj);
+
+	NODE_WRAPPED_FROM_OBJ(obj, "layer", Layer, layer);
+	NODE_WRAPPED_FROM_OBJ(obj, "band", RasterBand, band);
+	NODE_WRAPPED_FROM_OBJ_OPT(obj, "weights", RasterBand, weights);
+	NODE_INT_FROM_OBJ_OPT(obj, "buckets", buckets);
+
+	if(ZonalStatistics::parseStats(Nan::Get(obj, Nan::New("stats").ToLocalChecked()).ToLocalChecked(), stats)) {
+		return; //error parsing stats
+	}
+	if(Nan::HasOwnProperty(obj, Nan::New("allTouched").ToLocalChecked()).FromMaybe(false)){
+		all_touched = Nan::To<bool>(Nan::Get(obj, Nan::New("allTouched").ToLocalChecked()).ToLocalChecked()).ToChecked();
+	}
+	if(stats & ZonalStatistics::HISTOGRAM) {
+		if(range.parse(Nan::Get(obj, Nan::New("range").ToLocalChecked()).ToLocalChecked())) {
+			return; //error parsing double list
+		}
+		if(range.length() != 2 || !(range.get()[0] < range.get()[1])) {
+			Nan::ThrowError("range must be [min, max] with min < max to compute a histogram");
+			return;
+		}
+		if(buckets < 1) {
+			Nan::ThrowRangeError("buckets must be greater than 0");
+			return;
+		}
+	}
+
+	if(weights && (weights->get()->GetXSize() != band->get()->GetXSize() || weights->get()->GetYSize() != band->get()->GetYSize())) {
+		Nan::ThrowError("weights band must be the same size as the band");
+		return;
+	}
+
+	if(async) {
+		NODE_ARG_CALLBACK(2, "callback", callback);
+	}
+
+	ZonalStatistics *zonal = new ZonalStatistics(layer->get(), band->get(), weights ? weights->get() : NULL, stats, all_touched);
+	if(stats & ZonalStatistics::HISTOGRAM) {
+		zonal->setHistogram(buckets, range.get()[0], range.get()[1]);
+	}
+	zonal->setThreads(numThreads());
+
+	if(async) {
+		ZonalStatisticsWorker *worker = new ZonalStatisticsWorker(callback, zonal);
+		// keeps the layer / bands from being collected
+		worker->SaveToPersistent("options", info[0]);
+		worker->useDataset(layer->uid);
+		worker->useDataset(band->uid);
+		if(weights) worker->useDataset(weights->uid);
+		if(info[1]->IsFunction()) {
+			worker->setProgressCallback(info[1].As<Function>());
+		}
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	CPLErr err;
+	{
+		DatasetLock lock({layer->uid, band->uid, weights ? weights->uid : 0});
+		err = zonal->run(NULL, NULL);
+	}
 	if(err) {
+		delete zonal;
 		NODE_THROW_CPLERR(err);
 		return;
 	}
 
-	return;
+	info.GetReturnValue().Set(zonal->result());
+	delete zonal;
 }
 
 } //node_gdal namespace
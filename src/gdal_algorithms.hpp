@@ -34,6 +34,24 @@ namespace Algorithms {
 	NAN_METHOD(sieveFilter);
 	NAN_METHOD(checksumImage);
 	NAN_METHOD(polygonize);
+	NAN_METHOD(calc);
+	NAN_METHOD(zonalStatistics);
+
+	NAN_METHOD(fillNodataAsync);
+	NAN_METHOD(contourGenerateAsync);
+	NAN_METHOD(sieveFilterAsync);
+	NAN_METHOD(checksumImageAsync);
+	NAN_METHOD(polygonizeAsync);
+	NAN_METHOD(calcAsync);
+	NAN_METHOD(zonalStatisticsAsync);
+
+	void fillNodataImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	void contourGenerateImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	void sieveFilterImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	void checksumImageImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	void polygonizeImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	void calcImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	void zonalStatisticsImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
 }
 }
 
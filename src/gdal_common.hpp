@@ -13,10 +13,14 @@
 #pragma GCC diagnostic pop
 
 #include "utils/ptr_manager.hpp"
+#include "utils/job_pool.hpp"
 
+// Per-isolate state is thread_local: node runs each worker_threads isolate
+// on its own thread.
 namespace node_gdal {
   extern FILE *log_file;
-  extern PtrManager ptr_manager;
+  extern thread_local PtrManager ptr_manager;
+  extern thread_local JobPool job_pool;
 }
 
 #ifdef ENABLE_LOGGING
@@ -308,6 +312,15 @@ NAN_SETTER(READ_ONLY_SETTER);
   }                                                                                                           \
   var = (*Nan::Utf8String(info[num]))
 
+#define NODE_ARG_CALLBACK(num, name, var)                                                                     \
+  if (info.Length() < num + 1) {                                                                              \
+    Nan::ThrowError(name " must be given"); return;                                               \
+  }                                                                                                           \
+  if (!info[num]->IsFunction()) {                                                                             \
+    Nan::ThrowTypeError(name " must be a function"); return;                                     \
+  }                                                                                                           \
+  var = new Nan::Callback(info[num].As<Function>())
+
 // ----- optional argument conversion -------
 
 #define NODE_ARG_INT_OPT(num, name, var)                                                                         \
@@ -24,7 +24,7 @@ namespace node_gdal {
 
 class CoordinateTransformation: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
 	static Local<Value> New(OGRCoordinateTransformation *transform);
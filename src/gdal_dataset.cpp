@@ -8,13 +8,19 @@
 #include "gdal_geometry.hpp"
 #include "collections/dataset_bands.hpp"
 #include "collections/dataset_layers.hpp"
+#include "collections/dataset_pixels.hpp"
+#include "utils/async_worker.hpp"
+#include "utils/dataset_statistics.hpp"
+#include "utils/number_list.hpp"
+
+#include <vector>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Dataset::constructor;
-ObjectCache<GDALDataset, Dataset> Dataset::dataset_cache;
+thread_local Nan::Persistent<FunctionTemplate> Dataset::constructor;
+thread_local ObjectCache<GDALDataset, Dataset> Dataset::dataset_cache;
 #if GDAL_VERSION_MAJOR < 2
-ObjectCache<OGRDataSource, Dataset> Dataset::datasource_cache;
+thread_local ObjectCache<OGRDataSource, Dataset> Dataset::datasource_cache;
 #endif
 
 void Dataset::Initialize(Local<Object> target)
@@ -36,11 +42,15 @@ void Dataset::Initialize(Local<Object> target)
 	Nan::SetPrototypeMethod(lcons, "testCapability", testCapability);
 	Nan::SetPrototypeMethod(lcons, "executeSQL", executeSQL);
 	Nan::SetPrototypeMethod(lcons, "buildOverviews", buildOverviews);
+	Nan::SetPrototypeMethod(lcons, "buildOverviewsAsync", buildOverviewsAsync);
+	Nan::SetPrototypeMethod(lcons, "computeStatistics", computeStatistics);
+	Nan::SetPrototypeMethod(lcons, "computeStatisticsAsync", computeStatisticsAsync);
 
 	ATTR_DONT_ENUM(lcons, "_uid", uidGetter, READ_ONLY_SETTER);
 	ATTR(lcons, "description", descriptionGetter, READ_ONLY_SETTER);
 	ATTR(lcons, "bands", bandsGetter, READ_ONLY_SETTER);
 	ATTR(lcons, "layers", layersGetter, READ_ONLY_SETTER);
+	ATTR(lcons, "pixels", pixelsGetter, READ_ONLY_SETTER);
 	ATTR(lcons, "rasterSize", rasterSizeGetter, READ_ONLY_SETTER);
 	ATTR(lcons, "driver", driverGetter, READ_ONLY_SETTER);
 	ATTR(lcons, "srs", srsGetter, srsSetter);
@@ -149,6 +159,9 @@ NAN_METHOD(Dataset::New)
 		Local<Value> layers = DatasetLayers::New(info.This());
 		Nan::SetPrivate(info.This(), Nan::New("layers_").ToLocalChecked(), layers);
 
+		Local<Value> pixels = DatasetPixels::New(info.This());
+		Nan::SetPrivate(info.This(), Nan::New("pixels_").ToLocalChecked(), pixels);
+
 		info.GetReturnValue().Set(info.This());
 		return;
 	} else {
@@ -300,7 +313,9 @@ NAN_METHOD(Dataset::getGCPProjection)
 }
 
 /**
- * Closes the dataset to further operations.
+ * Closes the dataset to further operations. If an asynchronous operation is
+ * currently using the dataset, this blocks until it finishes; queued
+ * operations that haven't started yet will fail.
  *
  * @method close
  */
@@ -319,7 +334,8 @@ NAN_METHOD(Dataset::close)
 }
 
 /**
- * Flushes all changes to disk.
+ * Flushes all changes to disk. Releases any blocks pinned with
+ * {{#crossLink "gdal.RasterBandPixels/lockBlock:method"}}lockBlock(){{/crossLink}}.
  *
  * @throws Error
  * @method flush
@@ -337,6 +353,7 @@ NAN_METHOD(Dataset::flush)
 	#if GDAL_VERSION_MAJOR < 2
 	if (ds->uses_ogr) {
 		OGRDataSource* raw = ds->getDatasource();
+		DatasetLock lock(ds->uid);
 		OGRErr err = raw->SyncToDisk();
 		if(err) {
 			NODE_THROW_OGRERR(err);
@@ -351,6 +368,9 @@ NAN_METHOD(Dataset::flush)
 		Nan::ThrowError("Dataset object has already been destroyed");
 		return;
 	}
+	ptr_manager.releaseBlocks(ds->uid);
+
+	DatasetLock lock(ds->uid);
 	raw->FlushCache();
 
 	return;
@@ -394,6 +414,7 @@ NAN_METHOD(Dataset::executeSQL)
 	NODE_ARG_WRAPPED_OPT(1, "spatial filter geometry", Geometry, spatial_filter);
 	NODE_ARG_OPT_STR(2, "sql dialect", sql_dialect);
 
+	DatasetLock lock(ds->uid);
 	OGRLayer *layer = raw->ExecuteSQL(sql.c_str(),
 											spatial_filter ? spatial_filter->get() : NULL,
 											sql_dialect.empty() ? NULL : sql_dialect.c_str());
@@ -583,6 +604,7 @@ NAN_METHOD(Dataset::setGCPs)
 		gcp++;
 	}
 
+	DatasetLock lock(ds->uid);
 	CPLErr err = raw->SetGCPs(gcps->Length(), list, projection.c_str());
 
 	if (list) {
@@ -609,6 +631,59 @@ NAN_METHOD(Dataset::setGCPs)
  * @param {Integer[]} [bands] Note: Generation of overviews in external TIFF currently only supported when operating on all bands.
  */
 NAN_METHOD(Dataset::buildOverviews)
+{
+	buildOverviewsImpl(info, false);
+}
+
+// Builds overviews on the threadpool. If a cancelled job leaves partially
+// built levels behind on a dataset that had no overviews before, they are
+// cleared again.
+class BuildOverviewsWorker : public AsyncWorker {
+public:
+	BuildOverviewsWorker(Nan::Callback *callback, GDALDataset *ds, const std::string &resampling, std::vector<int> overviews, std::vector<int> bands)
+		: AsyncWorker(callback, "gdal:buildOverviews"), ds(ds), resampling(resampling), overviews(overviews), bands(bands) {}
+
+protected:
+	void Run() {
+		bool had_overviews = ds->GetRasterCount() > 0 && ds->GetRasterBand(1)->GetOverviewCount() > 0;
+		CPLErr err = ds->BuildOverviews(resampling.c_str(), overviews.size(), overviews.empty() ? NULL : &overviews[0], bands.size(), bands.empty() ? NULL : &bands[0], progressFunc, this);
+		if (isStopped()) {
+			if (!had_overviews) {
+				CPLPushErrorHandler(CPLQuietErrorHandler);
+				ds->BuildOverviews(resampling.c_str(), 0, NULL, 0, NULL, NULL, NULL);
+				CPLPopErrorHandler();
+			}
+		} else if (err) {
+			SetErrorFromCPL("Error building overviews");
+		}
+	}
+
+private:
+	GDALDataset *ds;
+	std::string resampling;
+	std::vector<int> overviews;
+	std::vector<int> bands;
+};
+
+/**
+ * Builds dataset overviews on a background thread.
+ *
+ * @method buildOverviewsAsync
+ * @param {String} resampling `"NEAREST"`, `"GAUSS"`, `"CUBIC"`, `"AVERAGE"`, `"MODE"`, `"AVERAGE_MAGPHASE"` or `"NONE"`
+ * @param {Integer[]} overviews
+ * @param {Object} [options]
+ * @param {Integer[]} [options.bands]
+ * @param {Function} [options.progress] Called with the fraction complete (0-1), at most every 100ms.
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted. Overviews partially built by the cancelled job are removed if the dataset had none before.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(Dataset::buildOverviewsAsync)
+{
+	buildOverviewsImpl(info, true);
+}
+
+void Dataset::buildOverviewsImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 	Dataset *ds = Nan::ObjectWrap::Unwrap<Dataset>(info.This());
@@ -634,47 +709,59 @@ NAN_METHOD(Dataset::buildOverviews)
 	NODE_ARG_ARRAY(1, "overviews", overviews);
 	NODE_ARG_ARRAY_OPT(2, "bands", bands);
 
-	int *o, *b = NULL;
-	int n_overviews = overviews->Length();
-	int i, n_bands = 0;
+	std::vector<int> o, b;
+	unsigned int i;
 
-	o = new int[n_overviews];
-	for(i = 0; i<n_overviews; i++){
+	for(i = 0; i<overviews->Length(); i++){
 		Local<Value> val = Nan::Get(overviews, i).ToLocalChecked();
 		if(!val->IsNumber()) {
-			delete [] o;
 			Nan::ThrowError("overviews array must only contain numbers");
 			return;
 		}
-		o[i] = Nan::To<int32_t>(val).ToChecked();
+		o.push_back(Nan::To<int32_t>(val).ToChecked());
 	}
 
 	if(!bands.IsEmpty()){
-		n_bands = bands->Length();
-		b = new int[n_bands];
-		for(i = 0; i<n_bands; i++){
+		for(i = 0; i<bands->Length(); i++){
 			Local<Value> val = Nan::Get(bands, i).ToLocalChecked();
 			if(!val->IsNumber()) {
-				delete [] o;
-				delete [] b;
 				Nan::ThrowError("band array must only contain numbers");
 				return;
 			}
-			b[i] = Nan::To<int32_t>(val).ToChecked();
-			if(b[i] > raw->GetRasterCount() || b[i] < 1) {
+			int band = Nan::To<int32_t>(val).ToChecked();
+			if(band > raw->GetRasterCount() || band < 1) {
 				//BuildOverviews prints an error but segfaults before returning
-				delete [] o;
-				delete [] b;
 				Nan::ThrowError("invalid band id");
 				return;
 			}
+			b.push_back(band);
 		}
 	}
 
-	CPLErr err = raw->BuildOverviews(resampling.c_str(), n_overviews, o, n_bands, b, NULL, NULL);
+	// building overviews flushes the bands
+	ptr_manager.releaseBlocks(ds->uid);
+
+	if(async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(4, "callback", callback);
+
+		BuildOverviewsWorker *worker = new BuildOverviewsWorker(callback, raw, resampling, o, b);
+		worker->SaveToPersistent("dataset", info.This());
+		worker->useDataset(ds->uid);
+		if(info[3]->IsFunction()){
+			worker->setProgressCallback(info[3].As<Function>());
+		}
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
 
-	delete [] o;
-	if(b) delete [] b;
+	CPLErr err;
+	{
+		DatasetLock lock(ds->uid);
+		err = raw->BuildOverviews(resampling.c_str(), o.size(), o.empty() ? NULL : &o[0], b.size(), b.empty() ? NULL : &b[0], NULL, NULL);
+	}
 
 	if(err) {
 		NODE_THROW_CPLERR(err);
@@ -684,6 +771,183 @@ NAN_METHOD(Dataset::buildOverviews)
 	return;
 }
 
+// Computes multi-band statistics on the threadpool
+class StatisticsWorker : public AsyncWorker {
+public:
+	StatisticsWorker(Nan::Callback *callback, DatasetStatistics *stats)
+		: AsyncWorker(callback, "gdal:computeStatistics"), stats(stats) {}
+	~StatisticsWorker() {
+		delete stats;
+	}
+
+protected:
+	void Run() {
+		if (stats->run(progressFunc, this)) {
+			SetErrorFromCPL("Error computing statistics");
+		}
+	}
+
+	Local<Value> Result() {
+		return stats->result();
+	}
+
+private:
+	DatasetStatistics *stats;
+};
+
+/**
+ * Computes statistics of several bands in a single pass over the dataset,
+ * reading each block of every band once.
+ *
+ * Returns typed arrays indexed like the `bands` array. The standard
+ * deviations and covariances are population values (divided by the pixel
+ * count). Nodata and NaN pixels are left out; the covariance matrix is
+ * computed over the pixels that are valid in every band.
+ *
+ * Percentiles are exact for Byte, Int16 and UInt16 bands. For other types
+ * they're interpolated from a 65536 bucket histogram built in a second pass.
+ *
+ * ```
+ * var stats = dataset.computeStatistics({bands: [1, 2, 3], covariance: true});
+ * var cov_1_2 = stats.covariance[0 * 3 + 1];```
+ *
+ * @throws Error
+ * @method computeStatistics
+ * @param {Object} [options]
+ * @param {Integer[]} [options.bands] Band ids. Defaults to all bands.
+ * @param {Boolean} [options.covariance=false] Compute the covariance matrix.
+ * @param {Number[]} [options.percentiles] Percentiles (0-100) to compute for each band.
+ * @param {Boolean} [options.approx=false] If `true`, the statistics may be computed from overviews.
+ * @return {Object} `bands` (Int32Array), `count`, `min`, `max`, `mean`, `stddev` (Float64Array), `covariance` (Float64Array, bands x bands, row-major) and `percentiles` (Float64Array, a row of percentiles per band).
+ */
+NAN_METHOD(Dataset::computeStatistics)
+{
+	computeStatisticsImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal.Dataset/computeStatistics:method"}}computeStatistics(){{/crossLink}}.
+ *
+ * @method computeStatisticsAsync
+ * @param {Object} [options]
+ * @param {Function} [options.progress] Called with the fraction complete (0-1), at most every 100ms.
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the statistics.
+ */
+NAN_METHOD(Dataset::computeStatisticsAsync)
+{
+	computeStatisticsImpl(info, true);
+}
+
+void Dataset::computeStatisticsImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
+{
+	Nan::HandleScope scope;
+	Dataset *ds = Nan::ObjectWrap::Unwrap<Dataset>(info.This());
+
+	if(!ds->isAlive()){
+		Nan::ThrowError("Dataset object has already been destroyed");
+		return;
+	}
+
+	#if GDAL_VERSION_MAJOR < 2
+	if (ds->uses_ogr) {
+		Nan::ThrowError("Dataset does not support computing statistics");
+		return;
+	}
+	#endif
+
+	GDALDataset* raw = ds->getDataset();
+	bool covariance = false, approx = false;
+	DoubleList percentile_list("percentiles");
+	Local<Array> band_ids;
+
+	if (info.Length() > 0 && !info[0]->IsUndefined() && !info[0]->IsNull()) {
+		Local<Object> obj;
+		NODE_ARG_OBJECT(0, "options", obj);
+		if (Nan::HasOwnProperty(obj, Nan::New("covariance").ToLocalChecked()).FromMaybe(false)) {
+			covariance = Nan::To<bool>(Nan::Get(obj, Nan::New("covariance").ToLocalChecked()).ToLocalChecked()).ToChecked();
+		}
+		if (Nan::HasOwnProperty(obj, Nan::New("approx").ToLocalChecked()).FromMaybe(false)) {
+			approx = Nan::To<bool>(Nan::Get(obj, Nan::New("approx").ToLocalChecked()).ToLocalChecked()).ToChecked();
+		}
+		if (percentile_list.parse(Nan::Get(obj, Nan::New("percentiles").ToLocalChecked()).ToLocalChecked())) {
+			return; //error parsing double list
+		}
+		Local<Value> val = Nan::Get(obj, Nan::New("bands").ToLocalChecked()).ToLocalChecked();
+		if (val->IsArray()) {
+			band_ids = val.As<Array>();
+		} else if (!val->IsUndefined() && !val->IsNull()) {
+			Nan::ThrowTypeError("bands must be an array of band ids");
+			return;
+		}
+	}
+
+	std::vector<int> ids;
+	if (!band_ids.IsEmpty()) {
+		for (unsigned int i = 0; i < band_ids->Length(); i++) {
+			Local<Value> val = Nan::Get(band_ids, i).ToLocalChecked();
+			if (!val->IsNumber()) {
+				Nan::ThrowError("band array must only contain numbers");
+				return;
+			}
+			ids.push_back(Nan::To<int32_t>(val).ToChecked());
+		}
+	} else {
+		for (int i = 1; i <= raw->GetRasterCount(); i++) ids.push_back(i);
+	}
+	if (ids.empty()) {
+		Nan::ThrowError("Dataset has no bands to compute statistics of");
+		return;
+	}
+
+	std::vector<GDALRasterBand*> bands;
+	for (unsigned int i = 0; i < ids.size(); i++) {
+		if (ids[i] < 1 || ids[i] > raw->GetRasterCount()) {
+			Nan::ThrowError("invalid band id");
+			return;
+		}
+		bands.push_back(raw->GetRasterBand(ids[i]));
+	}
+
+	std::vector<double> percentiles(percentile_list.get(), percentile_list.get() + percentile_list.length());
+	for (unsigned int i = 0; i < percentiles.size(); i++) {
+		if (!(percentiles[i] >= 0 && percentiles[i] <= 100)) {
+			Nan::ThrowRangeError("percentiles must be between 0 and 100");
+			return;
+		}
+	}
+
+	if (async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(2, "callback", callback);
+
+		StatisticsWorker *worker = new StatisticsWorker(callback, new DatasetStatistics(bands, ids, covariance, percentiles, approx));
+		worker->SaveToPersistent("dataset", info.This());
+		worker->useDataset(ds->uid);
+		if (info[1]->IsFunction()) {
+			worker->setProgressCallback(info[1].As<Function>());
+		}
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	DatasetStatistics stats(bands, ids, covariance, percentiles, approx);
+	CPLErr err;
+	{
+		DatasetLock lock(ds->uid);
+		err = stats.run(NULL, NULL);
+	}
+	if (err) {
+		NODE_THROW_CPLERR(err);
+		return;
+	}
+
+	info.GetReturnValue().Set(stats.result());
+}
+
 /**
  * @readOnly
  * @attribute description
@@ -914,6 +1178,7 @@ NAN_SETTER(Dataset::srsSetter)
 		return;
 	}
 
+	DatasetLock lock(ds->uid);
 	CPLErr err = raw->SetProjection(wkt.c_str());
 
 	if(err) {
@@ -961,6 +1226,7 @@ NAN_SETTER(Dataset::geoTransformSetter)
 		buffer[i] = Nan::To<double>(val).ToChecked();
 	}
 
+	DatasetLock lock(ds->uid);
 	CPLErr err = raw->SetGeoTransform(buffer);
 	if(err) {
 		NODE_THROW_CPLERR(err);
@@ -989,6 +1255,19 @@ NAN_GETTER(Dataset::layersGetter)
 	info.GetReturnValue().Set(Nan::GetPrivate(info.This(), Nan::New("layers_").ToLocalChecked()).ToLocalChecked());
 }
 
+/**
+ * Multi-band pixel access. See {{#crossLink "gdal.DatasetPixels"}}DatasetPixels{{/crossLink}}.
+ *
+ * @readOnly
+ * @attribute pixels
+ * @type {gdal.DatasetPixels}
+ */
+NAN_GETTER(Dataset::pixelsGetter)
+{
+	Nan::HandleScope scope;
+	info.GetReturnValue().Set(Nan::GetPrivate(info.This(), Nan::New("pixels_").ToLocalChecked()).ToLocalChecked());
+}
+
 NAN_GETTER(Dataset::uidGetter)
 {
 	Nan::HandleScope scope;
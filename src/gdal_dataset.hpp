@@ -29,7 +29,7 @@ namespace node_gdal {
 
 class Dataset: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
 	static Local<Value> New(GDALDataset *ds);
@@ -43,6 +43,9 @@ public:
 	static NAN_METHOD(executeSQL);
 	static NAN_METHOD(testCapability);
 	static NAN_METHOD(buildOverviews);
+	static NAN_METHOD(buildOverviewsAsync);
+	static NAN_METHOD(computeStatistics);
+	static NAN_METHOD(computeStatisticsAsync);
 	static NAN_METHOD(close);
 
 	static NAN_GETTER(bandsGetter);
@@ -52,12 +55,13 @@ public:
 	static NAN_GETTER(geoTransformGetter);
 	static NAN_GETTER(descriptionGetter);
 	static NAN_GETTER(layersGetter);
+	static NAN_GETTER(pixelsGetter);
 	static NAN_GETTER(uidGetter);
 
 	static NAN_SETTER(srsSetter);
 	static NAN_SETTER(geoTransformSetter);
 
-	static ObjectCache<GDALDataset, Dataset> dataset_cache;
+	static thread_local ObjectCache<GDALDataset, Dataset> dataset_cache;
 
 	Dataset(GDALDataset *ds);
 	inline GDALDataset *getDataset() {
@@ -69,7 +73,7 @@ public:
 
 	#if GDAL_VERSION_MAJOR < 2
 	static Local<Value> New(OGRDataSource *ds);
-	static ObjectCache<OGRDataSource, Dataset> datasource_cache;
+	static thread_local ObjectCache<OGRDataSource, Dataset> datasource_cache;
 	Dataset(OGRDataSource *ds);
 	inline OGRDataSource *getDatasource() {
 		return this_datasource;
@@ -85,6 +89,9 @@ public:
 	#endif
 
 private:
+	static void buildOverviewsImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+	static void computeStatisticsImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+
 	~Dataset();
 	GDALDataset   *this_dataset;
 	#if GDAL_VERSION_MAJOR < 2
@@ -6,10 +6,10 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Driver::constructor;
-ObjectCache<GDALDriver, Driver> Driver::cache;
+thread_local Nan::Persistent<FunctionTemplate> Driver::constructor;
+thread_local ObjectCache<GDALDriver, Driver> Driver::cache;
 #if GDAL_VERSION_MAJOR < 2
-ObjectCache<OGRSFDriver, Driver> Driver::cache_ogr;
+thread_local ObjectCache<OGRSFDriver, Driver> Driver::cache_ogr;
 #endif
 
 void Driver::Initialize(Local<Object> target)
@@ -22,8 +22,10 @@ void Driver::Initialize(Local<Object> target)
 
 	Nan::SetPrototypeMethod(lcons, "toString", toString);
 	Nan::SetPrototypeMethod(lcons, "open", open);
+	Nan::SetPrototypeMethod(lcons, "openAsync", openAsync);
 	Nan::SetPrototypeMethod(lcons, "create", create);
 	Nan::SetPrototypeMethod(lcons, "createCopy", createCopy);
+	Nan::SetPrototypeMethod(lcons, "createCopyAsync", createCopyAsync);
 	Nan::SetPrototypeMethod(lcons, "deleteDataset", deleteDataset);
 	Nan::SetPrototypeMethod(lcons, "rename", rename);
 	Nan::SetPrototypeMethod(lcons, "copyFiles", copyFiles);
@@ -312,6 +314,31 @@ NAN_METHOD(Driver::create)
  * @return gdal.Dataset
  */
 NAN_METHOD(Driver::createCopy)
+{
+	createCopyImpl(info, false);
+}
+
+/**
+ * Creates a copy of a dataset on a background thread. If the operation fails
+ * or is cancelled, the partially written output is removed with the driver's
+ * delete method.
+ *
+ * @method createCopyAsync
+ * @param {String} filename
+ * @param {gdal.Dataset} src
+ * @param {Object} [options]
+ * @param {String[]|object} [options.options] Driver-specific dataset creation options.
+ * @param {Function} [options.progress] Called with the fraction complete (0-1), at most every 100ms.
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the new {{#crossLink "gdal.Dataset"}}Dataset{{/crossLink}}.
+ */
+NAN_METHOD(Driver::createCopyAsync)
+{
+	createCopyImpl(info, true);
+}
+
+void Driver::createCopyImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
 {
 	Nan::HandleScope scope;
 	Driver *driver = Nan::ObjectWrap::Unwrap<Driver>(info.This());
@@ -355,6 +382,11 @@ NAN_METHOD(Driver::createCopy)
 		return;
 	}
 	if (driver->uses_ogr) {
+		if (async) {
+			Nan::ThrowError("Driver unable to copy dataset asynchronously");
+			return;
+		}
+
 		OGRSFDriver *raw = driver->getOGRSFDriver();
 		OGRDataSource *raw_ds = src_dataset->getDatasource();
 
@@ -372,7 +404,28 @@ NAN_METHOD(Driver::createCopy)
 
 	GDALDriver *raw = driver->getGDALDriver();
 	GDALDataset *raw_ds = src_dataset->getDataset();
-	GDALDataset *ds = raw->CreateCopy(filename.c_str(), raw_ds, strict, options.get(), NULL, NULL);
+
+	if (async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(4, "callback", callback);
+
+		CreateCopyWorker *worker = new CreateCopyWorker(callback, raw, filename, raw_ds, strict, options.get());
+		worker->SaveToPersistent("dataset", info[1]);
+		worker->useDataset(src_dataset->uid);
+		if(info[3]->IsFunction()){
+			worker->setProgressCallback(info[3].As<Function>());
+		}
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	GDALDataset *ds;
+	{
+		DatasetLock lock(src_dataset->uid);
+		ds = raw->CreateCopy(filename.c_str(), raw_ds, strict, options.get(), NULL, NULL);
+	}
 
 	if (!ds) {
 		Nan::ThrowError("Error copying dataset");
@@ -537,4 +590,182 @@ NAN_METHOD(Driver::open)
 	info.GetReturnValue().Set(Dataset::New(ds));
 }
 
+/**
+ * Opens a dataset on a background thread.
+ *
+ * @method openAsync
+ * @param {String} path
+ * @param {String} [mode=`"r"`] The mode to use to open the file: `"r"` or `"r+"`
+ * @param {String[]|object} [open_options] Driver-specific open options.
+ * @return {Promise} Resolves with the {{#crossLink "gdal.Dataset"}}Dataset{{/crossLink}}.
+ */
+NAN_METHOD(Driver::openAsync)
+{
+	Nan::HandleScope scope;
+	Driver *driver = Nan::ObjectWrap::Unwrap<Driver>(info.This());
+
+	std::string path;
+	std::string mode = "r";
+	GDALAccess access = GA_ReadOnly;
+	StringList open_options;
+
+	NODE_ARG_STR(0, "path", path);
+	NODE_ARG_OPT_STR(1, "mode", mode);
+
+	if (mode == "r+") {
+		access = GA_Update;
+	} else if (mode != "r") {
+		Nan::ThrowError("Invalid open mode. Must be \"r\" or \"r+\"");
+		return;
+	}
+
+	if (info.Length() > 2 && open_options.parse(info[2])) {
+		return; // error parsing string list
+	}
+
+	Nan::Callback *callback;
+	NODE_ARG_CALLBACK(3, "callback", callback);
+
+	DatasetOpenWorker *worker = new DatasetOpenWorker(callback, path, access, open_options.get(), NULL);
+	#if GDAL_VERSION_MAJOR < 2
+	if (driver->uses_ogr) {
+		worker->setDriver(driver->getOGRSFDriver());
+	} else {
+		worker->setDriver(driver->getGDALDriver());
+	}
+	#else
+	worker->setDriver(driver->getGDALDriver());
+	#endif
+	job_pool.queue(worker);
+
+	info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+}
+
+DatasetOpenWorker::DatasetOpenWorker(Nan::Callback *callback, const std::string &path, GDALAccess access, char **open_options, char **allowed_drivers)
+	: AsyncWorker(callback, "gdal:open"), path(path), access(access),
+	  open_options(CSLDuplicate(open_options)), allowed_drivers(CSLDuplicate(allowed_drivers)),
+	  driver(NULL), ds(NULL)
+	  #if GDAL_VERSION_MAJOR < 2
+	  , ogr_driver(NULL), ogr_ds(NULL)
+	  #endif
+{
+}
+
+DatasetOpenWorker::~DatasetOpenWorker()
+{
+	CSLDestroy(open_options);
+	CSLDestroy(allowed_drivers);
+	// only set if the result was never delivered, e.g. the job was cancelled
+	// after the dataset was opened
+	if (ds) {
+		GDALClose(ds);
+	}
+	#if GDAL_VERSION_MAJOR < 2
+	if (ogr_ds) {
+		OGRDataSource::DestroyDataSource(ogr_ds);
+	}
+	#endif
+}
+
+void DatasetOpenWorker::setDriver(GDALDriver *driver)
+{
+	this->driver = driver;
+}
+
+#if GDAL_VERSION_MAJOR < 2
+void DatasetOpenWorker::setDriver(OGRSFDriver *driver)
+{
+	this->ogr_driver = driver;
+}
+#endif
+
+void DatasetOpenWorker::Run()
+{
+	#if GDAL_VERSION_MAJOR < 2
+	if (ogr_driver) {
+		ogr_ds = ogr_driver->Open(path.c_str(), static_cast<int>(access));
+	} else if (driver) {
+		GDALOpenInfo open_info(path.c_str(), access);
+		ds = driver->pfnOpen(&open_info);
+	} else {
+		ogr_ds = OGRSFDriverRegistrar::Open(path.c_str(), static_cast<int>(access));
+		if (!ogr_ds) ds = (GDALDataset*) GDALOpen(path.c_str(), access);
+	}
+	if (!ds && !ogr_ds) {
+		SetErrorFromCPL("Error opening dataset");
+	}
+	#else
+	if (driver) {
+		GDALOpenInfo open_info(path.c_str(), access);
+		open_info.papszOpenOptions = open_options;
+		ds = driver->pfnOpen(&open_info);
+	} else {
+		unsigned int flags = access == GA_Update ? GDAL_OF_UPDATE : GDAL_OF_READONLY;
+		ds = (GDALDataset*) GDALOpenEx(path.c_str(), flags, allowed_drivers, open_options, NULL);
+	}
+	if (!ds) {
+		SetErrorFromCPL("Error opening dataset");
+	}
+	#endif
+}
+
+Local<Value> DatasetOpenWorker::Result()
+{
+	#if GDAL_VERSION_MAJOR < 2
+	if (ogr_ds) {
+		OGRDataSource *result = ogr_ds;
+		ogr_ds = NULL;
+		return Dataset::New(result);
+	}
+	#endif
+	GDALDataset *result = ds;
+	ds = NULL;
+	return Dataset::New(result);
+}
+
+CreateCopyWorker::CreateCopyWorker(Nan::Callback *callback, GDALDriver *driver, const std::string &filename, GDALDataset *src, unsigned int strict, char **options)
+	: AsyncWorker(callback, "gdal:createCopy"), driver(driver), filename(filename),
+	  src(src), strict(strict), options(CSLDuplicate(options)), ds(NULL)
+{
+}
+
+CreateCopyWorker::~CreateCopyWorker()
+{
+	CSLDestroy(options);
+	// only set if the result was never delivered
+	if (ds) {
+		GDALClose(ds);
+	}
+}
+
+void CreateCopyWorker::Run()
+{
+	ds = driver->CreateCopy(filename.c_str(), src, strict, options, progressFunc, this);
+	if (!ds) {
+		SetErrorFromCPL("Error copying dataset");
+		removeOutput();
+	} else if (isStopped()) {
+		GDALClose(ds);
+		ds = NULL;
+		removeOutput();
+	}
+}
+
+// Deletes whatever the driver managed to write before failing
+void CreateCopyWorker::removeOutput()
+{
+	CPLPushErrorHandler(CPLQuietErrorHandler);
+	if (driver->Delete(filename.c_str()) != CE_None) {
+		VSIUnlink(filename.c_str());
+	}
+	CPLPopErrorHandler();
+}
+
+Local<Value> CreateCopyWorker::Result()
+{
+	GDALDataset *result = ds;
+	ds = NULL;
+	return Dataset::New(result);
+}
+
 } // namespace node_gdal
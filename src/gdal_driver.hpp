@@ -18,6 +18,9 @@
 #include <ogrsf_frmts.h>
 
 #include "utils/obj_cache.hpp"
+#include "utils/async_worker.hpp"
+
+#include <string>
 
 using namespace v8;
 using namespace node;
@@ -29,20 +32,22 @@ namespace node_gdal {
 
 class Driver: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
 	static Local<Value> New(GDALDriver *driver);
 	static NAN_METHOD(toString);
 	static NAN_METHOD(open);
+	static NAN_METHOD(openAsync);
 	static NAN_METHOD(create);
 	static NAN_METHOD(createCopy);
+	static NAN_METHOD(createCopyAsync);
 	static NAN_METHOD(deleteDataset);
 	static NAN_METHOD(rename);
 	static NAN_METHOD(copyFiles);
 	static NAN_METHOD(getMetadata);
 
-	static ObjectCache<GDALDriver, Driver>  cache;
+	static thread_local ObjectCache<GDALDriver, Driver>  cache;
 
 	static NAN_GETTER(descriptionGetter);
 
@@ -56,7 +61,7 @@ public:
 	#if GDAL_VERSION_MAJOR < 2
 	static Local<Value> New(OGRSFDriver *driver);
 
-	static ObjectCache<OGRSFDriver, Driver> cache_ogr;
+	static thread_local ObjectCache<OGRSFDriver, Driver> cache_ogr;
 
 	Driver(OGRSFDriver *driver);
 	
@@ -74,6 +79,8 @@ public:
 	#endif
 
 private:
+	static void createCopyImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+
 	~Driver();
 	GDALDriver *this_gdaldriver;
 	#if GDAL_VERSION_MAJOR < 2
@@ -81,5 +88,58 @@ private:
 	#endif
 };
 
+// Opens a dataset on the threadpool, wrapping it with Dataset::New once back
+// on the main thread. If no driver is given, GDALOpenEx probes all of them.
+
+class DatasetOpenWorker : public AsyncWorker {
+public:
+	DatasetOpenWorker(Nan::Callback *callback, const std::string &path, GDALAccess access, char **open_options, char **allowed_drivers);
+	~DatasetOpenWorker();
+
+	void setDriver(GDALDriver *driver);
+	#if GDAL_VERSION_MAJOR < 2
+	void setDriver(OGRSFDriver *driver);
+	#endif
+
+protected:
+	void Run();
+	Local<Value> Result();
+
+private:
+	std::string path;
+	GDALAccess access;
+	char **open_options;
+	char **allowed_drivers;
+	GDALDriver *driver;
+	GDALDataset *ds;
+	#if GDAL_VERSION_MAJOR < 2
+	OGRSFDriver *ogr_driver;
+	OGRDataSource *ogr_ds;
+	#endif
+};
+
+// Copies a dataset on the threadpool with GDALDriver::CreateCopy. Output
+// left behind by a failed or cancelled copy is removed.
+
+class CreateCopyWorker : public AsyncWorker {
+public:
+	CreateCopyWorker(Nan::Callback *callback, GDALDriver *driver, const std::string &filename, GDALDataset *src, unsigned int strict, char **options);
+	~CreateCopyWorker();
+
+protected:
+	void Run();
+	Local<Value> Result();
+
+private:
+	void removeOutput();
+
+	GDALDriver *driver;
+	std::string filename;
+	GDALDataset *src;
+	unsigned int strict;
+	char **options;
+	GDALDataset *ds;
+};
+
 }
 #endif
@@ -6,7 +6,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> FeatureDefn::constructor;
+thread_local Nan::Persistent<FunctionTemplate> FeatureDefn::constructor;
 
 void FeatureDefn::Initialize(Local<Object> target)
 {
@@ -5,7 +5,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> FieldDefn::constructor;
+thread_local Nan::Persistent<FunctionTemplate> FieldDefn::constructor;
 
 void FieldDefn::Initialize(Local<Object> target)
 {
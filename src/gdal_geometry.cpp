@@ -19,7 +19,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Geometry::constructor;
+thread_local Nan::Persistent<FunctionTemplate> Geometry::constructor;
 
 void Geometry::Initialize(Local<Object> target)
 {
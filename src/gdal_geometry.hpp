@@ -23,7 +23,7 @@ class Geometry: public Nan::ObjectWrap {
 	friend class Feature;
 
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
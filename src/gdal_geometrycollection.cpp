@@ -8,7 +8,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> GeometryCollection::constructor;
+thread_local Nan::Persistent<FunctionTemplate> GeometryCollection::constructor;
 
 void GeometryCollection::Initialize(Local<Object> target)
 {
@@ -15,8 +15,8 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> Layer::constructor;
-ObjectCache<OGRLayer, Layer> Layer::cache;
+thread_local Nan::Persistent<FunctionTemplate> Layer::constructor;
+thread_local ObjectCache<OGRLayer, Layer> Layer::cache;
 
 void Layer::Initialize(Local<Object> target)
 {
@@ -189,6 +189,7 @@ NAN_METHOD(Layer::toString)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	std::ostringstream ss;
 	ss << "Layer (" << layer->this_->GetName() << ")";
 
@@ -201,7 +202,24 @@ NAN_METHOD(Layer::toString)
  * @throws Error
  * @method flush
  */
-NODE_WRAPPED_METHOD_WITH_OGRERR_RESULT(Layer, syncToDisk, SyncToDisk);
+NAN_METHOD(Layer::syncToDisk)
+{
+	Nan::HandleScope scope;
+
+	Layer *layer = Nan::ObjectWrap::Unwrap<Layer>(info.This());
+	if (!layer->isAlive()) {
+		Nan::ThrowError("Layer object has already been destroyed");
+		return;
+	}
+
+	DatasetLock lock(layer->uid);
+	int err = layer->this_->SyncToDisk();
+	if (err) {
+		NODE_THROW_OGRERR(err);
+		return;
+	}
+	return;
+}
 
 /**
  * Determines if the dataset supports the indicated operation.
@@ -210,7 +228,22 @@ NODE_WRAPPED_METHOD_WITH_OGRERR_RESULT(Layer, syncToDisk, SyncToDisk);
  * @param {string} capability (see {{#crossLink "Constants (OLC)"}}capability list{{/crossLink}})
  * @return {Boolean}
  */
-NODE_WRAPPED_METHOD_WITH_RESULT_1_STRING_PARAM(Layer, testCapability, Boolean, TestCapability, "capability");
+NAN_METHOD(Layer::testCapability)
+{
+	Nan::HandleScope scope;
+
+	std::string capability;
+	NODE_ARG_STR(0, "capability", capability);
+
+	Layer *layer = Nan::ObjectWrap::Unwrap<Layer>(info.This());
+	if (!layer->isAlive()) {
+		Nan::ThrowError("Layer object has already been destroyed");
+		return;
+	}
+
+	DatasetLock lock(layer->uid);
+	info.GetReturnValue().Set(Nan::New<Boolean>(layer->this_->TestCapability(capability.c_str())));
+}
 
 /**
  * Fetch the extent of this layer.
@@ -234,8 +267,13 @@ NAN_METHOD(Layer::getExtent)
 	NODE_ARG_BOOL_OPT(0, "force", force);
 
 	OGREnvelope *envelope = new OGREnvelope();
-	OGRErr err = layer->this_->GetExtent(envelope, force);
+	OGRErr err;
+	{
+		DatasetLock lock(layer->uid);
+		err = layer->this_->GetExtent(envelope, force);
+	}
 	if(err) {
+		delete envelope;
 		Nan::ThrowError("Can't get layer extent without computing it");
 		return;
 	}
@@ -268,6 +306,7 @@ NAN_METHOD(Layer::getSpatialFilter)
 		return;
 	}
 
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(Geometry::New(layer->this_->GetSpatialFilter(), false));
 }
 
@@ -301,6 +340,7 @@ NAN_METHOD(Layer::setSpatialFilter)
 		Geometry *filter = NULL;
 		NODE_ARG_WRAPPED_OPT(0, "filter", Geometry, filter);
 
+		DatasetLock lock(layer->uid);
 		if(filter) {
 			layer->this_->SetSpatialFilter(filter->get());
 		} else {
@@ -313,6 +353,7 @@ NAN_METHOD(Layer::setSpatialFilter)
 		NODE_ARG_DOUBLE(2, "maxX", maxX);
 		NODE_ARG_DOUBLE(3, "maxY", maxY);
 
+		DatasetLock lock(layer->uid);
 		layer->this_->SetSpatialFilterRect(minX, minY, maxX, maxY);
 	} else {
 		Nan::ThrowError("Invalid number of arguments");
@@ -357,6 +398,7 @@ NAN_METHOD(Layer::setAttributeFilter)
 	std::string filter = "";
 	NODE_ARG_OPT_STR(0, "filter", filter);
 
+	DatasetLock lock(layer->uid);
 	OGRErr err;
 	if(filter.empty()){
 		err = layer->this_->SetAttributeFilter(NULL);
@@ -411,6 +453,7 @@ NAN_GETTER(Layer::srsGetter)
 		Nan::ThrowError("Layer object has already been destroyed");
 		return;
 	}
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(SpatialReference::New(layer->this_->GetSpatialRef(), false));
 }
 
@@ -427,6 +470,7 @@ NAN_GETTER(Layer::nameGetter)
 		Nan::ThrowError("Layer object has already been destroyed");
 		return;
 	}
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(SafeString::New(layer->this_->GetName()));
 }
 
@@ -443,6 +487,7 @@ NAN_GETTER(Layer::geomColumnGetter)
 		Nan::ThrowError("Layer object has already been destroyed");
 		return;
 	}
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(SafeString::New(layer->this_->GetGeometryColumn()));
 }
 
@@ -459,6 +504,7 @@ NAN_GETTER(Layer::fidColumnGetter)
 		Nan::ThrowError("Layer object has already been destroyed");
 		return;
 	}
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(SafeString::New(layer->this_->GetFIDColumn()));
 }
 
@@ -475,6 +521,7 @@ NAN_GETTER(Layer::geomTypeGetter)
 		Nan::ThrowError("Layer object has already been destroyed");
 		return;
 	}
+	DatasetLock lock(layer->uid);
 	info.GetReturnValue().Set(Nan::New<Integer>(layer->this_->GetGeomType()));
 }
 
@@ -24,7 +24,7 @@ namespace node_gdal {
 
 class Layer: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
 	#if GDAL_VERSION_MAJOR >= 2
@@ -53,7 +53,7 @@ public:
 	static NAN_GETTER(geomTypeGetter);
 	static NAN_GETTER(uidGetter);
 
-	static ObjectCache<OGRLayer, Layer> cache;
+	static thread_local ObjectCache<OGRLayer, Layer> cache;
 
 	Layer();
 	Layer(OGRLayer *ds);
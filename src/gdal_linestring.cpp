@@ -9,7 +9,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> LineString::constructor;
+thread_local Nan::Persistent<FunctionTemplate> LineString::constructor;
 
 void LineString::Initialize(Local<Object> target)
 {
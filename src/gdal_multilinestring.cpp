@@ -10,7 +10,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> MultiLineString::constructor;
+thread_local Nan::Persistent<FunctionTemplate> MultiLineString::constructor;
 
 void MultiLineString::Initialize(Local<Object> target)
 {
@@ -10,7 +10,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> MultiPoint::constructor;
+thread_local Nan::Persistent<FunctionTemplate> MultiPoint::constructor;
 
 void MultiPoint::Initialize(Local<Object> target)
 {
@@ -9,7 +9,7 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> MultiPolygon::constructor;
+thread_local Nan::Persistent<FunctionTemplate> MultiPolygon::constructor;
 
 void MultiPolygon::Initialize(Local<Object> target)
 {
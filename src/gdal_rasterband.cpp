@@ -6,14 +6,22 @@
 #include "gdal_dataset.hpp"
 #include "collections/rasterband_overviews.hpp"
 #include "collections/rasterband_pixels.hpp"
-
+#include "gdal_spatial_reference.hpp"
+#include "gdal_linestring.hpp"
+#include "utils/point_sampler.hpp"
+#include "utils/async_worker.hpp"
+#include "utils/number_list.hpp"
+#include "utils/typed_array.hpp"
+
+#include <cmath>
 #include <limits>
+#include <vector>
 #include <cpl_port.h>
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> RasterBand::constructor;
-ObjectCache<GDALRasterBand, RasterBand> RasterBand::cache;
+thread_local Nan::Persistent<FunctionTemplate> RasterBand::constructor;
+thread_local ObjectCache<GDALRasterBand, RasterBand> RasterBand::cache;
 
 void RasterBand::Initialize(Local<Object> target)
 {
@@ -33,15 +41,18 @@ void RasterBand::Initialize(Local<Object> target)
 	Nan::SetPrototypeMethod(lcons, "getMaskFlags", getMaskFlags);
 	Nan::SetPrototypeMethod(lcons, "createMaskBand", createMaskBand);
 	Nan::SetPrototypeMethod(lcons, "getMetadata", getMetadata);
+	Nan::SetPrototypeMethod(lcons, "sampleAt", sampleAt);
+	Nan::SetPrototypeMethod(lcons, "profile", profile);
+	Nan::SetPrototypeMethod(lcons, "getHistogram", getHistogram);
+	Nan::SetPrototypeMethod(lcons, "getHistogramAsync", getHistogramAsync);
+	Nan::SetPrototypeMethod(lcons, "getDefaultHistogram", getDefaultHistogram);
+	Nan::SetPrototypeMethod(lcons, "setDefaultHistogram", setDefaultHistogram);
 
 	// unimplemented methods
 	//Nan::SetPrototypeMethod(lcons, "buildOverviews", buildOverviews);
 	//Nan::SetPrototypeMethod(lcons, "rasterIO", rasterIO);
 	//Nan::SetPrototypeMethod(lcons, "getColorTable", getColorTable);
 	//Nan::SetPrototypeMethod(lcons, "setColorTable", setColorTable);
-	//Nan::SetPrototypeMethod(lcons, "getHistogram", getHistogram);
-	//Nan::SetPrototypeMethod(lcons, "getDefaultHistogram", getDefaultHistogram);
-	//Nan::SetPrototypeMethod(lcons, "setDefaultHistogram", setDefaultHistogram);
 
 	ATTR_DONT_ENUM(lcons, "ds", dsGetter, READ_ONLY_SETTER);
 	ATTR_DONT_ENUM(lcons, "_uid", uidGetter, READ_ONLY_SETTER);
@@ -177,11 +188,25 @@ NAN_METHOD(RasterBand::toString)
 }
 
 /**
- * Saves changes to disk.
+ * Saves changes to disk. Releases any blocks of the band pinned with
+ * {{#crossLink "gdal.RasterBandPixels/lockBlock:method"}}lockBlock(){{/crossLink}}.
  *
  * @method flush
  */
-NODE_WRAPPED_METHOD(RasterBand, flush, FlushCache);
+NAN_METHOD(RasterBand::flush)
+{
+	Nan::HandleScope scope;
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+	ptr_manager.releaseBlocks(band->uid, band->get());
+
+	DatasetLock lock(band->uid);
+	band->get()->FlushCache();
+	return;
+}
 
 /**
  * Return the status flags of the mask band associated with the band.
@@ -208,7 +233,26 @@ NODE_WRAPPED_METHOD_WITH_RESULT(RasterBand, getMaskFlags, Integer, GetMaskFlags)
  * @method createMaskBand
  * @param {Integer} flags Mask flags
  */
-NODE_WRAPPED_METHOD_WITH_CPLERR_RESULT_1_INTEGER_PARAM(RasterBand, createMaskBand, CreateMaskBand, "mask flags");
+NAN_METHOD(RasterBand::createMaskBand)
+{
+	Nan::HandleScope scope;
+	int flags;
+	NODE_ARG_INT(0, "mask flags", flags);
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	DatasetLock lock(band->uid);
+	int err = band->this_->CreateMaskBand(flags);
+	if (err) {
+		NODE_THROW_CPLERR(err);
+		return;
+	}
+	return;
+}
 // TODO: expose GMF constants in API
 // ({{#crossLink "Constants (GMF)"}}see flags{{/crossLink}})
 
@@ -228,7 +272,11 @@ NAN_METHOD(RasterBand::getMaskBand)
 		return;
 	}
 
-	GDALRasterBand *mask_band = band->this_->GetMaskBand();
+	GDALRasterBand *mask_band;
+	{
+		DatasetLock lock(band->uid);
+		mask_band = band->this_->GetMaskBand();
+	}
 
 	if(!mask_band) {
 		info.GetReturnValue().Set(Nan::Null());
@@ -259,6 +307,7 @@ NAN_METHOD(RasterBand::fill)
 		return;
 	}
 
+	DatasetLock lock(band->uid);
 	int err = band->this_->Fill(real, imaginary);
 
 	if (err) {
@@ -317,9 +366,13 @@ NAN_METHOD(RasterBand::getStatistics)
 		return;
 	}
 
-	pushStatsErrorHandler();
-	CPLErr err = band->this_->GetStatistics(approx, force, &min, &max, &mean, &std_dev);
-	popStatsErrorHandler();
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		pushStatsErrorHandler();
+		err = band->this_->GetStatistics(approx, force, &min, &max, &mean, &std_dev);
+		popStatsErrorHandler();
+	}
 	if (!stats_file_err.empty()){
 		Nan::ThrowError(stats_file_err.c_str());
 	} else if (err) {
@@ -366,9 +419,13 @@ NAN_METHOD(RasterBand::computeStatistics)
 		return;
 	}
 
-	pushStatsErrorHandler();
-	CPLErr err = band->this_->ComputeStatistics(approx, &min, &max, &mean, &std_dev, NULL, NULL);
-	popStatsErrorHandler();
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		pushStatsErrorHandler();
+		err = band->this_->ComputeStatistics(approx, &min, &max, &mean, &std_dev, NULL, NULL);
+		popStatsErrorHandler();
+	}
 	if (!stats_file_err.empty()){
 		Nan::ThrowError(stats_file_err.c_str());
 	} else if (err) {
@@ -412,6 +469,7 @@ NAN_METHOD(RasterBand::setStatistics)
 		return;
 	}
 
+	DatasetLock lock(band->uid);
 	CPLErr err = band->this_->SetStatistics(min, max, mean, std_dev);
 
 	if (err) {
@@ -421,6 +479,319 @@ NAN_METHOD(RasterBand::setStatistics)
 	return;
 }
 
+// Picks a histogram range spanning the band's values, with half a bucket of
+// margin on each side so the extremes fall in the middle of the first and
+// last buckets (the same default range GDAL uses).
+static CPLErr histogramRange(GDALRasterBand *band, int buckets, bool approx, double &min, double &max)
+{
+	const char *pixel_type = band->GetMetadataItem("PIXELTYPE", "IMAGE_STRUCTURE");
+	if (band->GetRasterDataType() == GDT_Byte && !(pixel_type && EQUAL(pixel_type, "SIGNEDBYTE"))) {
+		min = -0.5;
+		max = 255.5;
+		return CE_None;
+	}
+
+	double minmax[2];
+	CPLErr err = band->ComputeRasterMinMax(approx, minmax);
+	if (err) return err;
+	double half_bucket = buckets > 1 ? (minmax[1] - minmax[0]) / (2 * (buckets - 1)) : 0;
+	if (half_bucket == 0) half_bucket = 0.5;
+	min = minmax[0] - half_bucket;
+	max = minmax[1] + half_bucket;
+	return CE_None;
+}
+
+static CPLErr computeHistogram(GDALRasterBand *band, bool has_range, double min, double max, int buckets, bool include_out_of_range, bool approx, std::vector<GUIntBig> &counts, GDALProgressFunc progress, void *progress_arg)
+{
+	if (!has_range) {
+		CPLErr err = histogramRange(band, buckets, approx, min, max);
+		if (err) return err;
+	}
+	counts.assign(buckets, 0);
+	return band->GetHistogram(min, max, buckets, &counts[0], include_out_of_range, approx, progress, progress_arg);
+}
+
+// Creates a Uint32Array of the counts, or a Float64Array if any of them
+// doesn't fit in 32 bits
+static Local<Value> histogramToArray(const GUIntBig *counts, int buckets)
+{
+	Nan::EscapableHandleScope scope;
+
+	bool wide = false;
+	for (int i = 0; i < buckets; i++) {
+		if (counts[i] > 0xFFFFFFFFu) wide = true;
+	}
+
+	Local<Value> array = TypedArray::New(wide ? GDT_Float64 : GDT_UInt32, buckets);
+	if (array.IsEmpty() || !array->IsObject()) {
+		return scope.Escape(array); //TypedArray::New threw an error
+	}
+	if (wide) {
+		Nan::TypedArrayContents<double> data(array);
+		for (int i = 0; i < buckets; i++) (*data)[i] = static_cast<double>(counts[i]);
+	} else {
+		Nan::TypedArrayContents<uint32_t> data(array);
+		for (int i = 0; i < buckets; i++) (*data)[i] = static_cast<uint32_t>(counts[i]);
+	}
+	return scope.Escape(array);
+}
+
+// Computes a histogram on the threadpool
+class HistogramWorker : public AsyncWorker {
+public:
+	HistogramWorker(Nan::Callback *callback, GDALRasterBand *band, bool has_range, double min, double max, int buckets, bool include_out_of_range, bool approx)
+		: AsyncWorker(callback, "gdal:getHistogram"), band(band), has_range(has_range), min(min), max(max), buckets(buckets),
+		  include_out_of_range(include_out_of_range), approx(approx) {}
+
+protected:
+	void Run() {
+		if (computeHistogram(band, has_range, min, max, buckets, include_out_of_range, approx, counts, progressFunc, this)) {
+			SetErrorFromCPL("Error computing histogram");
+		}
+	}
+
+	Local<Value> Result() {
+		return histogramToArray(&counts[0], buckets);
+	}
+
+private:
+	GDALRasterBand *band;
+	bool has_range;
+	double min, max;
+	int buckets;
+	bool include_out_of_range, approx;
+	std::vector<GUIntBig> counts;
+};
+
+/**
+ * Computes a histogram of the band's values.
+ *
+ * Bucket `i` counts the values from `min + i * (max - min) / buckets` up to
+ * the start of the next bucket. Without a `range`, Byte bands use
+ * `[-0.5, 255.5]` and other bands a range half a bucket wider than their
+ * minimum and maximum values. Nodata values aren't counted.
+ *
+ * ```
+ * var counts = band.getHistogram({buckets: 10, range: [0, 1000]});```
+ *
+ * @throws Error
+ * @method getHistogram
+ * @param {Object} [options]
+ * @param {integer} [options.buckets=256]
+ * @param {Number[]} [options.range] `[min, max]`
+ * @param {Boolean} [options.approx=false] If `true`, the histogram may be computed from overviews or a subset of the blocks.
+ * @param {Boolean} [options.includeOutOfRange=false] If `true`, values below or above the range are counted in the first or last bucket.
+ * @return {Uint32Array} The counts. A Float64Array is returned instead if a count doesn't fit in 32 bits.
+ */
+NAN_METHOD(RasterBand::getHistogram)
+{
+	getHistogramImpl(info, false);
+}
+
+/**
+ * Asynchronous version of {{#crossLink "gdal.RasterBand/getHistogram:method"}}getHistogram(){{/crossLink}}.
+ *
+ * @method getHistogramAsync
+ * @param {Object} [options]
+ * @param {Function} [options.progress] Called with the fraction complete (0-1).
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise} Resolves with the counts.
+ */
+NAN_METHOD(RasterBand::getHistogramAsync)
+{
+	getHistogramImpl(info, true);
+}
+
+void RasterBand::getHistogramImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async)
+{
+	Nan::HandleScope scope;
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	int buckets = 256;
+	bool approx = false, include_out_of_range = false;
+	DoubleList range("range");
+
+	if (info.Length() > 0 && !info[0]->IsUndefined() && !info[0]->IsNull()) {
+		Local<Object> obj;
+		NODE_ARG_OBJECT(0, "options", obj);
+		NODE_INT_FROM_OBJ_OPT(obj, "buckets", buckets);
+		if (range.parse(Nan::Get(obj, Nan::New("range").ToLocalChecked()).ToLocalChecked())) {
+			return; //error parsing double list
+		}
+		if (Nan::HasOwnProperty(obj, Nan::New("approx").ToLocalChecked()).FromMaybe(false)) {
+			approx = Nan::To<bool>(Nan::Get(obj, Nan::New("approx").ToLocalChecked()).ToLocalChecked()).ToChecked();
+		}
+		if (Nan::HasOwnProperty(obj, Nan::New("includeOutOfRange").ToLocalChecked()).FromMaybe(false)) {
+			include_out_of_range = Nan::To<bool>(Nan::Get(obj, Nan::New("includeOutOfRange").ToLocalChecked()).ToLocalChecked()).ToChecked();
+		}
+	}
+
+	if (buckets < 1) {
+		Nan::ThrowRangeError("buckets must be greater than 0");
+		return;
+	}
+	bool has_range = range.length() > 0;
+	if (has_range && (range.length() != 2 || !(range.get()[0] < range.get()[1]))) {
+		Nan::ThrowError("range must be [min, max] with min < max");
+		return;
+	}
+	double min = has_range ? range.get()[0] : 0;
+	double max = has_range ? range.get()[1] : 0;
+
+	if (async) {
+		Nan::Callback *callback;
+		NODE_ARG_CALLBACK(2, "callback", callback);
+
+		HistogramWorker *worker = new HistogramWorker(callback, band->this_, has_range, min, max, buckets, include_out_of_range, approx);
+		worker->SaveToPersistent("band", info.This());
+		worker->useDataset(band->uid);
+		if (info[1]->IsFunction()) {
+			worker->setProgressCallback(info[1].As<Function>());
+		}
+		job_pool.queue(worker);
+
+		info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+		return;
+	}
+
+	std::vector<GUIntBig> counts;
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		err = computeHistogram(band->this_, has_range, min, max, buckets, include_out_of_range, approx, counts, NULL, NULL);
+	}
+	if (err) {
+		NODE_THROW_LAST_CPLERR();
+		return;
+	}
+
+	info.GetReturnValue().Set(histogramToArray(&counts[0], buckets));
+}
+
+/**
+ * Fetches the default histogram: the one stored with the band, if any, or
+ * else one computed over 256 buckets spanning the band's values.
+ *
+ * @throws Error
+ * @method getDefaultHistogram
+ * @param {Object} [options]
+ * @param {Boolean} [options.force=true] If `false`, returns `null` instead of computing a histogram when none is stored.
+ * @return {Object} `{min, max, histogram}`, where `histogram` is a Uint32Array (or a Float64Array if a count doesn't fit in 32 bits).
+ */
+NAN_METHOD(RasterBand::getDefaultHistogram)
+{
+	Nan::HandleScope scope;
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	bool force = true;
+	if (info.Length() > 0 && !info[0]->IsUndefined() && !info[0]->IsNull()) {
+		Local<Object> obj;
+		NODE_ARG_OBJECT(0, "options", obj);
+		if (Nan::HasOwnProperty(obj, Nan::New("force").ToLocalChecked()).FromMaybe(false)) {
+			force = Nan::To<bool>(Nan::Get(obj, Nan::New("force").ToLocalChecked()).ToLocalChecked()).ToChecked();
+		}
+	}
+
+	double min = 0, max = 0;
+	int buckets = 0;
+	GUIntBig *counts = NULL;
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		err = band->this_->GetDefaultHistogram(&min, &max, &buckets, &counts, force, NULL, NULL);
+	}
+	if (err == CE_Warning) {
+		CPLFree(counts);
+		info.GetReturnValue().Set(Nan::Null());
+		return;
+	}
+	if (err) {
+		CPLFree(counts);
+		NODE_THROW_LAST_CPLERR();
+		return;
+	}
+
+	Local<Value> histogram = histogramToArray(counts, buckets);
+	CPLFree(counts);
+	if (histogram.IsEmpty() || !histogram->IsObject()) {
+		return; //TypedArray::New threw an error
+	}
+
+	Local<Object> result = Nan::New<Object>();
+	Nan::Set(result, Nan::New("min").ToLocalChecked(), Nan::New<Number>(min));
+	Nan::Set(result, Nan::New("max").ToLocalChecked(), Nan::New<Number>(max));
+	Nan::Set(result, Nan::New("histogram").ToLocalChecked(), histogram);
+	info.GetReturnValue().Set(result);
+}
+
+/**
+ * Stores a default histogram with the band (in formats that support it,
+ * or an .aux.xml file).
+ *
+ * @throws Error
+ * @method setDefaultHistogram
+ * @param {Number} min
+ * @param {Number} max
+ * @param {Uint32Array|Number[]} histogram The count of each bucket.
+ */
+NAN_METHOD(RasterBand::setDefaultHistogram)
+{
+	Nan::HandleScope scope;
+
+	double min, max;
+	NODE_ARG_DOUBLE(0, "min", min);
+	NODE_ARG_DOUBLE(1, "max", max);
+	if (info.Length() < 3 || !info[2]->IsObject() || info[2]->IsNull()) {
+		Nan::ThrowTypeError("histogram must be an array of counts");
+		return;
+	}
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	Local<Object> histogram = info[2].As<Object>();
+	Local<Value> length = Nan::Get(histogram, Nan::New("length").ToLocalChecked()).ToLocalChecked();
+	if (!length->IsNumber() || Nan::To<int32_t>(length).ToChecked() < 1) {
+		Nan::ThrowTypeError("histogram must be an array of counts");
+		return;
+	}
+
+	int buckets = Nan::To<int32_t>(length).ToChecked();
+	std::vector<GUIntBig> counts(buckets);
+	for (int i = 0; i < buckets; i++) {
+		Local<Value> val = Nan::Get(histogram, i).ToLocalChecked();
+		if (!val->IsNumber() || Nan::To<double>(val).ToChecked() < 0) {
+			Nan::ThrowTypeError("histogram counts must be non-negative numbers");
+			return;
+		}
+		counts[i] = static_cast<GUIntBig>(Nan::To<double>(val).ToChecked());
+	}
+
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		err = band->this_->SetDefaultHistogram(min, max, buckets, &counts[0]);
+	}
+	if (err) {
+		NODE_THROW_LAST_CPLERR();
+		return;
+	}
+}
+
 /**
  * Returns band metadata
  *
@@ -443,6 +814,238 @@ NAN_METHOD(RasterBand::getMetadata)
 	info.GetReturnValue().Set(MajorObject::getMetadata(band->this_, domain.empty() ? NULL : domain.c_str()));
 }
 
+/**
+ * Samples the band at many georeferenced points at once. The points are
+ * transformed to the dataset's spatial reference in a single call, and read
+ * grouped by block so each block is only read once.
+ *
+ * ```
+ * // elevation at two lon/lat points
+ * var values = band.sampleAt(new Float64Array([-122.4, 37.8, -122.3, 37.7]), {
+ *   srs: gdal.SpatialReference.fromEPSG(4326),
+ *   interpolation: 'bilinear'
+ * });```
+ *
+ * @method sampleAt
+ * @throws Error
+ * @param {Float64Array} coords Interleaved `x, y` coordinates.
+ * @param {Object} [options]
+ * @param {gdal.SpatialReference} [options.srs] Spatial reference of the coordinates. Defaults to the dataset's.
+ * @param {String} [options.interpolation="nearest"] `"nearest"`, `"bilinear"` or `"cubic"`. Nodata pixels are left out of the interpolation.
+ * @param {Number} [options.nodataValue=NaN] Value returned for points outside of the raster or on nodata pixels.
+ * @return {Float64Array} One value per point.
+ */
+NAN_METHOD(RasterBand::sampleAt)
+{
+	Nan::HandleScope scope;
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	Local<Object> coords_obj;
+	NODE_ARG_OBJECT(0, "coords", coords_obj);
+	if (!coords_obj->IsFloat64Array()) {
+		Nan::ThrowTypeError("coords must be a Float64Array");
+		return;
+	}
+	Nan::TypedArrayContents<double> coords(coords_obj);
+	if (coords.length() % 2) {
+		Nan::ThrowError("coords must hold an x and y value for each point");
+		return;
+	}
+	int n = coords.length() / 2;
+
+	SpatialReference *srs = NULL;
+	PointSampler::Interpolation interpolation = PointSampler::NEAREST;
+	double nodata = std::numeric_limits<double>::quiet_NaN();
+
+	if (info.Length() > 1 && !info[1]->IsUndefined() && !info[1]->IsNull()) {
+		Local<Object> obj;
+		NODE_ARG_OBJECT(1, "options", obj);
+		NODE_WRAPPED_FROM_OBJ_OPT(obj, "srs", SpatialReference, srs);
+		NODE_DOUBLE_FROM_OBJ_OPT(obj, "nodataValue", nodata);
+		if (PointSampler::parseInterpolation(Nan::Get(obj, Nan::New("interpolation").ToLocalChecked()).ToLocalChecked(), interpolation)) {
+			return; //parseInterpolation threw an error
+		}
+	}
+
+	Local<Value> array = TypedArray::New(GDT_Float64, n);
+	if (array.IsEmpty() || !array->IsObject()) {
+		return; //TypedArray::New threw an error
+	}
+	Nan::TypedArrayContents<double> values(array);
+
+	std::vector<double> x(n), y(n);
+	for (int i = 0; i < n; i++) {
+		x[i] = (*coords)[i * 2];
+		y[i] = (*coords)[i * 2 + 1];
+	}
+
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		err = PointSampler::toPixel(band->parent_ds, srs ? srs->get() : NULL, n, x.data(), y.data());
+		if (!err) {
+			PointSampler sampler(band->this_, interpolation, nodata);
+			err = sampler.sample(n, x.data(), y.data(), *values);
+		}
+	}
+	if (err) {
+		NODE_THROW_LAST_CPLERR();
+		return;
+	}
+
+	info.GetReturnValue().Set(array);
+}
+
+/**
+ * Samples the band along a line, e.g. for a terrain profile. The line's
+ * vertices are transformed to the dataset's spatial reference, and points
+ * are placed every `step` units along it (always including both ends). All
+ * points are then sampled in one pass, reading each block only once even if
+ * the line crosses it several times.
+ *
+ * ```
+ * var profile = band.profile(line, {step: 30, interpolation: 'bilinear'});
+ * // profile.distances[i] is the distance along the line of profile.values[i]```
+ *
+ * @method profile
+ * @throws Error
+ * @param {gdal.LineString} line
+ * @param {Object} [options]
+ * @param {Number} [options.step] Spacing of the points, in the units of the dataset's spatial reference. Defaults to the pixel size.
+ * @param {gdal.SpatialReference} [options.srs] Spatial reference of the line. Defaults to the line's own, or the dataset's if it has none.
+ * @param {String} [options.interpolation="nearest"] `"nearest"`, `"bilinear"` or `"cubic"`.
+ * @param {Number} [options.nodataValue=NaN] Value returned for points outside of the raster or on nodata pixels.
+ * @return {Object} `{distances: Float64Array, values: Float64Array}`
+ */
+NAN_METHOD(RasterBand::profile)
+{
+	Nan::HandleScope scope;
+
+	RasterBand *band = Nan::ObjectWrap::Unwrap<RasterBand>(info.This());
+	if (!band->isAlive()) {
+		Nan::ThrowError("RasterBand object has already been destroyed");
+		return;
+	}
+
+	LineString *line;
+	NODE_ARG_WRAPPED(0, "line", LineString, line);
+
+	SpatialReference *srs = NULL;
+	PointSampler::Interpolation interpolation = PointSampler::NEAREST;
+	double nodata = std::numeric_limits<double>::quiet_NaN();
+	double step = 0;
+
+	if (info.Length() > 1 && !info[1]->IsUndefined() && !info[1]->IsNull()) {
+		Local<Object> obj;
+		NODE_ARG_OBJECT(1, "options", obj);
+		NODE_WRAPPED_FROM_OBJ_OPT(obj, "srs", SpatialReference, srs);
+		NODE_DOUBLE_FROM_OBJ_OPT(obj, "step", step);
+		NODE_DOUBLE_FROM_OBJ_OPT(obj, "nodataValue", nodata);
+		if (PointSampler::parseInterpolation(Nan::Get(obj, Nan::New("interpolation").ToLocalChecked()).ToLocalChecked(), interpolation)) {
+			return; //parseInterpolation threw an error
+		}
+		if (Nan::HasOwnProperty(obj, Nan::New("step").ToLocalChecked()).FromMaybe(false) && !(step > 0)) {
+			Nan::ThrowRangeError("step must be greater than 0");
+			return;
+		}
+	}
+
+	OGRLineString *raw_line = line->get();
+	OGRSpatialReference *line_srs = srs ? srs->get() : raw_line->getSpatialReference();
+	int n_vertices = raw_line->getNumPoints();
+	std::vector<double> vx(n_vertices), vy(n_vertices);
+	for (int i = 0; i < n_vertices; i++) {
+		vx[i] = raw_line->getX(i);
+		vy[i] = raw_line->getY(i);
+	}
+
+	std::vector<double> x, y, distances, values;
+	CPLErr err;
+	{
+		DatasetLock lock(band->uid);
+		double gt[6];
+		GDALDataset *ds = band->parent_ds;
+		if (ds->GetGeoTransform(gt) != CE_None) {
+			Nan::ThrowError("Dataset has no geotransform");
+			return;
+		}
+		if (!step) {
+			step = std::min(std::fabs(gt[1]), std::fabs(gt[5]));
+		}
+
+		err = PointSampler::transform(ds, line_srs, n_vertices, vx.data(), vy.data());
+		if (err) {
+			NODE_THROW_LAST_CPLERR();
+			return;
+		}
+
+		// densify: a point every step along the line, plus the last vertex
+		double length = 0;
+		for (int i = 1; i < n_vertices; i++) {
+			length += std::hypot(vx[i] - vx[i - 1], vy[i] - vy[i - 1]);
+		}
+		if (!std::isfinite(length)) {
+			Nan::ThrowError("Line could not be transformed to the dataset's spatial reference");
+			return;
+		}
+		if (length / step > 1e8) {
+			Nan::ThrowRangeError("step is too small for the length of the line");
+			return;
+		}
+
+		double start = 0, next = 0;
+		for (int i = 1; i < n_vertices; i++) {
+			double dx = vx[i] - vx[i - 1], dy = vy[i] - vy[i - 1];
+			double segment = std::hypot(dx, dy);
+			while (next <= start + segment) {
+				double t = segment > 0 ? (next - start) / segment : 0;
+				x.push_back(vx[i - 1] + t * dx);
+				y.push_back(vy[i - 1] + t * dy);
+				distances.push_back(next);
+				next += step;
+			}
+			start += segment;
+		}
+		if (n_vertices > 0 && (distances.empty() || distances.back() < length)) {
+			x.push_back(vx[n_vertices - 1]);
+			y.push_back(vy[n_vertices - 1]);
+			distances.push_back(length);
+		}
+
+		int n = x.size();
+		values.resize(n);
+		err = PointSampler::toPixel(ds, NULL, n, x.data(), y.data());
+		if (!err) {
+			PointSampler sampler(band->this_, interpolation, nodata);
+			err = sampler.sample(n, x.data(), y.data(), values.data());
+		}
+	}
+	if (err) {
+		NODE_THROW_LAST_CPLERR();
+		return;
+	}
+
+	Local<Value> distances_array = TypedArray::New(GDT_Float64, distances.size());
+	Local<Value> values_array = TypedArray::New(GDT_Float64, values.size());
+	if (distances_array.IsEmpty() || !distances_array->IsObject() || values_array.IsEmpty() || !values_array->IsObject()) {
+		return; //TypedArray::New threw an error
+	}
+	if (!values.empty()) {
+		memcpy(*Nan::TypedArrayContents<double>(distances_array), distances.data(), distances.size() * sizeof(double));
+		memcpy(*Nan::TypedArrayContents<double>(values_array), values.data(), values.size() * sizeof(double));
+	}
+
+	Local<Object> result = Nan::New<Object>();
+	Nan::Set(result, Nan::New("distances").ToLocalChecked(), distances_array);
+	Nan::Set(result, Nan::New("values").ToLocalChecked(), values_array);
+	info.GetReturnValue().Set(result);
+}
+
 /**
  * @readOnly
  * @attribute ds
@@ -827,6 +1430,7 @@ NAN_SETTER(RasterBand::unitTypeSetter)
 		return;
 	}
 	std::string input = *Nan::Utf8String(value);
+	DatasetLock lock(band->uid);
 	CPLErr err = band->this_->SetUnitType(input.c_str());
 	if (err) {
 		NODE_THROW_CPLERR(err);
@@ -853,6 +1457,7 @@ NAN_SETTER(RasterBand::noDataValueSetter)
 		return;
 	}
 
+	DatasetLock lock(band->uid);
 	CPLErr err = band->this_->SetNoDataValue(input);
 	if (err) {
 		NODE_THROW_CPLERR(err);
@@ -873,6 +1478,7 @@ NAN_SETTER(RasterBand::scaleSetter)
 		return;
 	}
 	double input = Nan::To<double>(value).ToChecked();
+	DatasetLock lock(band->uid);
 	CPLErr err = band->this_->SetScale(input);
 	if (err) {
 		NODE_THROW_CPLERR(err);
@@ -893,6 +1499,7 @@ NAN_SETTER(RasterBand::offsetSetter)
 		return;
 	}
 	double input = Nan::To<double>(value).ToChecked();
+	DatasetLock lock(band->uid);
 	CPLErr err = band->this_->SetOffset(input);
 	if (err) {
 		NODE_THROW_CPLERR(err);
@@ -928,6 +1535,7 @@ NAN_SETTER(RasterBand::categoryNamesSetter)
 		list[i] = NULL;
 	}
 
+	DatasetLock lock(band->uid);
 	int err = band->this_->SetCategoryNames(list);
 
 	if (list) {
@@ -958,6 +1566,7 @@ NAN_SETTER(RasterBand::colorInterpretationSetter)
 		return;
 	}
 
+	DatasetLock lock(band->uid);
 	CPLErr err = band->this_->SetColorInterpretation(ci);
 	if (err) {
 		NODE_THROW_CPLERR(err);
@@ -24,7 +24,7 @@ namespace node_gdal {
 
 class RasterBand: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 	static void Initialize(Local<Object> target);
 	static NAN_METHOD(New);
 	static Local<Value> New(GDALRasterBand *band, GDALDataset *parent);
@@ -38,15 +38,18 @@ public:
 	static NAN_METHOD(getMaskFlags);
 	static NAN_METHOD(createMaskBand);
 	static NAN_METHOD(getMetadata);
+	static NAN_METHOD(sampleAt);
+	static NAN_METHOD(profile);
+	static NAN_METHOD(getHistogram);
+	static NAN_METHOD(getHistogramAsync);
+	static NAN_METHOD(getDefaultHistogram);
+	static NAN_METHOD(setDefaultHistogram);
 
 	// unimplemented methods
 	//static NAN_METHOD(getColorTable);
 	//static NAN_METHOD(setColorTable);
 	//static NAN_METHOD(rasterIO);
 	//static NAN_METHOD(buildOverviews);
-	//static NAN_METHOD(getHistogram);
-	//static NAN_METHOD(getDefaultHistogram);
-	//static NAN_METHOD(setDefaultHistogram);
 
 	static NAN_GETTER(dsGetter);
 	static NAN_GETTER(sizeGetter);
@@ -75,7 +78,7 @@ public:
 	static NAN_SETTER(categoryNamesSetter);
 	static NAN_SETTER(colorInterpretationSetter);
 
-	static ObjectCache<GDALRasterBand, RasterBand> cache;
+	static thread_local ObjectCache<GDALRasterBand, RasterBand> cache;
 
 	RasterBand();
 	RasterBand(GDALRasterBand *band);
@@ -91,6 +94,8 @@ public:
 	void dispose();
 	long uid;
 private:
+	static void getHistogramImpl(Nan::NAN_METHOD_ARGS_TYPE info, bool async);
+
 	~RasterBand();
 	GDALRasterBand *this_;
 	GDALDataset *parent_ds;
@@ -5,8 +5,8 @@
 
 namespace node_gdal {
 
-Nan::Persistent<FunctionTemplate> SpatialReference::constructor;
-ObjectCache<OGRSpatialReference, SpatialReference> SpatialReference::cache;
+thread_local Nan::Persistent<FunctionTemplate> SpatialReference::constructor;
+thread_local ObjectCache<OGRSpatialReference, SpatialReference> SpatialReference::cache;
 
 void SpatialReference::Initialize(Local<Object> target)
 {
@@ -22,7 +22,7 @@ namespace node_gdal {
 
 class SpatialReference: public Nan::ObjectWrap {
 public:
-	static Nan::Persistent<FunctionTemplate> constructor;
+	static thread_local Nan::Persistent<FunctionTemplate> constructor;
 	static void Initialize(Local<Object> target);
 
 	static NAN_METHOD(New);
@@ -70,7 +70,7 @@ public:
 	static NAN_METHOD(fromURL);
 	static NAN_METHOD(fromMICoordSys);
 
-	static ObjectCache<OGRSpatialReference, SpatialReference> cache;
+	static thread_local ObjectCache<OGRSpatialReference, SpatialReference> cache;
 
 	SpatialReference();
 	SpatialReference(OGRSpatialReference *srs);
@@ -3,6 +3,7 @@
 #include "gdal_common.hpp"
 #include "gdal_spatial_reference.hpp"
 #include "gdal_dataset.hpp"
+#include "utils/async_worker.hpp"
 
 namespace node_gdal {
 
@@ -10,6 +11,7 @@ namespace node_gdal {
 void Warper::Initialize(Local<Object> target)
 {
 	Nan::SetMethod(target, "reprojectImage", reprojectImage);
+	Nan::SetMethod(target, "reprojectImageAsync", reprojectImageAsync);
 	Nan::SetMethod(target, "suggestedWarpOutput", suggestedWarpOutput);
 }
 
@@ -261,14 +263,20 @@ NAN_METHOD(Warper::reprojectImage)
 		return;
 	}
 
-	CPLErr err;
+	Dataset *src = Nan::ObjectWrap::Unwrap<Dataset>(Nan::Get(obj, Nan::New("src").ToLocalChecked()).ToLocalChecked().As<Object>());
+	Dataset *dst = Nan::ObjectWrap::Unwrap<Dataset>(Nan::Get(obj, Nan::New("dst").ToLocalChecked()).ToLocalChecked().As<Object>());
 
-	if(options.useMultithreading()){
-		err = GDALReprojectImageMulti(opts->hSrcDS, s_srs_wkt, opts->hDstDS, t_srs_wkt, opts->eResampleAlg, opts->dfWarpMemoryLimit, maxError, NULL, NULL, opts);
-	} else {
-		err = GDALReprojectImage(opts->hSrcDS, s_srs_wkt, opts->hDstDS, t_srs_wkt, opts->eResampleAlg, opts->dfWarpMemoryLimit, maxError, NULL, NULL, opts);
+	CPLErr err;
+	{
+		// a job may be using either dataset
+		DatasetLock lock({src->uid, dst->uid});
+		if(options.useMultithreading()){
+			err = GDALReprojectImageMulti(opts->hSrcDS, s_srs_wkt, opts->hDstDS, t_srs_wkt, opts->eResampleAlg, opts->dfWarpMemoryLimit, maxError, NULL, NULL, opts);
+		} else {
+			err = GDALReprojectImage(opts->hSrcDS, s_srs_wkt, opts->hDstDS, t_srs_wkt, opts->eResampleAlg, opts->dfWarpMemoryLimit, maxError, NULL, NULL, opts);
+		}
 	}
-	
+
 	CPLFree(s_srs_wkt);
 	CPLFree(t_srs_wkt);
 
@@ -280,6 +288,140 @@ NAN_METHOD(Warper::reprojectImage)
 	return;
 }
 
+/*
+ * Runs GDALReprojectImage[Multi] on the threadpool. Takes ownership of the
+ * parsed warp options and the WKT strings.
+ */
+class ReprojectImageWorker : public AsyncWorker {
+public:
+	ReprojectImageWorker(Nan::Callback *callback, WarpOptions *options, char *s_srs_wkt, char *t_srs_wkt, double maxError)
+		: AsyncWorker(callback, "gdal:reprojectImage"), options(options),
+		  s_srs_wkt(s_srs_wkt), t_srs_wkt(t_srs_wkt), maxError(maxError)
+	{}
+
+	~ReprojectImageWorker()
+	{
+		CPLFree(s_srs_wkt);
+		CPLFree(t_srs_wkt);
+		delete options;
+	}
+
+protected:
+	void Run()
+	{
+		GDALWarpOptions *opts = options->get();
+		CPLErr err;
+
+		if(options->useMultithreading()){
+			err = GDALReprojectImageMulti(opts->hSrcDS, s_srs_wkt, opts->hDstDS, t_srs_wkt, opts->eResampleAlg, opts->dfWarpMemoryLimit, maxError, progressFunc, this, opts);
+		} else {
+			err = GDALReprojectImage(opts->hSrcDS, s_srs_wkt, opts->hDstDS, t_srs_wkt, opts->eResampleAlg, opts->dfWarpMemoryLimit, maxError, progressFunc, this, opts);
+		}
+
+		if(err) {
+			SetErrorFromCPL("Error reprojecting image");
+		}
+	}
+
+private:
+	WarpOptions *options;
+	char *s_srs_wkt;
+	char *t_srs_wkt;
+	double maxError;
+};
+
+/**
+ * Reprojects a dataset on a background thread. Takes the same options as
+ * {{#crossLink "gdal/reprojectImage:method"}}reprojectImage(){{/crossLink}}.
+ * The src and dst datasets are locked until the operation finishes.
+ *
+ * @method reprojectImageAsync
+ * @static
+ * @for gdal
+ * @param {object} options
+ * @param {Function} [options.progress] Called with the fraction complete (0-1), at most every 100ms.
+ * @param {AbortSignal} [options.signal] Cancels the operation when aborted.
+ * @param {String} [options.priority="normal"] `"interactive"`, `"normal"` or `"background"`. See {{#crossLink "gdal/setThreadPoolSize:method"}}gdal.setThreadPoolSize(){{/crossLink}}.
+ * @return {Promise}
+ */
+NAN_METHOD(Warper::reprojectImageAsync)
+{
+	Nan::HandleScope scope;
+
+	Local<Object> obj;
+	WarpOptions *options;
+	SpatialReference* s_srs;
+	SpatialReference* t_srs;
+	double maxError = 0;
+
+	NODE_ARG_OBJECT(0, "Warp options", obj);
+	if(info.Length() < 3 || !info[2]->IsFunction()){
+		Nan::ThrowTypeError("callback must be a function");
+		return;
+	}
+
+	options = new WarpOptions();
+	if(options->parse(obj)){
+		delete options;
+		return; // error parsing options object
+	}
+	if(!options->get()->hDstDS){
+		delete options;
+		Nan::ThrowTypeError("dst Dataset must be provided");
+		return;
+	}
+
+	if(!Nan::HasOwnProperty(obj, Nan::New("s_srs").ToLocalChecked()).FromMaybe(false) ||
+	   !Nan::HasOwnProperty(obj, Nan::New("t_srs").ToLocalChecked()).FromMaybe(false)){
+		delete options;
+		Nan::ThrowError("s_srs and t_srs must be given");
+		return;
+	}
+	Local<Value> s_srs_obj = Nan::Get(obj, Nan::New("s_srs").ToLocalChecked()).ToLocalChecked();
+	Local<Value> t_srs_obj = Nan::Get(obj, Nan::New("t_srs").ToLocalChecked()).ToLocalChecked();
+	if(!IS_WRAPPED(s_srs_obj, SpatialReference) || !IS_WRAPPED(t_srs_obj, SpatialReference)){
+		delete options;
+		Nan::ThrowTypeError("s_srs and t_srs must be SpatialReference objects");
+		return;
+	}
+	s_srs = Nan::ObjectWrap::Unwrap<SpatialReference>(s_srs_obj.As<Object>());
+	t_srs = Nan::ObjectWrap::Unwrap<SpatialReference>(t_srs_obj.As<Object>());
+
+	Local<Value> prop = Nan::Get(obj, Nan::New("maxError").ToLocalChecked()).ToLocalChecked();
+	if(prop->IsNumber()){
+		maxError = Nan::To<double>(prop).ToChecked();
+	}
+
+	char *s_srs_wkt, *t_srs_wkt;
+	if(s_srs->get()->exportToWkt(&s_srs_wkt)){
+		delete options;
+		Nan::ThrowError("Error converting s_srs to WKT");
+		return;
+	}
+	if(t_srs->get()->exportToWkt(&t_srs_wkt)){
+		delete options;
+		CPLFree(s_srs_wkt);
+		Nan::ThrowError("Error converting t_srs to WKT");
+		return;
+	}
+
+	Dataset *src = Nan::ObjectWrap::Unwrap<Dataset>(Nan::Get(obj, Nan::New("src").ToLocalChecked()).ToLocalChecked().As<Object>());
+	Dataset *dst = Nan::ObjectWrap::Unwrap<Dataset>(Nan::Get(obj, Nan::New("dst").ToLocalChecked()).ToLocalChecked().As<Object>());
+
+	Nan::Callback *callback = new Nan::Callback(info[2].As<Function>());
+	ReprojectImageWorker *worker = new ReprojectImageWorker(callback, options, s_srs_wkt, t_srs_wkt, maxError);
+	// keeps the datasets and cutline geometry from being collected
+	worker->SaveToPersistent("options", obj);
+	worker->useDataset(src->uid);
+	worker->useDataset(dst->uid);
+	if(info[1]->IsFunction()){
+		worker->setProgressCallback(info[1].As<Function>());
+	}
+	job_pool.queue(worker);
+
+	info.GetReturnValue().Set(Nan::New<Number>(worker->getJobId()));
+}
+
 /**
  * Used to determine the bounds and resolution of the output virtual file which
  * should be large enough to include all the input image.
@@ -349,7 +491,7 @@ NAN_METHOD(Warper::suggestedWarpOutput)
 		return;
 	}
 
-
+	DatasetLock lock(ds->uid);
 
 	void *hTransformArg;
 	void *hGenTransformArg = GDALCreateGenImgProjTransformer(ds->getDataset(), s_srs_wkt, NULL, t_srs_wkt, TRUE, 1000.0, 0 );
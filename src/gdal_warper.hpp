@@ -30,6 +30,7 @@ namespace Warper {
 	void Initialize(Local<Object> target);
 
 	NAN_METHOD(reprojectImage);
+	NAN_METHOD(reprojectImageAsync);
 	NAN_METHOD(suggestedWarpOutput);
 
 }
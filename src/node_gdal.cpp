@@ -57,11 +57,14 @@
 
 #include "gdal.hpp"
 #include "utils/field_types.hpp"
+#include "utils/async_worker.hpp"
 
 //collections
 #include "collections/dataset_bands.hpp"
 #include "collections/dataset_layers.hpp"
+#include "collections/dataset_pixels.hpp"
 #include "collections/layer_features.hpp"
+#include "collections/layer_feature_cursor.hpp"
 #include "collections/feature_fields.hpp"
 #include "collections/layer_fields.hpp"
 #include "collections/feature_defn_fields.hpp"
@@ -70,6 +73,8 @@
 #include "collections/linestring_points.hpp"
 #include "collections/rasterband_overviews.hpp"
 #include "collections/rasterband_pixels.hpp"
+#include "collections/rasterband_block_iterator.hpp"
+#include "collections/rasterband_sampler.hpp"
 #include "collections/gdal_drivers.hpp"
 
 // std
@@ -83,7 +88,8 @@ namespace node_gdal {
 	using namespace v8;
 
 	FILE *log_file = NULL;
-	PtrManager ptr_manager;
+	thread_local PtrManager ptr_manager;
+	thread_local JobPool job_pool;
 
 	/**
 	 * @attribute lastError
@@ -217,17 +223,84 @@ namespace node_gdal {
 			info.GetReturnValue().Set(Nan::New(ptr_manager.isAlive(uid)));
 		}
 
+		/**
+		 * Sets the number of threads used for async GDAL jobs. These threads
+		 * are separate from the libuv threadpool (`UV_THREADPOOL_SIZE`), so
+		 * long-running jobs don't hold up `fs` or `dns` calls. Defaults to 4.
+		 *
+		 * Async methods take a `priority` option: `"interactive"`, `"normal"`
+		 * (default) or `"background"`. Queued jobs run most urgent first, with
+		 * jobs moving up a class for every 2 seconds spent waiting. Background
+		 * jobs never take the last free thread, and long jobs pause at progress
+		 * checkpoints to let waiting interactive jobs start.
+		 *
+		 * @for gdal
+		 * @static
+		 * @method setThreadPoolSize
+		 * @param {Integer} size
+		 */
+		static NAN_METHOD(setThreadPoolSize)
+		{
+			Nan::HandleScope scope;
+
+			int size;
+			NODE_ARG_INT(0, "size", size);
+			if (size < 1) {
+				Nan::ThrowRangeError("size must be at least 1");
+				return;
+			}
+
+			job_pool.setSize(size);
+		}
+
+		/**
+		 * Returns the state of the async job pool: `size`, `threads` (started so
+		 * far), `queued` and `active` job counts, the number of `completed` jobs
+		 * with their `totalWaitTime` and `totalRunTime`, the queued and running
+		 * `jobs`, and the `recent` 100 completed jobs. Each job has an `id`,
+		 * `name`, `state`, `waitTime` and `runTime`. Times are in milliseconds.
+		 *
+		 * @for gdal
+		 * @static
+		 * @method getThreadPoolStats
+		 * @return {Object}
+		 */
+		static NAN_METHOD(getThreadPoolStats)
+		{
+			Nan::HandleScope scope;
+			info.GetReturnValue().Set(job_pool.getStats());
+		}
+
+		// Runs when the environment (main thread or worker) is torn down. GC
+		// doesn't run at that point, so datasets would otherwise be left
+		// unflushed.
+		static void Cleanup(void *arg)
+		{
+			Nan::HandleScope scope;
+
+			job_pool.shutdown();
+			ptr_manager.disposeAll();
+		}
+
 		static void Init(Local<Object> target)
 		{
+			#if NODE_VERSION_AT_LEAST(10, 2, 0)
+			node::AddEnvironmentCleanupHook(v8::Isolate::GetCurrent(), Cleanup, NULL);
+			#endif
 
 			Nan::SetMethod(target, "open", open);
+			Nan::SetMethod(target, "openAsync", openAsync);
+			Nan::SetMethod(target, "fromTypedArray", fromTypedArray);
 			Nan::SetMethod(target, "setConfigOption", setConfigOption);
 			Nan::SetMethod(target, "getConfigOption", getConfigOption);
 			Nan::SetMethod(target, "decToDMS", decToDMS);
+			Nan::SetMethod(target, "setThreadPoolSize", setThreadPoolSize);
+			Nan::SetMethod(target, "getThreadPoolStats", getThreadPoolStats);
 			Nan::SetMethod(target, "_triggerCPLError", ThrowDummyCPLError); // for tests
 			Nan::SetMethod(target, "_isAlive", isAlive); // for tests
 
 			Warper::Initialize(target);
+			AsyncWorker::Initialize(target);
 			Algorithms::Initialize(target);
 
 			Driver::Initialize(target);
@@ -252,7 +325,9 @@ namespace node_gdal {
 
 			DatasetBands::Initialize(target);
 			DatasetLayers::Initialize(target);
+			DatasetPixels::Initialize(target);
 			LayerFeatures::Initialize(target);
+			LayerFeatureCursor::Initialize(target);
 			FeatureFields::Initialize(target);
 			LayerFields::Initialize(target);
 			FeatureDefnFields::Initialize(target);
@@ -261,6 +336,8 @@ namespace node_gdal {
 			LineStringPoints::Initialize(target);
 			RasterBandOverviews::Initialize(target);
 			RasterBandPixels::Initialize(target);
+			RasterBandBlockIterator::Initialize(target);
+			RasterBandSampler::Initialize(target);
 
 			/**
 			 * The collection of all drivers registered with GDAL
@@ -1193,4 +1270,5 @@ namespace node_gdal {
 
 } // namespace node_gdal
 
-NODE_MODULE(gdal, node_gdal::Init)
+// context-aware, so the module can be loaded in worker_threads
+NAN_MODULE_WORKER_ENABLED(gdal, node_gdal::Init)
@@ -0,0 +1,207 @@
+#include "async_worker.hpp"
+#include "../gdal_common.hpp"
+
+#include <algorithm>
+#include <string>
+
+// minimum interval between progress events (ns)
+#define PROGRESS_INTERVAL 100000000
+
+namespace node_gdal {
+
+thread_local std::map<long, AsyncWorker*> AsyncWorker::jobs;
+thread_local long AsyncWorker::next_job_id = 1;
+thread_local JobPriority AsyncWorker::next_priority = PRIORITY_NORMAL;
+
+static bool compareDatasetItems(PtrManagerDatasetItem *a, PtrManagerDatasetItem *b)
+{
+	return a->uid < b->uid;
+}
+
+void AsyncWorker::Initialize(Local<Object> target)
+{
+	Nan::SetMethod(target, "_cancelJob", cancelJob);
+	Nan::SetMethod(target, "_setNextJobPriority", setNextJobPriority);
+}
+
+// Cancels a pending job by id. Jobs that have already finished are ignored.
+NAN_METHOD(AsyncWorker::cancelJob)
+{
+	Nan::HandleScope scope;
+
+	double id;
+	NODE_ARG_DOUBLE(0, "job id", id);
+
+	std::map<long, AsyncWorker*>::iterator it = jobs.find(static_cast<long>(id));
+	if(it != jobs.end()) {
+		it->second->cancelled = true;
+	}
+}
+
+// Sets the priority of jobs created from here on: "interactive", "normal"
+// or "background".
+NAN_METHOD(AsyncWorker::setNextJobPriority)
+{
+	Nan::HandleScope scope;
+
+	std::string name;
+	NODE_ARG_STR(0, "priority", name);
+
+	if(!JobPool::parsePriority(name, next_priority)) {
+		Nan::ThrowError("priority must be \"interactive\", \"normal\" or \"background\"");
+		return;
+	}
+}
+
+AsyncWorker::AsyncWorker(Nan::Callback *callback, const char *resource_name)
+	: Nan::AsyncProgressWorkerBase<double>(callback, resource_name), datasets(), pool(&job_pool),
+	  progress_callback(NULL), progress(NULL), last_progress_time(0),
+	  last_progress_sent(-1), last_progress_delivered(-1), cancelled(false), stopped(false),
+	  job_id(next_job_id++), name(resource_name), priority(next_priority)
+{
+	jobs[job_id] = this;
+}
+
+AsyncWorker::~AsyncWorker()
+{
+	jobs.erase(job_id);
+	for(unsigned int i = 0; i < datasets.size(); i++) {
+		ptr_manager.release(datasets[i]);
+	}
+	if(progress_callback) delete progress_callback;
+}
+
+// Accepts the uid of a dataset, band, or layer. Returns false if it has
+// already been destroyed.
+bool AsyncWorker::useDataset(long uid)
+{
+	PtrManagerDatasetItem *item = ptr_manager.getDatasetItem(uid);
+	if(!item) return false;
+	if(std::find(datasets.begin(), datasets.end(), item) != datasets.end()) return true;
+
+	datasets.push_back(ptr_manager.acquire(uid));
+	// always lock in the same order so two jobs sharing datasets can't deadlock
+	std::sort(datasets.begin(), datasets.end(), compareDatasetItems);
+	return true;
+}
+
+// Whether both jobs lock one of the same datasets. The dataset lists don't
+// change once the jobs are queued, so this is safe on any thread.
+bool AsyncWorker::sharesDataset(AsyncWorker *other)
+{
+	for(unsigned int i = 0; i < datasets.size(); i++) {
+		if(std::find(other->datasets.begin(), other->datasets.end(), datasets[i]) != other->datasets.end()) return true;
+	}
+	return false;
+}
+
+void AsyncWorker::setProgressCallback(Local<Function> fn)
+{
+	if(progress_callback) delete progress_callback;
+	progress_callback = new Nan::Callback(fn);
+}
+
+void AsyncWorker::Execute(const ExecutionProgress &progress)
+{
+	unsigned int i;
+	for(i = 0; i < datasets.size(); i++) {
+		uv_mutex_lock(&datasets[i]->async_lock);
+	}
+
+	bool open = true;
+	for(i = 0; i < datasets.size(); i++) {
+		if(!PtrManager::isDatasetOpen(datasets[i])) open = false;
+	}
+
+	if(!open) {
+		SetErrorMessage("Dataset object has already been destroyed");
+	} else if(cancelled) {
+		SetErrorMessage("Operation cancelled");
+	} else {
+		this->progress = &progress;
+		CPLErrorReset();
+		Run();
+		this->progress = NULL;
+
+		if(stopped) {
+			SetErrorMessage("Operation cancelled");
+		}
+	}
+
+	for(i = datasets.size(); i > 0; i--) {
+		uv_mutex_unlock(&datasets[i - 1]->async_lock);
+	}
+}
+
+// GDALProgressFunc, called on the worker thread. Returning FALSE makes GDAL
+// abort the operation. Progress calls are also where long jobs yield to
+// queued interactive work.
+int CPL_STDCALL AsyncWorker::progressFunc(double complete, const char *message, void *arg)
+{
+	AsyncWorker *worker = static_cast<AsyncWorker*>(arg);
+	if(worker->stopIfCancelled()) return FALSE;
+
+	worker->pool->yield(worker);
+	if(worker->stopIfCancelled()) return FALSE;
+
+	if(worker->progress_callback && worker->progress) {
+		uint64_t now = uv_hrtime();
+		if(complete >= 1.0 || now - worker->last_progress_time >= PROGRESS_INTERVAL) {
+			worker->last_progress_time = now;
+			worker->last_progress_sent = complete;
+			worker->progress->Send(&complete, 1);
+		}
+	}
+	return TRUE;
+}
+
+Local<Value> AsyncWorker::Result()
+{
+	return Nan::Undefined();
+}
+
+void AsyncWorker::HandleOKCallback()
+{
+	Nan::HandleScope scope;
+
+	// progress events are coalesced and may not have fired before completion
+	if(last_progress_sent > last_progress_delivered) {
+		deliverProgress(last_progress_sent);
+	}
+
+	Local<Value> argv[] = { Nan::Null(), Result() };
+	callback->Call(2, argv, async_resource);
+}
+
+void AsyncWorker::HandleProgressCallback(const double *data, size_t count)
+{
+	Nan::HandleScope scope;
+
+	if(!data || count == 0) return;
+	deliverProgress(data[0]);
+}
+
+void AsyncWorker::deliverProgress(double complete)
+{
+	if(!progress_callback || complete <= last_progress_delivered) return;
+	last_progress_delivered = complete;
+
+	Local<Value> argv[] = { Nan::New<Number>(complete) };
+	progress_callback->Call(1, argv, async_resource);
+}
+
+// Called from Run() where the job can stop early. Once it returns true the
+// job fails with "Operation cancelled".
+bool AsyncWorker::stopIfCancelled()
+{
+	if(cancelled) stopped = true;
+	return stopped;
+}
+
+void AsyncWorker::SetErrorFromCPL(const char *fallback)
+{
+	const char *msg = CPLGetLastErrorMsg();
+	SetErrorMessage(msg && msg[0] ? msg : fallback);
+}
+
+}
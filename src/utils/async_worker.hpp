@@ -0,0 +1,113 @@
+#ifndef __ASYNC_WORKER_H__
+#define __ASYNC_WORKER_H__
+
+// node
+#include <node.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+#include "ptr_manager.hpp"
+#include "job_pool.hpp"
+
+#include <atomic>
+#include <map>
+#include <vector>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// Base class for jobs that use GDAL objects on the libuv threadpool
+//
+// Subclasses declare the datasets they touch with useDataset() (on the main
+// thread) and implement Run(). The dataset items are kept from being freed
+// until the worker is destroyed, and are locked while Run() executes. If a
+// dataset is closed before the job starts, Run() is skipped and the callback
+// receives an error.
+//
+// Workers are queued with job_pool.queue(worker), which runs them on the
+// addon's own threads rather than the libuv threadpool. A worker's priority
+// defaults to the one set with gdal._setNextJobPriority(), which the JS
+// wrappers set around each call taking a `priority` option.
+//
+// Every worker gets a job id that can be passed to gdal._cancelJob(). GDAL
+// calls made with progressFunc / this as the progress arguments report
+// throttled progress to the JS progress callback and stop when cancelled.
+// Loops in Run() poll stopIfCancelled(). The job only fails with "Operation
+// cancelled" if it was cancelled before Run() or actually stopped by one of
+// these; a cancel arriving after the work is done is ignored.
+
+class AsyncWorker : public Nan::AsyncProgressWorkerBase<double> {
+public:
+	static void Initialize(Local<Object> target);
+	static NAN_METHOD(cancelJob);
+	static NAN_METHOD(setNextJobPriority);
+
+	AsyncWorker(Nan::Callback *callback, const char *resource_name);
+	virtual ~AsyncWorker();
+
+	bool useDataset(long uid);
+	bool sharesDataset(AsyncWorker *other);
+	void setProgressCallback(Local<Function> fn);
+	inline long getJobId() {
+		return job_id;
+	}
+	inline const char *getName() {
+		return name;
+	}
+	inline JobPriority getPriority() {
+		return priority;
+	}
+	inline void setPriority(JobPriority priority) {
+		this->priority = priority;
+	}
+	inline bool isCancelled() {
+		return cancelled;
+	}
+
+	void Execute(const ExecutionProgress &progress);
+
+	static int CPL_STDCALL progressFunc(double complete, const char *message, void *arg);
+
+protected:
+	virtual void Run() = 0;
+	virtual Local<Value> Result();
+	virtual void HandleOKCallback();
+	virtual void HandleProgressCallback(const double *data, size_t count);
+
+	void SetErrorFromCPL(const char *fallback);
+	bool stopIfCancelled();
+	inline bool isStopped() {
+		return stopped;
+	}
+
+private:
+	void deliverProgress(double complete);
+
+	static thread_local std::map<long, AsyncWorker*> jobs;
+	static thread_local long next_job_id;
+	static thread_local JobPriority next_priority;
+
+	std::vector<PtrManagerDatasetItem*> datasets;
+	JobPool *pool;  // of the creating thread, job_pool is thread_local
+	Nan::Callback *progress_callback;
+	const ExecutionProgress *progress;
+	uint64_t last_progress_time;
+	double last_progress_sent;
+	double last_progress_delivered;
+	std::atomic<bool> cancelled;
+	bool stopped;  // only used on the worker thread
+	long job_id;
+	const char *name;
+	JobPriority priority;
+};
+
+}
+#endif
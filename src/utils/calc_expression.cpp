@@ -0,0 +1,338 @@
+#include "calc_expression.hpp"
+
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+
+namespace node_gdal {
+
+CalcExpression::CalcExpression()
+	: program(), max_depth(0), depth(0), src(), pos(0), names(NULL), error(), stack()
+{}
+
+CalcExpression::~CalcExpression()
+{}
+
+bool CalcExpression::parse(const std::string &expr, const std::vector<std::string> &variables, std::string &message)
+{
+	program.clear();
+	max_depth = depth = 0;
+	src = expr;
+	pos = 0;
+	names = &variables;
+	error.clear();
+
+	bool ok = parseTernary();
+	if(ok) {
+		skipSpace();
+		if(pos < src.size()) ok = fail("Unexpected \"" + src.substr(pos, 1) + "\"");
+	}
+	names = NULL;
+	if(!ok) {
+		message = error;
+		program.clear();
+		return false;
+	}
+	return true;
+}
+
+void CalcExpression::evaluate(const std::vector<const double*> &inputs, int n, double *out)
+{
+	if(static_cast<int>(stack.size()) < max_depth) stack.resize(max_depth);
+	for(int i = 0; i < max_depth; i++) {
+		if(static_cast<int>(stack[i].size()) < n) stack[i].resize(n);
+	}
+
+	int top = -1;
+	for(size_t k = 0; k < program.size(); k++) {
+		const Instruction &ins = program[k];
+		switch(ins.op) {
+			case PUSH_VAR: {
+				top++;
+				std::memcpy(&stack[top][0], inputs[ins.index], n * sizeof(double));
+				continue;
+			}
+			case PUSH_CONST: {
+				top++;
+				double *r = &stack[top][0];
+				double c = ins.value;
+				for(int i = 0; i < n; i++) r[i] = c;
+				continue;
+			}
+			case SELECT: {
+				// condition, then value, otherwise value
+				top -= 2;
+				double *c = &stack[top][0];
+				const double *a = &stack[top + 1][0];
+				const double *b = &stack[top + 2][0];
+				for(int i = 0; i < n; i++) c[i] = c[i] != 0 ? a[i] : b[i];
+				continue;
+			}
+			default:
+				break;
+		}
+
+		if(ins.op < ADD || (ins.op >= ABS && ins.op < MIN)) {
+			// unary, in place
+			double *r = &stack[top][0];
+			switch(ins.op) {
+				case NEG:   for(int i = 0; i < n; i++) r[i] = -r[i]; break;
+				case NOT:   for(int i = 0; i < n; i++) r[i] = r[i] == 0; break;
+				case ABS:   for(int i = 0; i < n; i++) r[i] = std::fabs(r[i]); break;
+				case SQRT:  for(int i = 0; i < n; i++) r[i] = std::sqrt(r[i]); break;
+				case EXP:   for(int i = 0; i < n; i++) r[i] = std::exp(r[i]); break;
+				case LOG:   for(int i = 0; i < n; i++) r[i] = std::log(r[i]); break;
+				case LOG10: for(int i = 0; i < n; i++) r[i] = std::log10(r[i]); break;
+				case SIN:   for(int i = 0; i < n; i++) r[i] = std::sin(r[i]); break;
+				case COS:   for(int i = 0; i < n; i++) r[i] = std::cos(r[i]); break;
+				case TAN:   for(int i = 0; i < n; i++) r[i] = std::tan(r[i]); break;
+				case ASIN:  for(int i = 0; i < n; i++) r[i] = std::asin(r[i]); break;
+				case ACOS:  for(int i = 0; i < n; i++) r[i] = std::acos(r[i]); break;
+				case ATAN:  for(int i = 0; i < n; i++) r[i] = std::atan(r[i]); break;
+				case FLOOR: for(int i = 0; i < n; i++) r[i] = std::floor(r[i]); break;
+				case CEIL:  for(int i = 0; i < n; i++) r[i] = std::ceil(r[i]); break;
+				case ROUND: for(int i = 0; i < n; i++) r[i] = std::round(r[i]); break;
+				case ISNAN: for(int i = 0; i < n; i++) r[i] = std::isnan(r[i]); break;
+				default: break;
+			}
+			continue;
+		}
+
+		// binary, result replaces the left operand
+		top--;
+		double *a = &stack[top][0];
+		const double *b = &stack[top + 1][0];
+		switch(ins.op) {
+			case ADD:   for(int i = 0; i < n; i++) a[i] = a[i] + b[i]; break;
+			case SUB:   for(int i = 0; i < n; i++) a[i] = a[i] - b[i]; break;
+			case MUL:   for(int i = 0; i < n; i++) a[i] = a[i] * b[i]; break;
+			case DIV:   for(int i = 0; i < n; i++) a[i] = a[i] / b[i]; break;
+			case MOD:   for(int i = 0; i < n; i++) a[i] = std::fmod(a[i], b[i]); break;
+			case POW:   for(int i = 0; i < n; i++) a[i] = std::pow(a[i], b[i]); break;
+			case EQ:    for(int i = 0; i < n; i++) a[i] = a[i] == b[i]; break;
+			case NE:    for(int i = 0; i < n; i++) a[i] = a[i] != b[i]; break;
+			case LT:    for(int i = 0; i < n; i++) a[i] = a[i] < b[i]; break;
+			case LE:    for(int i = 0; i < n; i++) a[i] = a[i] <= b[i]; break;
+			case GT:    for(int i = 0; i < n; i++) a[i] = a[i] > b[i]; break;
+			case GE:    for(int i = 0; i < n; i++) a[i] = a[i] >= b[i]; break;
+			case AND:   for(int i = 0; i < n; i++) a[i] = a[i] != 0 && b[i] != 0; break;
+			case OR:    for(int i = 0; i < n; i++) a[i] = a[i] != 0 || b[i] != 0; break;
+			case MIN:   for(int i = 0; i < n; i++) a[i] = std::fmin(a[i], b[i]); break;
+			case MAX:   for(int i = 0; i < n; i++) a[i] = std::fmax(a[i], b[i]); break;
+			case ATAN2: for(int i = 0; i < n; i++) a[i] = std::atan2(a[i], b[i]); break;
+			default: break;
+		}
+	}
+
+	if(n > 0) std::memcpy(out, &stack[0][0], n * sizeof(double));
+}
+
+void CalcExpression::emit(Op op, int index, double value)
+{
+	Instruction ins;
+	ins.op = op;
+	ins.index = index;
+	ins.value = value;
+	program.push_back(ins);
+
+	if(op == PUSH_VAR || op == PUSH_CONST) depth++;
+	else if(op == SELECT) depth -= 2;
+	else if(!(op < ADD || (op >= ABS && op < MIN))) depth--;
+	if(depth > max_depth) max_depth = depth;
+}
+
+bool CalcExpression::fail(const std::string &message)
+{
+	if(error.empty()) {
+		error = message + " at position " + std::to_string(pos) + " of expression";
+	}
+	return false;
+}
+
+void CalcExpression::skipSpace()
+{
+	while(pos < src.size() && std::isspace(static_cast<unsigned char>(src[pos]))) pos++;
+}
+
+// Consumes token if it comes next. Single character operators don't match
+// the start of a longer one ("<" doesn't match "<=").
+bool CalcExpression::accept(const char *token)
+{
+	skipSpace();
+	size_t len = std::strlen(token);
+	if(src.compare(pos, len, token) != 0) return false;
+	if(len == 1 && pos + 1 < src.size()) {
+		char next = src[pos + 1];
+		if((token[0] == '<' || token[0] == '>' || token[0] == '!' || token[0] == '=') && next == '=') return false;
+		if((token[0] == '&' || token[0] == '|') && next == token[0]) return false;
+	}
+	pos += len;
+	return true;
+}
+
+bool CalcExpression::parseTernary()
+{
+	if(!parseOr()) return false;
+	if(accept("?")) {
+		if(!parseTernary()) return false;
+		if(!accept(":")) return fail("Expected \":\"");
+		if(!parseTernary()) return false;
+		emit(SELECT);
+	}
+	return true;
+}
+
+bool CalcExpression::parseOr()
+{
+	if(!parseAnd()) return false;
+	while(accept("||")) {
+		if(!parseAnd()) return false;
+		emit(OR);
+	}
+	return true;
+}
+
+bool CalcExpression::parseAnd()
+{
+	if(!parseComparison()) return false;
+	while(accept("&&")) {
+		if(!parseComparison()) return false;
+		emit(AND);
+	}
+	return true;
+}
+
+bool CalcExpression::parseComparison()
+{
+	if(!parseAdditive()) return false;
+	while(true) {
+		Op op;
+		if(accept("==")) op = EQ;
+		else if(accept("!=")) op = NE;
+		else if(accept("<=")) op = LE;
+		else if(accept(">=")) op = GE;
+		else if(accept("<")) op = LT;
+		else if(accept(">")) op = GT;
+		else return true;
+		if(!parseAdditive()) return false;
+		emit(op);
+	}
+}
+
+bool CalcExpression::parseAdditive()
+{
+	if(!parseMultiplicative()) return false;
+	while(true) {
+		Op op;
+		if(accept("+")) op = ADD;
+		else if(accept("-")) op = SUB;
+		else return true;
+		if(!parseMultiplicative()) return false;
+		emit(op);
+	}
+}
+
+bool CalcExpression::parseMultiplicative()
+{
+	if(!parseUnary()) return false;
+	while(true) {
+		Op op;
+		if(accept("*")) op = MUL;
+		else if(accept("/")) op = DIV;
+		else if(accept("%")) op = MOD;
+		else return true;
+		if(!parseUnary()) return false;
+		emit(op);
+	}
+}
+
+bool CalcExpression::parseUnary()
+{
+	if(accept("-")) {
+		if(!parseUnary()) return false;
+		emit(NEG);
+		return true;
+	}
+	if(accept("+")) return parseUnary();
+	if(accept("!")) {
+		if(!parseUnary()) return false;
+		emit(NOT);
+		return true;
+	}
+	return parsePower();
+}
+
+bool CalcExpression::parsePower()
+{
+	if(!parsePrimary()) return false;
+	if(accept("^")) {
+		// right associative, and binds tighter than a unary minus on its left
+		if(!parseUnary()) return false;
+		emit(POW);
+	}
+	return true;
+}
+
+bool CalcExpression::parsePrimary()
+{
+	skipSpace();
+	if(pos >= src.size()) return fail("Unexpected end");
+
+	char c = src[pos];
+
+	if(c == '(') {
+		pos++;
+		if(!parseTernary()) return false;
+		if(!accept(")")) return fail("Expected \")\"");
+		return true;
+	}
+
+	if(std::isdigit(static_cast<unsigned char>(c)) || c == '.') {
+		const char *start = src.c_str() + pos;
+		char *end;
+		double value = std::strtod(start, &end);
+		if(end == start) return fail("Invalid number");
+		pos += end - start;
+		emit(PUSH_CONST, 0, value);
+		return true;
+	}
+
+	if(std::isalpha(static_cast<unsigned char>(c)) || c == '_') {
+		size_t start = pos;
+		while(pos < src.size() && (std::isalnum(static_cast<unsigned char>(src[pos])) || src[pos] == '_')) pos++;
+		std::string name = src.substr(start, pos - start);
+
+		for(size_t i = 0; i < names->size(); i++) {
+			if((*names)[i] == name) {
+				emit(PUSH_VAR, static_cast<int>(i));
+				return true;
+			}
+		}
+
+		static const struct { const char *name; Op op; int args; } functions[] = {
+			{"abs", ABS, 1}, {"sqrt", SQRT, 1}, {"exp", EXP, 1}, {"log", LOG, 1}, {"log10", LOG10, 1},
+			{"sin", SIN, 1}, {"cos", COS, 1}, {"tan", TAN, 1}, {"asin", ASIN, 1}, {"acos", ACOS, 1},
+			{"atan", ATAN, 1}, {"floor", FLOOR, 1}, {"ceil", CEIL, 1}, {"round", ROUND, 1},
+			{"isnan", ISNAN, 1}, {"min", MIN, 2}, {"max", MAX, 2}, {"pow", POW, 2}, {"atan2", ATAN2, 2}
+		};
+		for(size_t i = 0; i < sizeof(functions) / sizeof(functions[0]); i++) {
+			if(name != functions[i].name) continue;
+			if(!accept("(")) return fail("Expected \"(\" after \"" + name + "\"");
+			for(int arg = 0; arg < functions[i].args; arg++) {
+				if(arg > 0 && !accept(",")) return fail("Expected \",\"");
+				if(!parseTernary()) return false;
+			}
+			if(!accept(")")) return fail("Expected \")\"");
+			emit(functions[i].op);
+			return true;
+		}
+
+		pos = start;
+		return fail("Unknown variable or function \"" + name + "\"");
+	}
+
+	return fail("Unexpected \"" + src.substr(pos, 1) + "\"");
+}
+
+}
@@ -0,0 +1,88 @@
+#ifndef __CALC_EXPRESSION_H__
+#define __CALC_EXPRESSION_H__
+
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+// A class for compiling a map algebra expression (e.g. "(a - b) / (a + b)")
+// once and evaluating it over whole tiles of pixels.
+//
+// The expression is compiled to a postfix program. Evaluation runs each
+// instruction over the full tile before moving to the next one, so every
+// step is a tight loop over contiguous doubles that the compiler can
+// vectorize.
+//
+// Supported syntax, by increasing precedence:
+//
+//   c ? x : y
+//   ||
+//   &&
+//   == != < <= > >=
+//   + -
+//   * / %
+//   unary - + !
+//   ^ (power, right associative)
+//   numbers, variables, (...), functions
+//
+// Functions: abs sqrt exp log log10 sin cos tan asin acos atan floor ceil
+// round isnan, and the two-argument min max pow atan2.
+// Comparisons and logical operators evaluate to 1 or 0.
+
+class CalcExpression {
+public:
+	bool parse(const std::string &expr, const std::vector<std::string> &names, std::string &error);
+	void evaluate(const std::vector<const double*> &inputs, int n, double *out);
+
+	CalcExpression();
+	~CalcExpression();
+
+private:
+	enum Op {
+		PUSH_VAR, PUSH_CONST,
+		NEG, NOT,
+		ADD, SUB, MUL, DIV, MOD, POW,
+		EQ, NE, LT, LE, GT, GE, AND, OR,
+		SELECT,
+		ABS, SQRT, EXP, LOG, LOG10, SIN, COS, TAN, ASIN, ACOS, ATAN, FLOOR, CEIL, ROUND, ISNAN,
+		MIN, MAX, ATAN2
+	};
+	struct Instruction {
+		Op op;
+		int index;
+		double value;
+	};
+
+	// parser
+	bool parseTernary();
+	bool parseOr();
+	bool parseAnd();
+	bool parseComparison();
+	bool parseAdditive();
+	bool parseMultiplicative();
+	bool parseUnary();
+	bool parsePower();
+	bool parsePrimary();
+	void skipSpace();
+	bool accept(const char *token);
+	bool fail(const std::string &message);
+	void emit(Op op, int index = 0, double value = 0);
+
+	std::vector<Instruction> program;
+	int max_depth;
+	int depth;
+
+	// parser state
+	std::string src;
+	size_t pos;
+	const std::vector<std::string> *names;
+	std::string error;
+
+	// evaluation stack, one tile-sized buffer per level
+	std::vector<std::vector<double> > stack;
+};
+
+}
+
+#endif
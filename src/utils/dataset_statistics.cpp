@@ -0,0 +1,396 @@
+#include "dataset_statistics.hpp"
+#include "typed_array.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+// minimum / maximum tile size along each axis, so bands with one-row blocks
+// aren't read a row at a time
+#define STATISTICS_CHUNK_MIN 256
+#define STATISTICS_CHUNK_MAX 1024
+
+// buckets of the histogram percentiles of non-integer bands are read from
+#define STATISTICS_HISTOGRAM_BUCKETS 65536
+
+// pixels an approximate pass aims to read (as GDAL's approximate statistics)
+#define STATISTICS_APPROX_SAMPLES 2500
+
+namespace node_gdal {
+
+// Rounds a block dimension to a tile dimension that is a multiple of it
+// where practical
+static int chunkSize(int block, int raster)
+{
+	int size = block;
+	if(size < STATISTICS_CHUNK_MIN) size = ((STATISTICS_CHUNK_MIN + block - 1) / block) * block;
+	else if(size > STATISTICS_CHUNK_MAX) size = STATISTICS_CHUNK_MAX;
+	return std::min(size, raster);
+}
+
+DatasetStatistics::DatasetStatistics(const std::vector<GDALRasterBand*> &bands, const std::vector<int> &ids, bool covariance, const std::vector<double> &percentiles, bool approx)
+	: bands(bands), ids(ids), covariance(covariance), percentiles(percentiles), approx(approx),
+	  width(0), height(0), chunk_w(0), chunk_h(0)
+{}
+
+DatasetStatistics::~DatasetStatistics()
+{}
+
+CPLErr DatasetStatistics::run(GDALProgressFunc progress, void *progress_arg)
+{
+	size_t n_bands = bands.size();
+
+	if(approx) {
+		// only if every band has a matching overview
+		std::vector<GDALRasterBand*> overviews(n_bands);
+		bool matching = true;
+		for(size_t k = 0; k < n_bands; k++) {
+			overviews[k] = bands[k]->GetRasterSampleOverview(STATISTICS_APPROX_SAMPLES);
+			if(!overviews[k] || overviews[k]->GetXSize() != overviews[0]->GetXSize() || overviews[k]->GetYSize() != overviews[0]->GetYSize()) {
+				matching = false;
+			}
+		}
+		if(matching) bands = overviews;
+	}
+
+	width = bands[0]->GetXSize();
+	height = bands[0]->GetYSize();
+	int block_w, block_h;
+	bands[0]->GetBlockSize(&block_w, &block_h);
+	chunk_w = chunkSize(block_w, width);
+	chunk_h = chunkSize(block_h, height);
+
+	values.assign(n_bands, std::vector<double>((size_t)chunk_w * chunk_h));
+	valid.assign(n_bands, std::vector<char>((size_t)chunk_w * chunk_h));
+	has_nodata.assign(n_bands, 0);
+	nodata.assign(n_bands, 0);
+	for(size_t k = 0; k < n_bands; k++) {
+		nodata[k] = bands[k]->GetNoDataValue(&has_nodata[k]);
+	}
+
+	bool histogram_pass = false;
+	exact.assign(n_bands, false);
+	offsets.assign(n_bands, 0);
+	counts.assign(n_bands, std::vector<GUIntBig>());
+	if(!percentiles.empty()) {
+		for(size_t k = 0; k < n_bands; k++) {
+			switch(bands[k]->GetRasterDataType()) {
+				case GDT_Byte:   exact[k] = true; counts[k].assign(256, 0); break;
+				case GDT_UInt16: exact[k] = true; counts[k].assign(65536, 0); break;
+				case GDT_Int16:  exact[k] = true; counts[k].assign(65536, 0); offsets[k] = 32768; break;
+				default:
+					counts[k].assign(STATISTICS_HISTOGRAM_BUCKETS, 0);
+					histogram_pass = true;
+					break;
+			}
+		}
+	}
+
+	reset(total);
+	CPLErr err = scan(false, 0, histogram_pass ? 0.5 : 1, progress, progress_arg);
+	if(!err && histogram_pass) {
+		err = scan(true, 0.5, 1, progress, progress_arg);
+	}
+	if(!err && progress) progress(1.0, NULL, progress_arg);
+	return err;
+}
+
+// Reads every tile. The first pass accumulates the moments (and counts the
+// values of integer bands); the second fills the histograms of the others.
+CPLErr DatasetStatistics::scan(bool histogram_pass, double progress_start, double progress_end, GDALProgressFunc progress, void *progress_arg)
+{
+	int chunks_x = (width + chunk_w - 1) / chunk_w;
+	int chunks_y = (height + chunk_h - 1) / chunk_h;
+	double n_chunks = (double)chunks_x * chunks_y;
+	size_t n_bands = bands.size();
+
+	Tile tile;
+	for(int cy = 0; cy < chunks_y; cy++) {
+		for(int cx = 0; cx < chunks_x; cx++) {
+			double complete = progress_start + (progress_end - progress_start) * (cy * chunks_x + cx) / n_chunks;
+			if(progress && !progress(complete, NULL, progress_arg)) {
+				CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+				return CE_Failure;
+			}
+
+			int x = cx * chunk_w, y = cy * chunk_h;
+			int w = std::min(chunk_w, width - x);
+			int h = std::min(chunk_h, height - y);
+			CPLErr err = readTile(x, y, w, h);
+			if(err) return err;
+			int n = w * h;
+
+			if(!histogram_pass) {
+				reset(tile);
+				accumulate(tile, n);
+				merge(total, tile);
+				continue;
+			}
+
+			for(size_t k = 0; k < n_bands; k++) {
+				if(exact[k]) continue;
+				const Moments &m = total.bands[k];
+				double range = m.max - m.min;
+				std::vector<GUIntBig> &histogram = counts[k];
+				const double *data = &values[k][0];
+				const char *ok = &valid[k][0];
+				for(int i = 0; i < n; i++) {
+					if(!ok[i]) continue;
+					int bucket = range > 0 ? static_cast<int>((data[i] - m.min) / range * STATISTICS_HISTOGRAM_BUCKETS) : 0;
+					if(bucket >= STATISTICS_HISTOGRAM_BUCKETS) bucket = STATISTICS_HISTOGRAM_BUCKETS - 1;
+					histogram[bucket]++;
+				}
+			}
+		}
+	}
+	return CE_None;
+}
+
+CPLErr DatasetStatistics::readTile(int x, int y, int w, int h)
+{
+	int n = w * h;
+	for(size_t k = 0; k < bands.size(); k++) {
+		double *data = &values[k][0];
+		CPLErr err = bands[k]->RasterIO(GF_Read, x, y, w, h, data, w, h, GDT_Float64, 0, 0, NULL);
+		if(err) return err;
+
+		char *ok = &valid[k][0];
+		double value = nodata[k];
+		if(has_nodata[k] && !std::isnan(value)) {
+			for(int i = 0; i < n; i++) ok[i] = !std::isnan(data[i]) && data[i] != value;
+		} else {
+			for(int i = 0; i < n; i++) ok[i] = !std::isnan(data[i]);
+		}
+	}
+	return CE_None;
+}
+
+void DatasetStatistics::reset(Tile &tile)
+{
+	size_t n_bands = bands.size();
+	Moments empty = {0, 0, 0, std::numeric_limits<double>::infinity(), -std::numeric_limits<double>::infinity()};
+	tile.bands.assign(n_bands, empty);
+	tile.n = 0;
+	tile.means.assign(covariance ? n_bands : 0, 0);
+	tile.comoments.assign(covariance ? n_bands * n_bands : 0, 0);
+}
+
+// Computes a tile's moments with two passes over it
+void DatasetStatistics::accumulate(Tile &tile, int n)
+{
+	size_t n_bands = bands.size();
+
+	for(size_t k = 0; k < n_bands; k++) {
+		const double *data = &values[k][0];
+		const char *ok = &valid[k][0];
+		Moments &m = tile.bands[k];
+
+		double count = 0, sum = 0;
+		for(int i = 0; i < n; i++) {
+			if(!ok[i]) continue;
+			count++;
+			sum += data[i];
+			if(data[i] < m.min) m.min = data[i];
+			if(data[i] > m.max) m.max = data[i];
+		}
+		if(count == 0) continue;
+
+		double mean = sum / count, m2 = 0;
+		for(int i = 0; i < n; i++) {
+			if(!ok[i]) continue;
+			double d = data[i] - mean;
+			m2 += d * d;
+		}
+		m.n = count;
+		m.mean = mean;
+		m.m2 = m2;
+
+		if(exact[k]) {
+			std::vector<GUIntBig> &histogram = counts[k];
+			int offset = static_cast<int>(offsets[k]);
+			for(int i = 0; i < n; i++) {
+				if(ok[i]) histogram[static_cast<int>(data[i]) + offset]++;
+			}
+		}
+	}
+
+	if(!covariance) return;
+
+	std::vector<char> joint(n, 1);
+	for(size_t k = 0; k < n_bands; k++) {
+		const char *ok = &valid[k][0];
+		for(int i = 0; i < n; i++) joint[i] &= ok[i];
+	}
+
+	double count = 0;
+	for(int i = 0; i < n; i++) count += joint[i];
+	if(count == 0) return;
+	tile.n = count;
+
+	for(size_t k = 0; k < n_bands; k++) {
+		const double *data = &values[k][0];
+		double sum = 0;
+		for(int i = 0; i < n; i++) {
+			if(joint[i]) sum += data[i];
+		}
+		tile.means[k] = sum / count;
+	}
+
+	for(size_t k = 0; k < n_bands; k++) {
+		const double *a = &values[k][0];
+		double mean_a = tile.means[k];
+		for(size_t l = k; l < n_bands; l++) {
+			const double *b = &values[l][0];
+			double mean_b = tile.means[l];
+			double c = 0;
+			for(int i = 0; i < n; i++) {
+				if(joint[i]) c += (a[i] - mean_a) * (b[i] - mean_b);
+			}
+			tile.comoments[k * n_bands + l] = c;
+		}
+	}
+}
+
+// Chan et al.'s pairwise update of the means and (co)moments
+void DatasetStatistics::merge(Tile &into, const Tile &tile)
+{
+	size_t n_bands = bands.size();
+
+	for(size_t k = 0; k < n_bands; k++) {
+		Moments &a = into.bands[k];
+		const Moments &b = tile.bands[k];
+		if(b.n == 0) continue;
+
+		double n = a.n + b.n;
+		double delta = b.mean - a.mean;
+		a.mean += delta * b.n / n;
+		a.m2 += b.m2 + delta * delta * a.n * b.n / n;
+		a.n = n;
+		a.min = std::min(a.min, b.min);
+		a.max = std::max(a.max, b.max);
+	}
+
+	if(!covariance || tile.n == 0) return;
+
+	double n = into.n + tile.n;
+	double factor = into.n * tile.n / n;
+	for(size_t k = 0; k < n_bands; k++) {
+		double delta_k = tile.means[k] - into.means[k];
+		for(size_t l = k; l < n_bands; l++) {
+			double delta_l = tile.means[l] - into.means[l];
+			into.comoments[k * n_bands + l] += tile.comoments[k * n_bands + l] + delta_k * delta_l * factor;
+		}
+	}
+	for(size_t k = 0; k < n_bands; k++) {
+		into.means[k] += (tile.means[k] - into.means[k]) * tile.n / n;
+	}
+	into.n = n;
+}
+
+// Linearly interpolates between the two values closest to rank
+// p / 100 * (count - 1)
+double DatasetStatistics::percentile(size_t k, double p)
+{
+	const Moments &m = total.bands[k];
+	if(m.n == 0) return std::numeric_limits<double>::quiet_NaN();
+
+	const std::vector<GUIntBig> &histogram = counts[k];
+	double rank = p / 100 * (m.n - 1);
+	double ranks[2] = {std::floor(rank), std::ceil(rank)};
+	double found[2] = {m.min, m.max};
+
+	for(int r = 0; r < 2; r++) {
+		double before = 0;
+		for(size_t i = 0; i < histogram.size(); i++) {
+			double count = static_cast<double>(histogram[i]);
+			if(before + count <= ranks[r]) {
+				before += count;
+				continue;
+			}
+			if(exact[k]) {
+				found[r] = i - offsets[k];
+			} else {
+				// spread the bucket's values evenly across it
+				double bucket_size = (m.max - m.min) / STATISTICS_HISTOGRAM_BUCKETS;
+				double fraction = (ranks[r] - before + 0.5) / count;
+				found[r] = std::min(m.max, std::max(m.min, m.min + (i + fraction) * bucket_size));
+			}
+			break;
+		}
+	}
+
+	return found[0] + (found[1] - found[0]) * (rank - ranks[0]);
+}
+
+// Creates the result object: typed arrays indexed like the `bands` array,
+// plus the covariance matrix and percentiles (row-major, a row per band)
+Local<Value> DatasetStatistics::result()
+{
+	Nan::EscapableHandleScope scope;
+
+	size_t n_bands = bands.size();
+	size_t n_percentiles = percentiles.size();
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	Local<Object> obj = Nan::New<Object>();
+
+	Local<Value> ids_array = TypedArray::New(GDT_Int32, n_bands);
+	if(ids_array.IsEmpty() || !ids_array->IsObject()) {
+		return scope.Escape(Nan::Undefined()); //TypedArray::New threw an error
+	}
+	int32_t *id_data = *Nan::TypedArrayContents<int32_t>(ids_array);
+	for(size_t k = 0; k < n_bands; k++) id_data[k] = ids[k];
+	Nan::Set(obj, Nan::New("bands").ToLocalChecked(), ids_array);
+
+	const char *names[] = {"count", "min", "max", "mean", "stddev"};
+	for(int s = 0; s < 5; s++) {
+		Local<Value> array = TypedArray::New(GDT_Float64, n_bands);
+		if(array.IsEmpty() || !array->IsObject()) {
+			return scope.Escape(Nan::Undefined()); //TypedArray::New threw an error
+		}
+		double *data = *Nan::TypedArrayContents<double>(array);
+		for(size_t k = 0; k < n_bands; k++) {
+			const Moments &m = total.bands[k];
+			switch(s) {
+				case 0: data[k] = m.n; break;
+				case 1: data[k] = m.n ? m.min : nan; break;
+				case 2: data[k] = m.n ? m.max : nan; break;
+				case 3: data[k] = m.n ? m.mean : nan; break;
+				case 4: data[k] = m.n ? std::sqrt(m.m2 / m.n) : nan; break;
+			}
+		}
+		Nan::Set(obj, Nan::New(names[s]).ToLocalChecked(), array);
+	}
+
+	if(covariance) {
+		Local<Value> array = TypedArray::New(GDT_Float64, n_bands * n_bands);
+		if(array.IsEmpty() || !array->IsObject()) {
+			return scope.Escape(Nan::Undefined()); //TypedArray::New threw an error
+		}
+		double *data = *Nan::TypedArrayContents<double>(array);
+		for(size_t k = 0; k < n_bands; k++) {
+			for(size_t l = k; l < n_bands; l++) {
+				double value = total.n ? total.comoments[k * n_bands + l] / total.n : nan;
+				data[k * n_bands + l] = data[l * n_bands + k] = value;
+			}
+		}
+		Nan::Set(obj, Nan::New("covariance").ToLocalChecked(), array);
+	}
+
+	if(n_percentiles) {
+		Local<Value> array = TypedArray::New(GDT_Float64, n_bands * n_percentiles);
+		if(array.IsEmpty() || !array->IsObject()) {
+			return scope.Escape(Nan::Undefined()); //TypedArray::New threw an error
+		}
+		double *data = *Nan::TypedArrayContents<double>(array);
+		for(size_t k = 0; k < n_bands; k++) {
+			for(size_t j = 0; j < n_percentiles; j++) {
+				data[k * n_percentiles + j] = percentile(k, percentiles[j]);
+			}
+		}
+		Nan::Set(obj, Nan::New("percentiles").ToLocalChecked(), array);
+	}
+
+	return scope.Escape(obj);
+}
+
+}
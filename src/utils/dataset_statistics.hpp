@@ -0,0 +1,88 @@
+#ifndef __DATASET_STATISTICS_H__
+#define __DATASET_STATISTICS_H__
+
+// node
+#include <node.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+#include <vector>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// A class for computing statistics of several bands of a dataset in one
+// pass: count, min, max, mean and stddev of each band, and optionally the
+// covariance matrix and percentiles.
+//
+// Every band is read one tile at a time. Each tile's moments are computed
+// with a two-pass sum over the tile (exact and easy to vectorize), then
+// merged into the running totals with Chan's parallel update, which keeps
+// the result numerically stable however many pixels there are. Nodata and
+// NaN pixels are skipped; the covariance uses only pixels valid in every
+// band.
+//
+// Percentiles are exact for Byte, Int16 and UInt16 bands, which are counted
+// per value during the pass. Other types take a second pass over a 65536
+// bucket histogram between each band's min and max.
+
+class DatasetStatistics {
+public:
+	DatasetStatistics(const std::vector<GDALRasterBand*> &bands, const std::vector<int> &ids, bool covariance, const std::vector<double> &percentiles, bool approx);
+	~DatasetStatistics();
+
+	CPLErr run(GDALProgressFunc progress, void *progress_arg);
+	Local<Value> result();
+
+private:
+	struct Moments {
+		double n, mean, m2, min, max;
+	};
+	struct Tile {
+		std::vector<Moments> bands;
+		// covariance, over pixels valid in every band
+		double n;
+		std::vector<double> means;
+		std::vector<double> comoments;
+	};
+
+	void reset(Tile &tile);
+	void accumulate(Tile &tile, int n);
+	void merge(Tile &into, const Tile &tile);
+	CPLErr readTile(int x, int y, int w, int h);
+	CPLErr scan(bool histogram_pass, double progress_start, double progress_end, GDALProgressFunc progress, void *progress_arg);
+	double percentile(size_t band, double p);
+
+	std::vector<GDALRasterBand*> bands;
+	std::vector<int> ids;
+	bool covariance;
+	std::vector<double> percentiles;
+	bool approx;
+	int width, height;
+	int chunk_w, chunk_h;
+
+	// current tile
+	std::vector<std::vector<double> > values;
+	std::vector<std::vector<char> > valid;
+	std::vector<int> has_nodata;
+	std::vector<double> nodata;
+
+	Tile total;
+
+	// per value counts (exact) or histogram buckets, per band
+	std::vector<std::vector<GUIntBig> > counts;
+	std::vector<bool> exact;
+	std::vector<double> offsets;
+};
+
+}
+
+#endif
@@ -0,0 +1,329 @@
+#include "job_pool.hpp"
+#include "async_worker.hpp"
+
+#define DEFAULT_POOL_SIZE 4
+#define RECENT_JOBS 100
+// time waited before a job is treated as one priority class higher (ns)
+#define PRIORITY_AGING_INTERVAL 2000000000ULL
+
+namespace node_gdal {
+
+static const char *priority_names[PRIORITY_COUNT] = {"interactive", "normal", "background"};
+
+JobPool::JobPool()
+	: complete_async(NULL), threads(), running(), finished(), recent(),
+	  size(DEFAULT_POOL_SIZE), idle(0), yielded(0), stopping(false), interactive_queued(0), interactive_started(0), pending(0),
+	  completed(0), total_wait(0), total_run(0)
+{
+	uv_mutex_init(&lock);
+	uv_cond_init(&cond);
+	uv_cond_init(&yield_cond);
+}
+
+bool JobPool::parsePriority(const std::string &name, JobPriority &priority)
+{
+	for (int i = 0; i < PRIORITY_COUNT; i++) {
+		if (name == priority_names[i]) {
+			priority = static_cast<JobPriority>(i);
+			return true;
+		}
+	}
+	return false;
+}
+
+const char *JobPool::getPriorityName(JobPriority priority)
+{
+	return priority_names[priority];
+}
+
+// Called on the main thread. Takes ownership of the worker.
+void JobPool::queue(AsyncWorker *worker)
+{
+	if (!complete_async) {
+		complete_async = new uv_async_t;
+		uv_async_init(Nan::GetCurrentEventLoop(), complete_async, onComplete);
+		complete_async->data = this;
+		uv_unref(reinterpret_cast<uv_handle_t*>(complete_async));
+	}
+	// keep the loop alive while there is work in flight
+	if (pending++ == 0) {
+		uv_ref(reinterpret_cast<uv_handle_t*>(complete_async));
+	}
+
+	JobPoolItem job;
+	job.worker = worker;
+	job.id = worker->getJobId();
+	job.name = worker->getName();
+	job.priority = worker->getPriority();
+	job.queued_at = uv_hrtime();
+	job.started_at = 0;
+	job.finished_at = 0;
+
+	uv_mutex_lock(&lock);
+	queued[job.priority].push_back(job);
+	if (job.priority == PRIORITY_INTERACTIVE) interactive_queued++;
+	spawnThreads();
+	// threads may be waiting on conditions only some priorities satisfy
+	uv_cond_broadcast(&cond);
+	uv_mutex_unlock(&lock);
+}
+
+// Called on a worker thread between chunks of work. If interactive jobs are
+// waiting for a thread, gives up this job's slot until they have started.
+// The job keeps its dataset locks, so it resumes as soon as the interactive
+// jobs are dequeued rather than when a slot frees up. It doesn't yield if one
+// of them needs a dataset it holds: that job would take the freed slot only
+// to block on the dataset lock, keeping the others (and so this job) waiting.
+void JobPool::yield(AsyncWorker *worker)
+{
+	if (worker->getPriority() == PRIORITY_INTERACTIVE || interactive_queued == 0) return;
+
+	uv_mutex_lock(&lock);
+	std::deque<JobPoolItem> &interactive = queued[PRIORITY_INTERACTIVE];
+	bool can_yield = !stopping && !interactive.empty() && activeCount() >= size;
+	for (unsigned int i = 0; can_yield && i < interactive.size(); i++) {
+		if (worker->sharesDataset(interactive[i].worker)) can_yield = false;
+	}
+	if (can_yield) {
+		uint64_t target = interactive_started + interactive.size();
+		yielded++;
+		spawnThreads();
+		uv_cond_broadcast(&cond);
+		while (!stopping && interactive_started < target) {
+			uv_cond_wait(&yield_cond, &lock);
+		}
+		yielded--;
+	}
+	uv_mutex_unlock(&lock);
+}
+
+void JobPool::setSize(unsigned int size)
+{
+	uv_mutex_lock(&lock);
+	this->size = size;
+	spawnThreads();
+	uv_cond_broadcast(&cond);
+	uv_mutex_unlock(&lock);
+}
+
+// Called on the main thread when the environment is torn down. Waits for
+// running jobs to finish. Jobs still queued or awaiting completion can't call
+// back into JS any more, so they are destroyed without their callbacks, which
+// releases their persistent handles and dataset references.
+void JobPool::shutdown()
+{
+	std::vector<JobPoolItem> dropped;
+
+	uv_mutex_lock(&lock);
+	stopping = true;
+	for (int i = 0; i < PRIORITY_COUNT; i++) {
+		dropped.insert(dropped.end(), queued[i].begin(), queued[i].end());
+		queued[i].clear();
+	}
+	interactive_queued = 0;
+	uv_cond_broadcast(&cond);
+	uv_cond_broadcast(&yield_cond);
+	uv_mutex_unlock(&lock);
+
+	for (unsigned int i = 0; i < threads.size(); i++) {
+		uv_thread_join(&threads[i]);
+	}
+	threads.clear();
+
+	dropped.insert(dropped.end(), finished.begin(), finished.end());
+	finished.clear();
+	for (unsigned int i = 0; i < dropped.size(); i++) {
+		Nan::AsyncWorker *worker = dropped[i].worker;
+		worker->Destroy();
+	}
+	pending = 0;
+
+	if (complete_async) {
+		uv_close(reinterpret_cast<uv_handle_t*>(complete_async), onClose);
+		complete_async = NULL;
+	}
+}
+
+void JobPool::onClose(uv_handle_t *handle)
+{
+	delete reinterpret_cast<uv_async_t*>(handle);
+}
+
+// Must hold the lock
+unsigned int JobPool::activeCount()
+{
+	return running.size() - yielded;
+}
+
+// Must hold the lock
+void JobPool::spawnThreads()
+{
+	unsigned int waiting = 0;
+	for (int i = 0; i < PRIORITY_COUNT; i++) waiting += queued[i].size();
+
+	unsigned int available = idle;
+	while (waiting > available && threads.size() < size + yielded) {
+		uv_thread_t thread;
+		if (uv_thread_create(&thread, threadMain, this) != 0) break;
+		threads.push_back(thread);
+		available++;
+	}
+}
+
+// Must hold the lock. Returns the priority of the queue to take the next job
+// from, or -1 if no job can be started right now.
+int JobPool::nextQueue()
+{
+	unsigned int active = activeCount();
+	if (active >= size) return -1;
+
+	uint64_t now = uv_hrtime();
+	int best = -1;
+	long best_rank = 0;
+	for (int i = 0; i < PRIORITY_COUNT; i++) {
+		if (queued[i].empty()) continue;
+		// leave a thread free for more urgent work
+		if (i == PRIORITY_BACKGROUND && size > 1 && active >= size - 1) continue;
+
+		const JobPoolItem &job = queued[i].front();
+		long rank = i - static_cast<long>((now - job.queued_at) / PRIORITY_AGING_INTERVAL);
+		if (best < 0 || rank < best_rank || (rank == best_rank && job.queued_at < queued[best].front().queued_at)) {
+			best = i;
+			best_rank = rank;
+		}
+	}
+	return best;
+}
+
+void JobPool::threadMain(void *arg)
+{
+	static_cast<JobPool*>(arg)->run();
+}
+
+void JobPool::run()
+{
+	int next;
+
+	uv_mutex_lock(&lock);
+	while (true) {
+		idle++;
+		while (!stopping && (next = nextQueue()) < 0) {
+			uv_cond_wait(&cond, &lock);
+		}
+		idle--;
+		if (stopping) break;
+
+		JobPoolItem job = queued[next].front();
+		queued[next].pop_front();
+		if (next == PRIORITY_INTERACTIVE) {
+			interactive_queued--;
+			interactive_started++;
+			uv_cond_broadcast(&yield_cond);
+		}
+		job.started_at = uv_hrtime();
+		std::list<JobPoolItem>::iterator it = running.insert(running.end(), job);
+		uv_mutex_unlock(&lock);
+
+		// AsyncProgressWorkerBase::Execute() is private, but public in the base
+		static_cast<Nan::AsyncWorker*>(job.worker)->Execute();
+
+		uv_mutex_lock(&lock);
+		job.finished_at = uv_hrtime();
+		running.erase(it);
+		finished.push_back(job);
+		uv_async_send(complete_async);
+		// a slot freed up for jobs held back by the size limit
+		uv_cond_broadcast(&cond);
+	}
+	uv_mutex_unlock(&lock);
+}
+
+void JobPool::onComplete(uv_async_t *handle)
+{
+	JobPool *pool = static_cast<JobPool*>(handle->data);
+	std::vector<JobPoolItem> jobs;
+
+	uv_mutex_lock(&pool->lock);
+	jobs.swap(pool->finished);
+	for (unsigned int i = 0; i < jobs.size(); i++) {
+		pool->completed++;
+		pool->total_wait += jobs[i].started_at - jobs[i].queued_at;
+		pool->total_run += jobs[i].finished_at - jobs[i].started_at;
+		pool->recent.push_back(jobs[i]);
+		if (pool->recent.size() > RECENT_JOBS) pool->recent.pop_front();
+	}
+	uv_mutex_unlock(&pool->lock);
+
+	for (unsigned int i = 0; i < jobs.size(); i++) {
+		Nan::AsyncWorker *worker = jobs[i].worker;
+		worker->WorkComplete();
+		worker->Destroy();
+	}
+
+	pool->pending -= jobs.size();
+	if (jobs.size() > 0 && pool->pending == 0) {
+		uv_unref(reinterpret_cast<uv_handle_t*>(handle));
+	}
+}
+
+Local<Object> JobPool::jobToObject(const JobPoolItem &job, const char *state, uint64_t now)
+{
+	Nan::EscapableHandleScope scope;
+
+	uint64_t started = job.started_at ? job.started_at : now;
+	uint64_t finished = job.finished_at ? job.finished_at : now;
+
+	Local<Object> obj = Nan::New<Object>();
+	Nan::Set(obj, Nan::New("id").ToLocalChecked(), Nan::New<Number>(job.id));
+	Nan::Set(obj, Nan::New("name").ToLocalChecked(), Nan::New(job.name).ToLocalChecked());
+	Nan::Set(obj, Nan::New("priority").ToLocalChecked(), Nan::New(getPriorityName(job.priority)).ToLocalChecked());
+	Nan::Set(obj, Nan::New("state").ToLocalChecked(), Nan::New(state).ToLocalChecked());
+	Nan::Set(obj, Nan::New("waitTime").ToLocalChecked(), Nan::New<Number>((started - job.queued_at) / 1e6));
+	Nan::Set(obj, Nan::New("runTime").ToLocalChecked(), Nan::New<Number>(job.started_at ? (finished - job.started_at) / 1e6 : 0));
+	return scope.Escape(obj);
+}
+
+// Times are in milliseconds
+Local<Object> JobPool::getStats()
+{
+	Nan::EscapableHandleScope scope;
+
+	Local<Object> result = Nan::New<Object>();
+	Local<Array> jobs = Nan::New<Array>();
+	Local<Array> recent_jobs = Nan::New<Array>();
+	uint64_t now = uv_hrtime();
+	unsigned int i = 0, n_queued = 0;
+
+	uv_mutex_lock(&lock);
+
+	for (std::list<JobPoolItem>::iterator it = running.begin(); it != running.end(); ++it) {
+		Nan::Set(jobs, i++, jobToObject(*it, "running", now));
+	}
+	for (int p = 0; p < PRIORITY_COUNT; p++) {
+		for (std::deque<JobPoolItem>::iterator it = queued[p].begin(); it != queued[p].end(); ++it) {
+			Nan::Set(jobs, i++, jobToObject(*it, "queued", now));
+		}
+		n_queued += queued[p].size();
+	}
+	i = 0;
+	for (std::deque<JobPoolItem>::iterator it = recent.begin(); it != recent.end(); ++it) {
+		Nan::Set(recent_jobs, i++, jobToObject(*it, "completed", now));
+	}
+
+	Nan::Set(result, Nan::New("size").ToLocalChecked(), Nan::New<Integer>(size));
+	Nan::Set(result, Nan::New("threads").ToLocalChecked(), Nan::New<Integer>(static_cast<uint32_t>(threads.size())));
+	Nan::Set(result, Nan::New("queued").ToLocalChecked(), Nan::New<Integer>(n_queued));
+	Nan::Set(result, Nan::New("active").ToLocalChecked(), Nan::New<Integer>(activeCount()));
+	Nan::Set(result, Nan::New("yielded").ToLocalChecked(), Nan::New<Integer>(yielded));
+	Nan::Set(result, Nan::New("completed").ToLocalChecked(), Nan::New<Number>(static_cast<double>(completed)));
+	Nan::Set(result, Nan::New("totalWaitTime").ToLocalChecked(), Nan::New<Number>(total_wait / 1e6));
+	Nan::Set(result, Nan::New("totalRunTime").ToLocalChecked(), Nan::New<Number>(total_run / 1e6));
+
+	uv_mutex_unlock(&lock);
+
+	Nan::Set(result, Nan::New("jobs").ToLocalChecked(), jobs);
+	Nan::Set(result, Nan::New("recent").ToLocalChecked(), recent_jobs);
+	return scope.Escape(result);
+}
+
+}
@@ -0,0 +1,109 @@
+#ifndef __JOB_POOL_H__
+#define __JOB_POOL_H__
+
+// node
+#include <node.h>
+#include <uv.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+#include <atomic>
+#include <deque>
+#include <list>
+#include <string>
+#include <vector>
+
+using namespace v8;
+
+namespace node_gdal {
+
+class AsyncWorker;
+
+// Scheduling classes, most urgent first
+enum JobPriority {
+	PRIORITY_INTERACTIVE = 0,
+	PRIORITY_NORMAL,
+	PRIORITY_BACKGROUND,
+	PRIORITY_COUNT
+};
+
+struct JobPoolItem {
+	AsyncWorker *worker;
+	long id;
+	std::string name;
+	JobPriority priority;
+	uint64_t queued_at;
+	uint64_t started_at;
+	uint64_t finished_at;
+};
+
+// Runs AsyncWorkers on threads owned by the addon instead of the libuv
+// threadpool, so long GDAL jobs don't starve fs / dns / zlib work.
+//
+// Threads are started on demand up to the pool size. Shrinking the pool
+// doesn't stop threads; the extra ones stay idle until it grows again.
+// Jobs are completed (callbacks invoked, worker destroyed) on the main
+// thread, like uv_queue_work.
+//
+// Each priority class has its own FIFO queue. The next job is the one with
+// the most urgent priority after aging (one class per PRIORITY_AGING_INTERVAL
+// spent waiting), so background jobs are delayed but never starved.
+// Background jobs are also kept from taking the last free thread. A running
+// job can call yield() between chunks of work to let queued interactive jobs
+// start when every thread is busy. The yielding job keeps its dataset locks,
+// so it doesn't yield to jobs that need one of its datasets, and it only
+// waits until the interactive jobs queued at that point have been started.
+
+class JobPool {
+public:
+	JobPool();
+
+	void queue(AsyncWorker *worker);
+	void yield(AsyncWorker *worker);
+	void setSize(unsigned int size);
+	void shutdown();
+	inline unsigned int getSize() {
+		return size;
+	}
+	Local<Object> getStats();
+
+	static bool parsePriority(const std::string &name, JobPriority &priority);
+	static const char *getPriorityName(JobPriority priority);
+
+private:
+	static void threadMain(void *arg);
+	static void onComplete(uv_async_t *handle);
+	static void onClose(uv_handle_t *handle);
+	void run();
+	void spawnThreads();
+	int nextQueue();
+	unsigned int activeCount();
+	static Local<Object> jobToObject(const JobPoolItem &job, const char *state, uint64_t now);
+
+	uv_mutex_t lock;
+	uv_cond_t cond;
+	uv_cond_t yield_cond;
+	uv_async_t *complete_async;
+	std::vector<uv_thread_t> threads;
+	std::deque<JobPoolItem> queued[PRIORITY_COUNT];
+	std::list<JobPoolItem> running;
+	std::vector<JobPoolItem> finished;  // waiting for completion on the main thread
+	std::deque<JobPoolItem> recent;     // last RECENT_JOBS completed jobs, for stats
+	unsigned int size;
+	unsigned int idle;
+	unsigned int yielded;               // running jobs that gave up their thread
+	bool stopping;
+	std::atomic<unsigned int> interactive_queued;
+	uint64_t interactive_started;       // interactive jobs dequeued so far
+	unsigned int pending;               // jobs queued, running or awaiting completion
+	uint64_t completed;
+	uint64_t total_wait;                // ns
+	uint64_t total_run;                 // ns
+};
+
+}
+#endif
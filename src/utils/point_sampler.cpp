@@ -0,0 +1,239 @@
+#include "point_sampler.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <string>
+#include <vector>
+
+namespace node_gdal {
+
+PointSampler::PointSampler(GDALRasterBand *band, Interpolation interpolation, double nodata)
+	: band(band), interpolation(interpolation), nodata(nodata), has_band_nodata(0), band_nodata(0),
+	  raster_w(band->GetXSize()), raster_h(band->GetYSize()), block_w(0), block_h(0),
+	  type(band->GetRasterDataType()), type_size(GDALGetDataTypeSizeBytes(band->GetRasterDataType())),
+	  block(NULL), block_x(0), block_y(0)
+{
+	band->GetBlockSize(&block_w, &block_h);
+	band_nodata = band->GetNoDataValue(&has_band_nodata);
+}
+
+PointSampler::~PointSampler()
+{
+	unlock();
+}
+
+int PointSampler::parseInterpolation(Local<Value> value, Interpolation &interpolation)
+{
+	if(value->IsUndefined() || value->IsNull()) {
+		interpolation = NEAREST;
+		return 0;
+	}
+	if(!value->IsString()) {
+		Nan::ThrowTypeError("interpolation must be a string");
+		return 1;
+	}
+
+	std::string name = *Nan::Utf8String(value);
+	if(EQUAL(name.c_str(), "nearest")) {
+		interpolation = NEAREST;
+	} else if(EQUAL(name.c_str(), "bilinear")) {
+		interpolation = BILINEAR;
+	} else if(EQUAL(name.c_str(), "cubic")) {
+		interpolation = CUBIC;
+	} else {
+		Nan::ThrowError("interpolation must be \"nearest\", \"bilinear\" or \"cubic\"");
+		return 1;
+	}
+	return 0;
+}
+
+// Transforms coordinates in srs to the dataset's spatial reference, in
+// place. Points that can't be transformed become NaN. Does nothing if srs
+// is NULL.
+CPLErr PointSampler::transform(GDALDataset *ds, OGRSpatialReference *srs, int n, double *x, double *y)
+{
+	if(!srs) return CE_None;
+
+	const char *wkt = ds->GetProjectionRef();
+	OGRSpatialReference ds_srs;
+	if(!wkt || !wkt[0] || ds_srs.importFromWkt(&wkt) != OGRERR_NONE) {
+		CPLError(CE_Failure, CPLE_AppDefined, "Dataset has no spatial reference to transform the points to");
+		return CE_Failure;
+	}
+	if(srs->IsSame(&ds_srs)) return CE_None;
+
+	OGRCoordinateTransformation *ct = OGRCreateCoordinateTransformation(srs, &ds_srs);
+	if(!ct) {
+		return CE_Failure;
+	}
+	std::vector<int> success(n);
+	ct->TransformEx(n, x, y, NULL, n ? &success[0] : NULL);
+	OGRCoordinateTransformation::DestroyCT(ct);
+	for(int i = 0; i < n; i++) {
+		if(!success[i]) x[i] = y[i] = std::numeric_limits<double>::quiet_NaN();
+	}
+	return CE_None;
+}
+
+// Converts georeferenced coordinates in srs (or the dataset's own if NULL)
+// to pixel / line coordinates, in place.
+CPLErr PointSampler::toPixel(GDALDataset *ds, OGRSpatialReference *srs, int n, double *x, double *y)
+{
+	double gt[6], inv_gt[6];
+	if(ds->GetGeoTransform(gt) != CE_None || !GDALInvGeoTransform(gt, inv_gt)) {
+		CPLError(CE_Failure, CPLE_AppDefined, "Dataset has no invertible geotransform");
+		return CE_Failure;
+	}
+
+	CPLErr err = transform(ds, srs, n, x, y);
+	if(err) return err;
+
+	for(int i = 0; i < n; i++) {
+		double geo_x = x[i], geo_y = y[i];
+		x[i] = inv_gt[0] + geo_x * inv_gt[1] + geo_y * inv_gt[2];
+		y[i] = inv_gt[3] + geo_x * inv_gt[4] + geo_y * inv_gt[5];
+	}
+	return CE_None;
+}
+
+CPLErr PointSampler::sample(double x, double y, double &value)
+{
+	if(!(x >= 0 && y >= 0 && x < raster_w && y < raster_h)) {
+		value = nodata;
+		return CE_None;
+	}
+
+	switch(interpolation) {
+		case BILINEAR:
+			return bilinear(x, y, value);
+		case CUBIC:
+			return cubic(x, y, value);
+		default: {
+			bool valid;
+			CPLErr err = pixel(static_cast<int>(x), static_cast<int>(y), value, valid);
+			if(!valid) value = nodata;
+			return err;
+		}
+	}
+}
+
+// Samples the points in the order their blocks are stored, so each block is
+// read once however the points are ordered.
+CPLErr PointSampler::sample(int n, const double *x, const double *y, double *values)
+{
+	std::vector<int> order(n);
+	std::vector<long> keys(n);
+	for(int i = 0; i < n; i++) {
+		order[i] = i;
+		keys[i] = blockKey(x[i], y[i]);
+	}
+	std::stable_sort(order.begin(), order.end(), [&keys](int a, int b) { return keys[a] < keys[b]; });
+
+	for(int i = 0; i < n; i++) {
+		int j = order[i];
+		CPLErr err = sample(x[j], y[j], values[j]);
+		if(err) return err;
+	}
+	return CE_None;
+}
+
+long PointSampler::blockKey(double x, double y)
+{
+	if(!(x >= 0 && y >= 0 && x < raster_w && y < raster_h)) return -1;
+	long blocks_per_row = (raster_w + block_w - 1) / block_w;
+	return (static_cast<long>(y) / block_h) * blocks_per_row + static_cast<long>(x) / block_w;
+}
+
+// Reads a pixel, clamped to the raster. valid is false for nodata pixels.
+CPLErr PointSampler::pixel(int x, int y, double &value, bool &valid)
+{
+	x = std::min(std::max(x, 0), raster_w - 1);
+	y = std::min(std::max(y, 0), raster_h - 1);
+
+	int bx = x / block_w;
+	int by = y / block_h;
+	if(!block || bx != block_x || by != block_y) {
+		unlock();
+		block = band->GetLockedBlockRef(bx, by);
+		if(!block) {
+			valid = false;
+			return CE_Failure;
+		}
+		block_x = bx;
+		block_y = by;
+	}
+
+	int offset = (y - by * block_h) * block_w + (x - bx * block_w);
+	GDALCopyWords(static_cast<GByte*>(block->GetDataRef()) + offset * type_size, type, 0, &value, GDT_Float64, 0, 1);
+	valid = !std::isnan(value) && !(has_band_nodata && value == band_nodata);
+	return CE_None;
+}
+
+// Weighs the four nearest pixels, leaving out nodata ones
+CPLErr PointSampler::bilinear(double x, double y, double &value)
+{
+	double u = x - 0.5, v = y - 0.5;
+	int x0 = static_cast<int>(std::floor(u));
+	int y0 = static_cast<int>(std::floor(v));
+	double fx = u - x0, fy = v - y0;
+
+	double sum = 0, weights = 0;
+	for(int j = 0; j < 2; j++) {
+		for(int i = 0; i < 2; i++) {
+			double w = (i ? fx : 1 - fx) * (j ? fy : 1 - fy);
+			double pixel_value;
+			bool valid;
+			CPLErr err = pixel(x0 + i, y0 + j, pixel_value, valid);
+			if(err) return err;
+			if(valid && w > 0) {
+				sum += w * pixel_value;
+				weights += w;
+			}
+		}
+	}
+
+	value = weights > 0 ? sum / weights : nodata;
+	return CE_None;
+}
+
+// Cubic convolution kernel (a = -0.5)
+static double cubicWeight(double t)
+{
+	t = std::fabs(t);
+	if(t <= 1) return (1.5 * t - 2.5) * t * t + 1;
+	if(t < 2) return ((-0.5 * t + 2.5) * t - 4) * t + 2;
+	return 0;
+}
+
+CPLErr PointSampler::cubic(double x, double y, double &value)
+{
+	double u = x - 0.5, v = y - 0.5;
+	int x0 = static_cast<int>(std::floor(u));
+	int y0 = static_cast<int>(std::floor(v));
+	double fx = u - x0, fy = v - y0;
+
+	double sum = 0;
+	for(int j = -1; j < 3; j++) {
+		double wy = cubicWeight(fy - j);
+		for(int i = -1; i < 3; i++) {
+			double pixel_value;
+			bool valid;
+			CPLErr err = pixel(x0 + i, y0 + j, pixel_value, valid);
+			if(err) return err;
+			if(!valid) return bilinear(x, y, value);
+			sum += wy * cubicWeight(fx - i) * pixel_value;
+		}
+	}
+
+	value = sum;
+	return CE_None;
+}
+
+void PointSampler::unlock()
+{
+	if(block) block->DropLock();
+	block = NULL;
+}
+
+}
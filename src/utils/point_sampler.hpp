@@ -0,0 +1,70 @@
+#ifndef __POINT_SAMPLER_H__
+#define __POINT_SAMPLER_H__
+
+// node
+#include <node.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+// ogr
+#include <ogr_spatialref.h>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// A class for sampling a band at fractional pixel / line coordinates,
+// reading pixels straight from the band's block cache. One block is kept
+// locked between pixels, so the caller must hold the dataset lock for the
+// lifetime of the sampler.
+//
+// Pixel centers are at (x + 0.5, y + 0.5). Points outside the raster, and
+// points whose pixels are all nodata, get the `nodata` value passed to the
+// constructor. Bilinear interpolation ignores nodata pixels; cubic
+// interpolation falls back to bilinear near them.
+
+class PointSampler {
+public:
+	enum Interpolation { NEAREST, BILINEAR, CUBIC };
+
+	static int parseInterpolation(Local<Value> value, Interpolation &interpolation);
+	static CPLErr transform(GDALDataset *ds, OGRSpatialReference *srs, int n, double *x, double *y);
+	static CPLErr toPixel(GDALDataset *ds, OGRSpatialReference *srs, int n, double *x, double *y);
+
+	PointSampler(GDALRasterBand *band, Interpolation interpolation, double nodata);
+	~PointSampler();
+
+	CPLErr sample(double x, double y, double &value);
+	CPLErr sample(int n, const double *x, const double *y, double *values);
+
+private:
+	CPLErr pixel(int x, int y, double &value, bool &valid);
+	CPLErr bilinear(double x, double y, double &value);
+	CPLErr cubic(double x, double y, double &value);
+	long blockKey(double x, double y);
+	void unlock();
+
+	GDALRasterBand *band;
+	Interpolation interpolation;
+	double nodata;
+	int has_band_nodata;
+	double band_nodata;
+	int raster_w, raster_h;
+	int block_w, block_h;
+	GDALDataType type;
+	int type_size;
+	// currently locked block
+	GDALRasterBlock *block;
+	int block_x, block_y;
+};
+
+}
+
+#endif
@@ -3,12 +3,18 @@
 #include "../gdal_rasterband.hpp"
 #include "../gdal_layer.hpp"
 
+#include <algorithm>
 #include <sstream>
 
 namespace node_gdal {
 
+static bool compareDatasetItems(PtrManagerDatasetItem *a, PtrManagerDatasetItem *b)
+{
+	return a->uid < b->uid;
+}
+
 PtrManager::PtrManager()
-	: uid(1), layers(), bands(), datasets()
+	: uid(1), layers(), blocks(), bands(), datasets()
 {
 }
 
@@ -19,7 +25,7 @@ PtrManager::~PtrManager()
 bool PtrManager::isAlive(long uid)
 {
 	if(uid == 0) return true;
-	return bands.count(uid) > 0 || layers.count(uid) > 0 || datasets.count(uid) > 0; 
+	return bands.count(uid) > 0 || layers.count(uid) > 0 || datasets.count(uid) > 0 || blocks.count(uid) > 0;
 }
 
 long PtrManager::add(OGRLayer* ptr, long parent_uid, bool is_result_set)
@@ -49,11 +55,30 @@ long PtrManager::add(GDALRasterBand* ptr, long parent_uid)
 	return item->uid;
 }
 
+// Takes over a lock on the block. The lock is dropped and the buffer aliasing
+// it detached when the block is disposed, at the latest when its dataset is
+// closed.
+long PtrManager::add(GDALRasterBlock* ptr, long parent_uid, Local<ArrayBuffer> buffer)
+{
+	PtrManagerBlockItem *item = new PtrManagerBlockItem();
+	item->uid = uid++;
+	item->parent = getDatasetItem(parent_uid);
+	item->ptr = ptr;
+	item->buffer.Reset(buffer);
+	item->buffer.SetWeak();
+	blocks[item->uid] = item;
+
+	item->parent->blocks.push_back(item);
+	return item->uid;
+}
+
 long PtrManager::add(GDALDataset* ptr)
 {
 	PtrManagerDatasetItem *item = new PtrManagerDatasetItem();
 	item->uid = uid++;
 	item->ptr = ptr;
+	item->async_refs = 0;
+	uv_mutex_init(&item->async_lock);
 	datasets[item->uid] = item;
 	return item->uid;
 }
@@ -64,22 +89,100 @@ long PtrManager::add(OGRDataSource* ptr)
 	PtrManagerDatasetItem *item = new PtrManagerDatasetItem();
 	item->uid = uid++;
 	item->ptr_datasource = ptr;
+	item->async_refs = 0;
+	uv_mutex_init(&item->async_lock);
 	datasets[item->uid] = item;
 	return item->uid;
 }
 #endif
 
+// Returns the dataset owning the given dataset, band, or layer uid
+PtrManagerDatasetItem* PtrManager::getDatasetItem(long uid)
+{
+	if(datasets.count(uid)) return datasets[uid];
+	if(bands.count(uid)) return bands[uid]->parent;
+	if(layers.count(uid)) return layers[uid]->parent;
+	if(blocks.count(uid)) return blocks[uid]->parent;
+	return NULL;
+}
+
+// Keeps the dataset item from being freed until release() is called. The
+// dataset itself may still be closed in the meantime: check isDatasetOpen()
+// while holding the item's lock.
+PtrManagerDatasetItem* PtrManager::acquire(long uid)
+{
+	PtrManagerDatasetItem *item = getDatasetItem(uid);
+	if(item) item->async_refs++;
+	return item;
+}
+
+void PtrManager::release(PtrManagerDatasetItem* item)
+{
+	item->async_refs--;
+	if(item->async_refs == 0 && !datasets.count(item->uid)) {
+		uv_mutex_destroy(&item->async_lock);
+		delete item;
+	}
+}
+
+bool PtrManager::isDatasetOpen(PtrManagerDatasetItem* item)
+{
+	#if GDAL_VERSION_MAJOR < 2
+	if(item->ptr_datasource) return true;
+	#endif
+	return item->ptr != NULL;
+}
+
 void PtrManager::dispose(long uid)
 {
 	if(datasets.count(uid)) dispose(datasets[uid]);
 	else if(layers.count(uid)) dispose(layers[uid]);
 	else if(bands.count(uid)) dispose(bands[uid]);
+	else if(blocks.count(uid)) dispose(blocks[uid]);
+}
+
+// Unlocks a pinned block. detach is false when its array is being collected.
+void PtrManager::releaseBlock(long uid, bool detach)
+{
+	if(blocks.count(uid)) dispose(blocks[uid], detach);
+}
+
+// Unlocks the blocks pinned from the dataset owning uid (only those of band,
+// if given). GDAL waits for blocks to be unlocked before flushing them.
+void PtrManager::releaseBlocks(long uid, GDALRasterBand *band)
+{
+	PtrManagerDatasetItem *item = getDatasetItem(uid);
+	if(!item) return;
+
+	std::list<PtrManagerBlockItem*>::iterator it = item->blocks.begin();
+	while(it != item->blocks.end()) {
+		PtrManagerBlockItem *block = *it++;
+		if(!band || block->ptr->GetBand() == band) {
+			dispose(block);
+		}
+	}
+}
+
+// Closes every dataset (and its bands and layers)
+void PtrManager::disposeAll()
+{
+	while(!datasets.empty()){
+		dispose(datasets.begin()->second);
+	}
 }
 
 void PtrManager::dispose(PtrManagerDatasetItem* item)
 {
+	// before waiting on jobs, which may be flushing a pinned block
+	while(!item->blocks.empty()){
+		dispose(item->blocks.back());
+	}
+
 	datasets.erase(item->uid);
 
+	// wait for any job currently using the dataset to finish
+	uv_mutex_lock(&item->async_lock);
+
 	while(!item->layers.empty()){
    		dispose(item->layers.back());
 	}
@@ -98,7 +201,17 @@ void PtrManager::dispose(PtrManagerDatasetItem* item)
 		GDALClose(item->ptr);
 	}
 
-	delete item;
+	// jobs that haven't started yet will see the dataset is gone
+	item->ptr = NULL;
+	#if GDAL_VERSION_MAJOR < 2
+	item->ptr_datasource = NULL;
+	#endif
+	uv_mutex_unlock(&item->async_lock);
+
+	if(item->async_refs == 0) {
+		uv_mutex_destroy(&item->async_lock);
+		delete item;
+	}
 }
 
 void PtrManager::dispose(PtrManagerRasterBandItem* item)
@@ -109,6 +222,29 @@ void PtrManager::dispose(PtrManagerRasterBandItem* item)
 	delete item;
 }
 
+void PtrManager::dispose(PtrManagerBlockItem* item, bool detach)
+{
+	item->ptr->DropLock();
+
+	// arrays viewing the buffer must not touch the block anymore
+	if(detach && !item->buffer.IsEmpty()) {
+		Nan::HandleScope scope;
+		Local<ArrayBuffer> buffer = Nan::New(item->buffer);
+		#if V8_MAJOR_VERSION >= 11
+		buffer->Detach(Local<Value>()).Check();
+		#elif V8_MAJOR_VERSION > 7 || (V8_MAJOR_VERSION == 7 && V8_MINOR_VERSION >= 3)
+		buffer->Detach();
+		#else
+		buffer->Neuter();
+		#endif
+	}
+	item->buffer.Reset();
+
+	blocks.erase(item->uid);
+	item->parent->blocks.remove(item);
+	delete item;
+}
+
 void PtrManager::dispose(PtrManagerLayerItem* item)
 {
 	Layer::cache.erase(item->ptr);
@@ -128,4 +264,38 @@ void PtrManager::dispose(PtrManagerLayerItem* item)
 	delete item;
 }
 
+DatasetLock::DatasetLock(long uid)
+	: items()
+{
+	PtrManagerDatasetItem *item = ptr_manager.getDatasetItem(uid);
+	if(item) {
+		items.push_back(item);
+		uv_mutex_lock(&item->async_lock);
+	}
+}
+
+// Locks in the same order as AsyncWorker::Execute, so a synchronous call
+// can't deadlock with a job using the same datasets
+DatasetLock::DatasetLock(const std::vector<long> &uids)
+	: items()
+{
+	for(unsigned int i = 0; i < uids.size(); i++) {
+		PtrManagerDatasetItem *item = ptr_manager.getDatasetItem(uids[i]);
+		if(item && std::find(items.begin(), items.end(), item) == items.end()) {
+			items.push_back(item);
+		}
+	}
+	std::sort(items.begin(), items.end(), compareDatasetItems);
+	for(unsigned int i = 0; i < items.size(); i++) {
+		uv_mutex_lock(&items[i]->async_lock);
+	}
+}
+
+DatasetLock::~DatasetLock()
+{
+	for(unsigned int i = items.size(); i > 0; i--) {
+		uv_mutex_unlock(&items[i - 1]->async_lock);
+	}
+}
+
 }
\ No newline at end of file
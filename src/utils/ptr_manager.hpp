@@ -19,6 +19,7 @@
 
 #include <map>
 #include <list>
+#include <vector>
 
 using namespace v8;
 
@@ -36,14 +37,25 @@ struct PtrManagerRasterBandItem {
 	GDALRasterBand *ptr;
 };
 
+// A block pinned in the GDAL block cache, aliased by a JS typed array
+struct PtrManagerBlockItem {
+	long uid;
+	PtrManagerDatasetItem *parent;
+	GDALRasterBlock *ptr;
+	Nan::Persistent<ArrayBuffer> buffer;  // weak
+};
+
 struct PtrManagerDatasetItem {
 	long uid;
 	std::list<PtrManagerLayerItem*> layers;
 	std::list<PtrManagerRasterBandItem*> bands;
+	std::list<PtrManagerBlockItem*> blocks;
 	GDALDataset *ptr;
 	#if GDAL_VERSION_MAJOR < 2
 	OGRDataSource *ptr_datasource;
 	#endif
+	uv_mutex_t async_lock;  // held while GDAL is using the dataset
+	int async_refs;         // pending async jobs, the item outlives dispose() while > 0
 };
 
 namespace node_gdal {
@@ -58,8 +70,16 @@ public:
 	#endif
 	long add(GDALRasterBand* ptr, long parent_uid);
 	long add(OGRLayer* ptr, long parent_uid, bool is_result_set);
+	long add(GDALRasterBlock* ptr, long parent_uid, Local<ArrayBuffer> buffer);
 	void dispose(long uid);
+	void releaseBlock(long uid, bool detach = true);
+	void releaseBlocks(long uid, GDALRasterBand *band = NULL);
+	void disposeAll();
 	bool isAlive(long uid);
+	PtrManagerDatasetItem* getDatasetItem(long uid);
+	PtrManagerDatasetItem* acquire(long uid);
+	void release(PtrManagerDatasetItem* item);
+	static bool isDatasetOpen(PtrManagerDatasetItem* item);
 
 	PtrManager();
 	~PtrManager();
@@ -68,11 +88,31 @@ private:
 	void dispose(PtrManagerLayerItem* item);
 	void dispose(PtrManagerRasterBandItem* item);
 	void dispose(PtrManagerDatasetItem* item);
+	void dispose(PtrManagerBlockItem* item, bool detach = true);
 	std::map<long, PtrManagerLayerItem*> layers;
+	std::map<long, PtrManagerBlockItem*> blocks;
 	std::map<long, PtrManagerRasterBandItem*> bands;
 	std::map<long, PtrManagerDatasetItem*> datasets;
 };
 
+// Holds the dataset lock for the lifetime of the object, so synchronous
+// calls don't run concurrently with a job on the threadpool
+//
+// usage:
+//   DatasetLock lock(band->uid);
+//   DatasetLock lock({src->uid, dst->uid});  // locked in uid order
+//
+// Uids of 0 (optional arguments) are skipped.
+
+class DatasetLock {
+public:
+	DatasetLock(long uid);
+	DatasetLock(const std::vector<long> &uids);
+	~DatasetLock();
+private:
+	std::vector<PtrManagerDatasetItem*> items;
+};
+
 }
 
 #endif
\ No newline at end of file
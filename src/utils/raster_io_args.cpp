@@ -0,0 +1,88 @@
+#include "raster_io_args.hpp"
+
+#include <cmath>
+#include <climits>
+
+namespace node_gdal {
+
+RasterIOArgs::RasterIOArgs()
+	: x_off(0), y_off(0), x_size(0), y_size(0)
+{
+	INIT_RASTERIO_EXTRA_ARG(extra);
+}
+
+RasterIOArgs::~RasterIOArgs()
+{}
+
+int RasterIOArgs::parseWindow(Local<Value> x, Local<Value> y, Local<Value> w, Local<Value> h)
+{
+	if(!x->IsNumber()) { Nan::ThrowTypeError("x_offset must be a number"); return 1; }
+	if(!y->IsNumber()) { Nan::ThrowTypeError("y_offset must be a number"); return 1; }
+	if(!w->IsNumber()) { Nan::ThrowTypeError("x_size must be a number"); return 1; }
+	if(!h->IsNumber()) { Nan::ThrowTypeError("y_size must be a number"); return 1; }
+
+	double df_x = Nan::To<double>(x).ToChecked();
+	double df_y = Nan::To<double>(y).ToChecked();
+	double df_w = Nan::To<double>(w).ToChecked();
+	double df_h = Nan::To<double>(h).ToChecked();
+
+	if(!std::isfinite(df_x) || !std::isfinite(df_y) || !std::isfinite(df_w) || !std::isfinite(df_h)
+		|| std::fabs(df_x) > INT_MAX || std::fabs(df_y) > INT_MAX
+		|| std::fabs(df_x + df_w) > INT_MAX || std::fabs(df_y + df_h) > INT_MAX) {
+		Nan::ThrowRangeError("Invalid window");
+		return 1;
+	}
+
+	x_off  = static_cast<int>(std::floor(df_x));
+	y_off  = static_cast<int>(std::floor(df_y));
+	x_size = static_cast<int>(std::ceil(df_x + df_w)) - x_off;
+	y_size = static_cast<int>(std::ceil(df_y + df_h)) - y_off;
+
+	if(x_off != df_x || y_off != df_y || x_size != df_w || y_size != df_h) {
+		extra.bFloatingPointWindowValidity = TRUE;
+		extra.dfXOff = df_x;
+		extra.dfYOff = df_y;
+		extra.dfXSize = df_w;
+		extra.dfYSize = df_h;
+	}
+	return 0;
+}
+
+int RasterIOArgs::parseResampling(Local<Value> value)
+{
+	if(value->IsUndefined() || value->IsNull()) {
+		extra.eResampleAlg = GRIORA_NearestNeighbour;
+		return 0;
+	}
+	if(!value->IsString()) {
+		Nan::ThrowTypeError("resampling must be a string");
+		return 1;
+	}
+	std::string name = *Nan::Utf8String(value);
+	const char *str = name.c_str();
+
+	if(EQUAL(str, "Nearest") || EQUAL(str, "NearestNeighbor") || EQUAL(str, "NearestNeighbour")) {
+		extra.eResampleAlg = GRIORA_NearestNeighbour; return 0;
+	}
+	if(EQUAL(str, "Bilinear")) {    extra.eResampleAlg = GRIORA_Bilinear; return 0; }
+	if(EQUAL(str, "Cubic")) {       extra.eResampleAlg = GRIORA_Cubic; return 0; }
+	if(EQUAL(str, "CubicSpline")) { extra.eResampleAlg = GRIORA_CubicSpline; return 0; }
+	if(EQUAL(str, "Lanczos")) {     extra.eResampleAlg = GRIORA_Lanczos; return 0; }
+	if(EQUAL(str, "Average")) {     extra.eResampleAlg = GRIORA_Average; return 0; }
+	if(EQUAL(str, "Mode")) {        extra.eResampleAlg = GRIORA_Mode; return 0; }
+	if(EQUAL(str, "Gauss")) {       extra.eResampleAlg = GRIORA_Gauss; return 0; }
+
+	Nan::ThrowError("Invalid resampling algorithm");
+	return 1;
+}
+
+void RasterIOArgs::setStats(Local<Object> stats, int overview, int w, int h, int band_count, GDALDataType type)
+{
+	Nan::HandleScope scope;
+
+	double bytes = (double) w * h * band_count * GDALGetDataTypeSizeBytes(type);
+	Nan::Set(stats, Nan::New("overview").ToLocalChecked(), Nan::New<Integer>(overview));
+	Nan::Set(stats, Nan::New("bytesDecoded").ToLocalChecked(), Nan::New<Number>(bytes));
+}
+
+}
@@ -0,0 +1,67 @@
+#ifndef __RASTER_IO_ARGS_H__
+#define __RASTER_IO_ARGS_H__
+
+// node
+#include <node.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// A class for parsing the source window and resampling of a RasterIO read
+// and constructing the GDALRasterIOExtraArg struct for it
+//
+// see: http://www.gdal.org/structGDALRasterIOExtraArg.html
+//
+// The window may have fractional coordinates. GDAL then reads the smallest
+// integer window containing it and resamples from the exact window.
+//
+// setStats() fills the `stats` object reads take, describing the source
+// window actually read (after any overview selection):
+//
+// {
+//   overview : int  (-1 for full resolution)
+//   bytesDecoded : number
+// }
+
+class RasterIOArgs {
+public:
+	int parseWindow(Local<Value> x, Local<Value> y, Local<Value> w, Local<Value> h);
+	int parseResampling(Local<Value> value);
+	static void setStats(Local<Object> stats, int overview, int w, int h, int band_count, GDALDataType type);
+
+	RasterIOArgs();
+	~RasterIOArgs();
+
+	inline GDALRasterIOExtraArg* get() {
+		return &extra;
+	}
+	inline int x() {
+		return x_off;
+	}
+	inline int y() {
+		return y_off;
+	}
+	inline int width() {
+		return x_size;
+	}
+	inline int height() {
+		return y_size;
+	}
+private:
+	GDALRasterIOExtraArg extra;
+	int x_off, y_off, x_size, y_size;
+};
+
+}
+
+#endif
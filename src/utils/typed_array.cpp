@@ -6,22 +6,24 @@ namespace node_gdal {
 
 //https://github.com/joyent/node/issues/4201#issuecomment-9837340
 
-Local<Value> TypedArray::New(GDALDataType type, unsigned int length)  {
+// If shared is true, the array is backed by a SharedArrayBuffer so it can be
+// posted to worker threads without copying.
+Local<Value> TypedArray::New(GDALDataType type, unsigned int length, bool shared)  {
 	Nan::EscapableHandleScope scope;
 
 	Local<Value> val;
 	Local<Function> constructor;
 	Local<Object> global = Nan::GetCurrentContext()->Global();
 
-	const char *name;
 	switch(type) {
-		case GDT_Byte:    name = "Uint8Array";   break;
-		case GDT_Int16:   name = "Int16Array";   break;
-		case GDT_UInt16:  name = "Uint16Array";  break;
-		case GDT_Int32:   name = "Int32Array";   break;
-		case GDT_UInt32:  name = "Uint32Array";  break;
-		case GDT_Float32: name = "Float32Array"; break;
-		case GDT_Float64: name = "Float64Array"; break;
+		case GDT_Byte:
+		case GDT_Int16:
+		case GDT_UInt16:
+		case GDT_Int32:
+		case GDT_UInt32:
+		case GDT_Float32:
+		case GDT_Float64:
+			break;
 		default: 
 			Nan::ThrowError("Unsupported array type"); 
 			return scope.Escape(Nan::Undefined());
@@ -29,10 +31,10 @@ Local<Value> TypedArray::New(GDALDataType type, unsigned int length)  {
 
 
 	// make ArrayBuffer
-	val = Nan::Get(global, Nan::New("ArrayBuffer").ToLocalChecked()).ToLocalChecked();
+	val = Nan::Get(global, Nan::New(shared ? "SharedArrayBuffer" : "ArrayBuffer").ToLocalChecked()).ToLocalChecked();
 
 	if(val.IsEmpty() || !val->IsFunction()) {
-		Nan::ThrowError("Error getting ArrayBuffer constructor");
+		Nan::ThrowError(shared ? "SharedArrayBuffer is not available" : "Error getting ArrayBuffer constructor");
 		return scope.Escape(Nan::Undefined());
 	}
 
@@ -45,6 +47,30 @@ Local<Value> TypedArray::New(GDALDataType type, unsigned int length)  {
 		return scope.Escape(Nan::Undefined());
 	}
 
+	return scope.Escape(New(type, array_buffer.As<Object>()));
+}
+
+// Creates a TypedArray viewing the whole of an existing ArrayBuffer
+Local<Value> TypedArray::New(GDALDataType type, Local<Object> array_buffer)  {
+	Nan::EscapableHandleScope scope;
+
+	Local<Value> val;
+	Local<Function> constructor;
+	Local<Object> global = Nan::GetCurrentContext()->Global();
+
+	const char *name;
+	switch(type) {
+		case GDT_Byte:    name = "Uint8Array";   break;
+		case GDT_Int16:   name = "Int16Array";   break;
+		case GDT_UInt16:  name = "Uint16Array";  break;
+		case GDT_Int32:   name = "Int32Array";   break;
+		case GDT_UInt32:  name = "Uint32Array";  break;
+		case GDT_Float32: name = "Float32Array"; break;
+		case GDT_Float64: name = "Float64Array"; break;
+		default: 
+			Nan::ThrowError("Unsupported array type"); 
+			return scope.Escape(Nan::Undefined());
+	}
 
 	// make TypedArray
 	val = Nan::Get(global, Nan::New(name).ToLocalChecked()).ToLocalChecked();
@@ -55,7 +81,8 @@ Local<Value> TypedArray::New(GDALDataType type, unsigned int length)  {
 	}
 
 	constructor = val.As<Function>();
-	Local<Object> array = Nan::NewInstance(constructor, 1, &array_buffer).ToLocalChecked();
+	Local<Value> buffer_arg = array_buffer;
+	Local<Object> array = Nan::NewInstance(constructor, 1, &buffer_arg).ToLocalChecked();
 
 	if(array.IsEmpty() || !array->IsObject()) {
 		Nan::ThrowError("Error creating TypedArray");
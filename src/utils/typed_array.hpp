@@ -48,7 +48,8 @@ namespace node_gdal {
 
 namespace TypedArray {
 
-	Local<Value> New(GDALDataType type, unsigned int length);
+	Local<Value> New(GDALDataType type, unsigned int length, bool shared = false);
+	Local<Value> New(GDALDataType type, Local<Object> array_buffer);
 	GDALDataType Identify(Local<Object> array);
 	void* Validate(Local<Object> obj, GDALDataType type, int min_length);
 	bool ValidateLength(int length, int min_length);
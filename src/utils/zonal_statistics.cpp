@@ -0,0 +1,441 @@
+#include "zonal_statistics.hpp"
+#include "typed_array.hpp"
+
+#include <cpl_string.h>
+#include <gdal_alg.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <string>
+
+// bounds on the size of the chunks a zone's window is split into along each
+// axis, so bands with one-row blocks aren't rasterized a row at a time
+#define ZONAL_CHUNK_MIN 256
+#define ZONAL_CHUNK_MAX 1024
+
+namespace node_gdal {
+
+static const struct { const char *name; int stat; } stat_names[] = {
+	{"count", ZonalStatistics::COUNT},
+	{"sum", ZonalStatistics::SUM},
+	{"mean", ZonalStatistics::MEAN},
+	{"min", ZonalStatistics::MIN},
+	{"max", ZonalStatistics::MAX},
+	{"stddev", ZonalStatistics::STDDEV},
+	{"histogram", ZonalStatistics::HISTOGRAM}
+};
+
+// Rounds a block dimension to a scratch chunk dimension that is a multiple of
+// it where practical
+static int chunkSize(int block, int raster)
+{
+	int size = block;
+	if(size < ZONAL_CHUNK_MIN) size = ((ZONAL_CHUNK_MIN + block - 1) / block) * block;
+	else if(size > ZONAL_CHUNK_MAX) size = ZONAL_CHUNK_MAX;
+	return std::min(size, raster);
+}
+
+ZonalStatistics::ZonalStatistics(OGRLayer *layer, GDALRasterBand *band, GDALRasterBand *weights, int stats, bool all_touched)
+	: layer(layer), band(band), weights(weights), stats(stats), all_touched(all_touched), buckets(0), hist_min(0), hist_max(0),
+	  raster_w(band->GetXSize()), raster_h(band->GetYSize()), block_w(0), block_h(0),
+	  has_nodata(0), has_weights_nodata(0), nodata(0), weights_nodata(0), threads(1),
+	  zones(), groups(), next_group(0), zones_done(0), stopped(false), mem_driver(NULL), thread_error()
+{
+	int bw, bh;
+	band->GetBlockSize(&bw, &bh);
+	block_w = chunkSize(bw, raster_w);
+	block_h = chunkSize(bh, raster_h);
+	uv_mutex_init(&io_lock);
+}
+
+ZonalStatistics::~ZonalStatistics()
+{
+	for(size_t i = 0; i < zones.size(); i++) delete zones[i].geometry;
+	uv_mutex_destroy(&io_lock);
+}
+
+int ZonalStatistics::parseStats(Local<Value> value, int &stats)
+{
+	if(value->IsUndefined() || value->IsNull()) {
+		stats = COUNT | SUM | MEAN | MIN | MAX | STDDEV;
+		return 0;
+	}
+	if(!value->IsArray()) {
+		Nan::ThrowTypeError("stats must be an array of strings");
+		return 1;
+	}
+
+	Local<Array> array = value.As<Array>();
+	stats = 0;
+	for(unsigned int i = 0; i < array->Length(); i++) {
+		Local<Value> item = Nan::Get(array, i).ToLocalChecked();
+		std::string name = *Nan::Utf8String(item);
+		int stat = 0;
+		for(unsigned int j = 0; j < sizeof(stat_names) / sizeof(stat_names[0]); j++) {
+			if(item->IsString() && name == stat_names[j].name) stat = stat_names[j].stat;
+		}
+		if(!stat) {
+			Nan::ThrowError(("Unknown statistic \"" + name + "\"").c_str());
+			return 1;
+		}
+		stats |= stat;
+	}
+	return 0;
+}
+
+void ZonalStatistics::setHistogram(int n, double min, double max)
+{
+	buckets = n;
+	hist_min = min;
+	hist_max = max;
+}
+
+void ZonalStatistics::setThreads(int n)
+{
+	threads = n < 1 ? 1 : n;
+}
+
+// Wraps a buffer in a Byte MEM dataset covering the w x h pixels of the band
+// at (x, y), to rasterize a zone into
+static GDALDataset* createMask(GDALDriver *driver, GByte *data, int x, int y, int w, int h, const double *gt)
+{
+	GDALDataset *ds = driver->Create("", w, h, 0, GDT_Byte, NULL);
+	if(!ds) return NULL;
+
+	char pointer[64];
+	int n = CPLPrintPointer(pointer, data, sizeof(pointer));
+	pointer[n] = '\0';
+	char **options = CSLSetNameValue(NULL, "DATAPOINTER", pointer);
+	CPLErr err = ds->AddBand(GDT_Byte, options);
+	CSLDestroy(options);
+	if(err) {
+		GDALClose(ds);
+		return NULL;
+	}
+
+	double mask_gt[6] = {
+		gt[0] + x * gt[1] + y * gt[2], gt[1], gt[2],
+		gt[3] + x * gt[4] + y * gt[5], gt[4], gt[5]
+	};
+	ds->SetGeoTransform(mask_gt);
+	return ds;
+}
+
+CPLErr ZonalStatistics::run(GDALProgressFunc progress, void *progress_arg)
+{
+	CPLErr err = readZones();
+
+	size_t n = fids.size();
+	counts.assign(n, 0);
+	sums.assign(n, 0);
+	weight_sums.assign(n, 0);
+	means.assign(n, 0);
+	m2s.assign(n, 0);
+	mins.assign(n, std::numeric_limits<double>::infinity());
+	maxs.assign(n, -std::numeric_limits<double>::infinity());
+	if(stats & HISTOGRAM) histograms.assign(n * buckets, 0);
+
+	if(err || zones.empty()) {
+		if(!err && progress) progress(1.0, NULL, progress_arg);
+		return err;
+	}
+
+	mem_driver = GetGDALDriverManager()->GetDriverByName("MEM");
+	if(!mem_driver) {
+		CPLError(CE_Failure, CPLE_AppDefined, "MEM driver not available");
+		return CE_Failure;
+	}
+	nodata = band->GetNoDataValue(&has_nodata);
+	if(weights) weights_nodata = weights->GetNoDataValue(&has_weights_nodata);
+
+	std::stable_sort(zones.begin(), zones.end(), [](const Zone &a, const Zone &b) { return a.bucket < b.bucket; });
+	groups.clear();
+	for(size_t i = 0; i < zones.size(); i++) {
+		if(i == 0 || zones[i].bucket != zones[i - 1].bucket) groups.push_back(i);
+	}
+	groups.push_back(zones.size());
+	next_group = 0;
+	zones_done = 0;
+	stopped = false;
+
+	// this thread reports progress, the others only work
+	int n_threads = static_cast<int>(std::min<size_t>(threads, groups.size() - 1));
+	std::vector<uv_thread_t> helpers(n_threads > 1 ? n_threads - 1 : 0);
+	std::vector<bool> started(helpers.size(), false);
+	for(size_t t = 0; t < helpers.size(); t++) {
+		started[t] = uv_thread_create(&helpers[t], threadMain, this) == 0;
+	}
+
+	err = work(progress, progress_arg);
+
+	for(size_t t = 0; t < helpers.size(); t++) {
+		if(started[t]) uv_thread_join(&helpers[t]);
+	}
+	for(size_t i = 0; i < zones.size(); i++) delete zones[i].geometry;
+	zones.clear();
+	if(!err && !thread_error.empty()) {
+		CPLError(CE_Failure, CPLE_AppDefined, "%s", thread_error.c_str());
+		err = CE_Failure;
+	}
+
+	if(!err && progress) progress(1.0, NULL, progress_arg);
+	return err;
+}
+
+void ZonalStatistics::threadMain(void *arg)
+{
+	ZonalStatistics *self = static_cast<ZonalStatistics*>(arg);
+	if(self->work(NULL, NULL)) {
+		// CPL errors are per thread: hand the message to run()
+		uv_mutex_lock(&self->io_lock);
+		if(self->thread_error.empty()) self->thread_error = CPLGetLastErrorMsg();
+		if(self->thread_error.empty()) self->thread_error = "Error computing zonal statistics";
+		uv_mutex_unlock(&self->io_lock);
+	}
+}
+
+// Takes groups of zones until none are left or a thread fails
+CPLErr ZonalStatistics::work(GDALProgressFunc progress, void *progress_arg)
+{
+	while(!stopped) {
+		size_t group = next_group++;
+		if(group + 1 >= groups.size()) break;
+
+		for(size_t i = groups[group]; i < groups[group + 1]; i++) {
+			if(stopped) break;
+			if(progress && !progress((double)zones_done / zones.size(), NULL, progress_arg)) {
+				CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+				stopped = true;
+				return CE_Failure;
+			}
+			if(accumulate(zones[i])) {
+				stopped = true;
+				return CE_Failure;
+			}
+			zones_done++;
+		}
+	}
+	return CE_None;
+}
+
+// Reads every feature's geometry in the band's spatial reference, along with
+// the window of pixels it covers
+CPLErr ZonalStatistics::readZones()
+{
+	GDALDataset *ds = band->GetDataset();
+	double inv_gt[6];
+	if(!ds || ds->GetGeoTransform(gt) != CE_None || !GDALInvGeoTransform(gt, inv_gt)) {
+		CPLError(CE_Failure, CPLE_AppDefined, "Band has no invertible geotransform");
+		return CE_Failure;
+	}
+
+	OGRCoordinateTransformation *ct = NULL;
+	OGRSpatialReference *layer_srs = layer->GetSpatialRef();
+	const char *wkt = ds->GetProjectionRef();
+	OGRSpatialReference ds_srs;
+	if(layer_srs && wkt && wkt[0] && ds_srs.importFromWkt(&wkt) == OGRERR_NONE && !layer_srs->IsSame(&ds_srs)) {
+		ct = OGRCreateCoordinateTransformation(layer_srs, &ds_srs);
+		if(!ct) return CE_Failure;
+	}
+
+	long chunks_per_row = (raster_w + block_w - 1) / block_w;
+
+	layer->ResetReading();
+	OGRFeature *feature;
+	while((feature = layer->GetNextFeature()) != NULL) {
+		long index = fids.size();
+		fids.push_back(static_cast<double>(feature->GetFID()));
+		OGRGeometry *geom = feature->StealGeometry();
+		OGRFeature::DestroyFeature(feature);
+
+		// features that can't be transformed or don't overlap the raster get no pixels
+		if(!geom || geom->IsEmpty() || (ct && geom->transform(ct) != OGRERR_NONE)) {
+			delete geom;
+			continue;
+		}
+
+		OGREnvelope env;
+		geom->getEnvelope(&env);
+		double corners_x[4] = {env.MinX, env.MaxX, env.MinX, env.MaxX};
+		double corners_y[4] = {env.MinY, env.MinY, env.MaxY, env.MaxY};
+		double min_x = HUGE_VAL, min_y = HUGE_VAL, max_x = -HUGE_VAL, max_y = -HUGE_VAL;
+		for(int i = 0; i < 4; i++) {
+			double px = inv_gt[0] + corners_x[i] * inv_gt[1] + corners_y[i] * inv_gt[2];
+			double py = inv_gt[3] + corners_x[i] * inv_gt[4] + corners_y[i] * inv_gt[5];
+			min_x = std::min(min_x, px);
+			max_x = std::max(max_x, px);
+			min_y = std::min(min_y, py);
+			max_y = std::max(max_y, py);
+		}
+
+		int x0 = static_cast<int>(std::max(0.0, std::floor(min_x)));
+		int y0 = static_cast<int>(std::max(0.0, std::floor(min_y)));
+		int x1 = static_cast<int>(std::min((double)raster_w, std::ceil(max_x)));
+		int y1 = static_cast<int>(std::min((double)raster_h, std::ceil(max_y)));
+		// a point or line on a pixel edge still touches the pixel after it
+		if(x1 == x0 && x1 < raster_w) x1++;
+		if(y1 == y0 && y1 < raster_h) y1++;
+		if(x1 <= x0 || y1 <= y0) {
+			delete geom;
+			continue;
+		}
+
+		Zone zone;
+		zone.index = index;
+		zone.geometry = geom;
+		zone.x = x0;
+		zone.y = y0;
+		zone.w = x1 - x0;
+		zone.h = y1 - y0;
+		zone.bucket = (y0 / block_h) * chunks_per_row + x0 / block_w;
+		zones.push_back(zone);
+	}
+
+	if(ct) OGRCoordinateTransformation::DestroyCT(ct);
+	return CE_None;
+}
+
+// Burns the zone into a scratch mask one chunk of its window at a time,
+// adding the pixels under it. Only the band reads take the I/O lock.
+CPLErr ZonalStatistics::accumulate(Zone &zone)
+{
+	OGRGeometryH geom = reinterpret_cast<OGRGeometryH>(zone.geometry);
+	int band_list[] = {1};
+	double burn_values[] = {1};
+	char **options = NULL;
+	if(all_touched) options = CSLSetNameValue(options, "ALL_TOUCHED", "TRUE");
+
+	size_t max_n = (size_t)std::min(zone.w, block_w) * std::min(zone.h, block_h);
+	std::vector<GByte> mask(max_n);
+	std::vector<double> values(max_n);
+	std::vector<double> weight_values(weights ? max_n : 0);
+
+	CPLErr err = CE_None;
+	int cx0 = zone.x / block_w, cx1 = (zone.x + zone.w - 1) / block_w;
+	int cy0 = zone.y / block_h, cy1 = (zone.y + zone.h - 1) / block_h;
+	for(int cy = cy0; cy <= cy1 && !err; cy++) {
+		for(int cx = cx0; cx <= cx1 && !err; cx++) {
+			int x = std::max(zone.x, cx * block_w);
+			int y = std::max(zone.y, cy * block_h);
+			int w = std::min(zone.x + zone.w, (cx + 1) * block_w) - x;
+			int h = std::min(zone.y + zone.h, (cy + 1) * block_h) - y;
+			int n = w * h;
+
+			// the mask covers just this part of the zone's window
+			std::memset(&mask[0], 0, n);
+			GDALDataset *scratch = createMask(mem_driver, &mask[0], x, y, w, h, gt);
+			if(!scratch) {
+				err = CE_Failure;
+				break;
+			}
+			err = GDALRasterizeGeometries(scratch, 1, band_list, 1, &geom, NULL, NULL, burn_values, options, NULL, NULL);
+			GDALClose(scratch);
+			if(err) break;
+
+			bool any = false;
+			for(int i = 0; i < n && !any; i++) any = mask[i] != 0;
+			if(!any) continue;
+
+			uv_mutex_lock(&io_lock);
+			err = band->RasterIO(GF_Read, x, y, w, h, &values[0], w, h, GDT_Float64, 0, 0, NULL);
+			if(!err && weights) {
+				err = weights->RasterIO(GF_Read, x, y, w, h, &weight_values[0], w, h, GDT_Float64, 0, 0, NULL);
+			}
+			uv_mutex_unlock(&io_lock);
+			if(err) break;
+
+			for(int i = 0; i < n; i++) {
+				if(!mask[i]) continue;
+				double value = values[i];
+				if(std::isnan(value) || (has_nodata && value == nodata)) continue;
+				double weight = 1;
+				if(weights) {
+					weight = weight_values[i];
+					if(std::isnan(weight) || (has_weights_nodata && weight == weights_nodata)) continue;
+				}
+				add(zone.index, value, weight);
+			}
+		}
+	}
+
+	CSLDestroy(options);
+	return err;
+}
+
+void ZonalStatistics::add(long index, double value, double weight)
+{
+	counts[index]++;
+	if(value < mins[index]) mins[index] = value;
+	if(value > maxs[index]) maxs[index] = value;
+
+	// weighted Welford update
+	if(weight > 0) {
+		double weight_sum = weight_sums[index] + weight;
+		double delta = value - means[index];
+		means[index] += delta * weight / weight_sum;
+		m2s[index] += weight * delta * (value - means[index]);
+		weight_sums[index] = weight_sum;
+		sums[index] += weight * value;
+	}
+
+	if((stats & HISTOGRAM) && value >= hist_min && value <= hist_max) {
+		int bucket = static_cast<int>((value - hist_min) / (hist_max - hist_min) * buckets);
+		if(bucket >= buckets) bucket = buckets - 1;
+		histograms[index * buckets + bucket]++;
+	}
+}
+
+// Creates the result object: a typed array for each statistic, indexed like
+// the `fid` array
+Local<Value> ZonalStatistics::result()
+{
+	Nan::EscapableHandleScope scope;
+
+	size_t n = fids.size();
+	double nan = std::numeric_limits<double>::quiet_NaN();
+	Local<Object> obj = Nan::New<Object>();
+
+	for(int stat = 0; stat <= HISTOGRAM; stat = stat ? stat << 1 : 1) {
+		if(stat && !(stats & stat)) continue;
+
+		const char *name = "fid";
+		for(unsigned int j = 0; j < sizeof(stat_names) / sizeof(stat_names[0]); j++) {
+			if(stat_names[j].stat == stat) name = stat_names[j].name;
+		}
+
+		bool counted = stat == COUNT || stat == HISTOGRAM;
+		size_t length = stat == HISTOGRAM ? n * buckets : n;
+		Local<Value> array = TypedArray::New(counted ? GDT_UInt32 : GDT_Float64, length);
+		if(array.IsEmpty() || !array->IsObject()) {
+			return scope.Escape(Nan::Undefined()); //TypedArray::New threw an error
+		}
+
+		if(counted) {
+			if(length) {
+				const std::vector<unsigned int> &column = stat == COUNT ? counts : histograms;
+				memcpy(*Nan::TypedArrayContents<uint32_t>(array), &column[0], length * sizeof(uint32_t));
+			}
+		} else {
+			double *data = *Nan::TypedArrayContents<double>(array);
+			for(size_t i = 0; i < n; i++) {
+				bool empty = stat != 0 && counts[i] == 0;
+				switch(stat) {
+					case 0:      data[i] = fids[i]; break;
+					case SUM:    data[i] = sums[i]; break;
+					case MEAN:   data[i] = weight_sums[i] > 0 ? means[i] : nan; break;
+					case MIN:    data[i] = empty ? nan : mins[i]; break;
+					case MAX:    data[i] = empty ? nan : maxs[i]; break;
+					case STDDEV: data[i] = weight_sums[i] > 0 ? std::sqrt(m2s[i] / weight_sums[i]) : nan; break;
+				}
+			}
+		}
+
+		Nan::Set(obj, Nan::New(name).ToLocalChecked(), array);
+	}
+
+	return scope.Escape(obj);
+}
+
+}
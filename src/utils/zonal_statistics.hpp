@@ -0,0 +1,108 @@
+#ifndef __ZONAL_STATISTICS_H__
+#define __ZONAL_STATISTICS_H__
+
+// node
+#include <node.h>
+#include <uv.h>
+
+// nan
+#pragma GCC diagnostic push
+#pragma GCC diagnostic ignored "-Wunused-parameter"
+#include <nan.h>
+#pragma GCC diagnostic pop
+
+// gdal
+#include <gdal_priv.h>
+
+// ogr
+#include <ogrsf_frmts.h>
+
+#include <atomic>
+#include <string>
+#include <vector>
+
+using namespace v8;
+
+namespace node_gdal {
+
+// A class for computing statistics of a band's pixels under each feature of
+// a layer.
+//
+// Features are grouped by the raster block their extent starts in, so
+// neighbouring features reuse cached blocks, and the groups are shared
+// between threads. Each feature's geometry is burned into a scratch mask the
+// size of the part of its window in one block at a time, and the pixels under
+// the mask are accumulated; nodata and NaN pixels are skipped. Masks are
+// rasterized in parallel; reads from the bands are serialized. With a weights
+// band, sum, mean and stddev are weighted (count stays a pixel count).
+
+class ZonalStatistics {
+public:
+	enum Stat {
+		COUNT = 1 << 0,
+		SUM = 1 << 1,
+		MEAN = 1 << 2,
+		MIN = 1 << 3,
+		MAX = 1 << 4,
+		STDDEV = 1 << 5,
+		HISTOGRAM = 1 << 6
+	};
+
+	static int parseStats(Local<Value> value, int &stats);
+
+	ZonalStatistics(OGRLayer *layer, GDALRasterBand *band, GDALRasterBand *weights, int stats, bool all_touched);
+	~ZonalStatistics();
+
+	void setHistogram(int buckets, double min, double max);
+	void setThreads(int threads);
+	CPLErr run(GDALProgressFunc progress, void *progress_arg);
+	Local<Value> result();
+
+private:
+	struct Zone {
+		long index;
+		OGRGeometry *geometry;
+		int x, y, w, h;
+		long bucket;
+	};
+
+	CPLErr readZones();
+	CPLErr work(GDALProgressFunc progress, void *progress_arg);
+	CPLErr accumulate(Zone &zone);
+	void add(long index, double value, double weight);
+	static void threadMain(void *arg);
+
+	OGRLayer *layer;
+	GDALRasterBand *band;
+	GDALRasterBand *weights;
+	int stats;
+	bool all_touched;
+	int buckets;
+	double hist_min, hist_max;
+	int raster_w, raster_h;
+	int block_w, block_h;
+	double gt[6];
+	int has_nodata, has_weights_nodata;
+	double nodata, weights_nodata;
+	int threads;
+
+	// shared by the threads of run()
+	std::vector<Zone> zones;
+	std::vector<size_t> groups;         // first zone of each block, then zones.size()
+	std::atomic<size_t> next_group;
+	std::atomic<size_t> zones_done;
+	std::atomic<bool> stopped;
+	GDALDriver *mem_driver;
+	uv_mutex_t io_lock;                 // guards band reads and thread_error
+	std::string thread_error;
+
+	// columns, one entry per feature
+	std::vector<double> fids;
+	std::vector<unsigned int> counts;
+	std::vector<double> sums, weight_sums, means, m2s, mins, maxs;
+	std::vector<unsigned int> histograms;
+};
+
+}
+
+#endif
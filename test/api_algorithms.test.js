@@ -80,6 +80,21 @@ describe('gdal', function() {
 			assert.deepEqual(actual_levels.sort(), levels, 'all fixed levels used');
 			*/
 		});
+		it('should generate contours asynchronously', function() {
+			var progress = [];
+			return gdal.contourGenerateAsync({
+				src: srcband,
+				dst: lyr,
+				offset: 7,
+				interval: 32,
+				idField: 0,
+				elevField: 1,
+				progress: function(complete) { progress.push(complete); }
+			}).then(function() {
+				assert(lyr.features.count() > 0, 'features were created');
+				assert.equal(progress[progress.length - 1], 1);
+			});
+		});
 	});
 	describe('fillNodata()', function() {
 		var src, srcband;
@@ -122,6 +137,17 @@ describe('gdal', function() {
 				assert.notEqual(srcband.pixels.get(holes_x[i], holes_y[i]), nodata);
 			}
 		});
+		it('should fill nodata values asynchronously', function() {
+			return gdal.fillNodataAsync({
+				src: srcband,
+				searchDist: 3,
+				smoothingIterations: 2
+			}).then(function() {
+				for (var i = 0; i < holes_x.length; i++) {
+					assert.notEqual(srcband.pixels.get(holes_x[i], holes_y[i]), nodata);
+				}
+			});
+		});
 	});
 	describe('checksumImage()', function() {
 		var src, band;
@@ -153,6 +179,24 @@ describe('gdal', function() {
 			assert.notEqual(a, b);
 			assert.notEqual(b, c);
 		});
+		it('should match checksumImage() when run asynchronously', function() {
+			// tall enough to be processed in several chunks
+			var ds = gdal.open('temp', 'w', 'MEM', 37, 500, 1, gdal.GDT_Int16);
+			var tall = ds.bands.get(1);
+			var data = new Int16Array(37 * 500);
+			for (var i = 0; i < data.length; i++) data[i] = (i * 7919) % 3001 - 1500;
+			tall.pixels.write(0, 0, 37, 500, data);
+
+			var expected = gdal.checksumImage(tall);
+			var expected_region = gdal.checksumImage(tall, 3, 11, 20, 400);
+			return Promise.all([
+				gdal.checksumImageAsync(tall),
+				gdal.checksumImageAsync(tall, 3, 11, 20, 400)
+			]).then(function(results) {
+				assert.equal(results[0], expected);
+				assert.equal(results[1], expected_region);
+			});
+		});
 	});
 	describe('sieveFilter()', function() {
 		var src, band;
@@ -190,6 +234,16 @@ describe('gdal', function() {
 
 			assert.equal(band.pixels.get(8, 8), 20);
 		});
+		it('should filter asynchronously', function() {
+			return gdal.sieveFilterAsync({
+				src: band,
+				dst: band,
+				threshold: 4 * 4 + 1,
+				connectedness: 8
+			}).then(function() {
+				assert.equal(band.pixels.get(8, 8), 20);
+			});
+		});
 	});
 	describe('polygonize()', function() {
 		var src, srcband, dst, lyr;
@@ -240,5 +294,271 @@ describe('gdal', function() {
 				assert.instanceOf(geom, gdal.Polygon);
 			});
 		});
+		it('should generate polygons asynchronously', function() {
+			return gdal.polygonizeAsync({
+				src: srcband,
+				dst: lyr,
+				pixValField: 0,
+				connectedness: 8
+			}).then(function() {
+				assert.equal(lyr.features.count(), 2);
+			});
+		});
+		it('should reject if the dst dataset is closed before it starts', function() {
+			var promise = gdal.polygonizeAsync({
+				src: srcband,
+				dst: lyr,
+				pixValField: 0
+			});
+			dst.close();
+			return promise.then(function() {
+				// already finished before close() returned
+			}, function(err) {
+				assert.match(err.message, /already been destroyed/);
+			});
+		});
+	});
+	describe('calc()', function() {
+		var src, a, b;
+		var w = 20;
+		var h = 10;
+		beforeEach(function() {
+			src = gdal.open('temp', 'w', 'MEM', w, h, 2, gdal.GDT_Int16);
+			src.geoTransform = [100, 1, 0, 50, 0, -1];
+			a = src.bands.get(1);
+			b = src.bands.get(2);
+			var da = new Int16Array(w * h);
+			var db = new Int16Array(w * h);
+			for (var i = 0; i < w * h; i++) {
+				da[i] = i % w;
+				db[i] = Math.floor(i / w);
+			}
+			a.pixels.write(0, 0, w, h, da);
+			b.pixels.write(0, 0, w, h, db);
+		});
+		afterEach(function() {
+			try {
+				src.close();
+			} catch (err) {
+				/* ignore */
+			}
+		});
+		it('should evaluate the expression into a new band', function() {
+			var out = gdal.calc({inputs: {a: a, b: b}, expr: '(a - b) / (a + b + 1)'});
+			assert.instanceOf(out, gdal.RasterBand);
+			assert.equal(out.dataType, gdal.GDT_Float64);
+			assert.deepEqual(out.ds.geoTransform, src.geoTransform);
+			assert.closeTo(out.pixels.get(7, 3), 4 / 11, 1e-12);
+			assert.closeTo(out.pixels.get(2, 9), -7 / 12, 1e-12);
+		});
+		it('should write to the output band', function() {
+			var ds = gdal.open('temp', 'w', 'MEM', w, h, 1, gdal.GDT_Byte);
+			var out = ds.bands.get(1);
+			var result = gdal.calc({
+				inputs: {x: a, y: b},
+				expr: 'x > 10 && y < 5 ? max(x, y) ^ 2 % 200 : -abs(y - 4) + 4',
+				output: out
+			});
+			assert.strictEqual(result, out);
+			assert.equal(out.pixels.get(12, 2), 144);
+			assert.equal(out.pixels.get(15, 3), 25);
+			assert.equal(out.pixels.get(0, 7), 1);
+		});
+		it('should set pixels where an input is nodata to the output nodata value', function() {
+			a.noDataValue = 3;
+			var out = gdal.calc({inputs: {a: a, b: b}, expr: 'a + b', type: gdal.GDT_Int16, nodata: -1});
+			assert.equal(out.noDataValue, -1);
+			assert.equal(out.pixels.get(3, 5), -1);
+			assert.equal(out.pixels.get(4, 5), 9);
+		});
+		it('should set NaN results to the nodata value', function() {
+			var out = gdal.calc({inputs: {a: a}, expr: 'sqrt(a - 5)', nodata: -9999});
+			assert.equal(out.pixels.get(4, 0), -9999);
+			assert.equal(out.pixels.get(9, 0), 2);
+		});
+		it('should throw on an invalid expression', function() {
+			assert.throws(function() {
+				gdal.calc({inputs: {a: a}, expr: 'a + c'});
+			}, /Unknown variable or function "c"/);
+			assert.throws(function() {
+				gdal.calc({inputs: {a: a}, expr: 'min(a'});
+			}, /Expected ","/);
+		});
+		it('should throw if options are not given', function() {
+			assert.throws(function() {
+				gdal.calc();
+			}, /options must be given/);
+		});
+		it('should throw if the inputs are not the size of the output', function() {
+			var ds = gdal.open('temp', 'w', 'MEM', w, h + 1, 1);
+			assert.throws(function() {
+				gdal.calc({inputs: {a: a}, expr: 'a', output: ds.bands.get(1)});
+			}, /same size/);
+		});
+		it('should give the same result with one or several threads', function() {
+			var big = gdal.open('temp', 'w', 'MEM', 1500, 1000, 2, gdal.GDT_Float32);
+			var x = new Float32Array(1500 * 1000);
+			for (var i = 0; i < x.length; i++) x[i] = (i * 7919) % 1000 - 500;
+			big.bands.get(1).pixels.write(0, 0, 1500, 1000, x);
+			big.bands.get(2).noDataValue = 0;
+			big.bands.get(2).fill(2);
+			big.bands.get(2).pixels.write(700, 400, 1, 1, new Float32Array([0]));
+			var options = {inputs: {x: big.bands.get(1), y: big.bands.get(2)}, expr: 'sqrt(x) * y', nodata: -1};
+
+			gdal.config.set('GDAL_NUM_THREADS', '1');
+			var single = gdal.calc(options).pixels.read(0, 0, 1500, 1000);
+			gdal.config.set('GDAL_NUM_THREADS', '4');
+			var multi = gdal.calc(options).pixels.read(0, 0, 1500, 1000);
+			gdal.config.set('GDAL_NUM_THREADS', null);
+
+			assert.deepEqual(multi, single);
+			assert.equal(multi[400 * 1500 + 700], -1);
+			assert.equal(multi[0], -1);
+			assert.closeTo(multi[100], Math.sqrt(x[100]) * 2, 1e-9);
+		});
+		it('should evaluate the expression asynchronously', function() {
+			var expected = gdal.calc({inputs: {a: a, b: b}, expr: 'a * b - 3'}).pixels.read(0, 0, w, h);
+			var progress = 0;
+			return gdal.calcAsync({
+				inputs: {a: a, b: b},
+				expr: 'a * b - 3',
+				progress: function(complete) { progress = complete; }
+			}).then(function(out) {
+				assert.instanceOf(out, gdal.RasterBand);
+				assert.deepEqual(out.pixels.read(0, 0, w, h), expected);
+				assert.equal(progress, 1);
+			});
+		});
+	});
+	describe('zonalStatistics()', function() {
+		var src, band, dst, lyr, fids;
+		var w = 10;
+		var h = 10;
+		beforeEach(function() {
+			// pixel (x, y) has value x + 10y and is centered at (x + 0.5, 9.5 - y)
+			src = gdal.open('temp', 'w', 'MEM', w, h, 1, gdal.GDT_Float64);
+			src.geoTransform = [0, 1, 0, 10, 0, -1];
+			band = src.bands.get(1);
+			var data = new Float64Array(w * h);
+			for (var i = 0; i < w * h; i++) data[i] = i;
+			band.pixels.write(0, 0, w, h, data);
+
+			dst = gdal.open('temp', 'w', 'Memory');
+			lyr = dst.layers.create('zones', null, gdal.Polygon);
+			[
+				'POLYGON ((0 10, 2 10, 2 8, 0 8, 0 10))',
+				'POLYGON ((20 20, 21 20, 21 21, 20 21, 20 20))',
+				'POLYGON ((0.1 9.9, 0.4 9.9, 0.4 9.6, 0.1 9.6, 0.1 9.9))',
+				'POLYGON ((5 5, 10 5, 10 0, 5 0, 5 5))'
+			].forEach(function(wkt) {
+				var feature = new gdal.Feature(lyr);
+				feature.setGeometry(gdal.Geometry.fromWKT(wkt));
+				lyr.features.add(feature);
+			});
+			fids = lyr.features.map(function(feature) { return feature.fid; });
+		});
+		afterEach(function() {
+			try {
+				src.close();
+				dst.close();
+			} catch (err) {
+				/* ignore */
+			}
+		});
+		it('should compute statistics for each feature', function() {
+			var stats = gdal.zonalStatistics({layer: lyr, band: band});
+			assert.deepEqual(Array.from(stats.fid), fids);
+			assert.instanceOf(stats.count, Uint32Array);
+			assert.deepEqual(Array.from(stats.count), [4, 0, 0, 25]);
+			assert.deepEqual(Array.from(stats.sum), [22, 0, 0, 1925]);
+			assert.closeTo(stats.mean[0], 5.5, 1e-12);
+			assert.isNaN(stats.mean[1]);
+			assert.closeTo(stats.mean[3], 77, 1e-12);
+			assert.equal(stats.min[0], 0);
+			assert.equal(stats.max[0], 11);
+			assert.equal(stats.min[3], 55);
+			assert.equal(stats.max[3], 99);
+			assert.isNaN(stats.min[1]);
+			assert.closeTo(stats.stddev[0], Math.sqrt(25.25), 1e-12);
+			assert.closeTo(stats.stddev[3], Math.sqrt(202), 1e-12);
+			assert.isUndefined(stats.histogram);
+		});
+		it('should only return the requested statistics', function() {
+			var stats = gdal.zonalStatistics({layer: lyr, band: band, stats: ['max']});
+			assert.deepEqual(Object.keys(stats).sort(), ['fid', 'max']);
+			assert.throws(function() {
+				gdal.zonalStatistics({layer: lyr, band: band, stats: ['median']});
+			}, /Unknown statistic "median"/);
+		});
+		it('should include every pixel touched when allTouched is set', function() {
+			var stats = gdal.zonalStatistics({layer: lyr, band: band, stats: ['count'], allTouched: true});
+			assert.equal(stats.count[2], 1);
+			assert.equal(stats.count[0], 4);
+		});
+		it('should leave out nodata pixels', function() {
+			band.noDataValue = 11;
+			var stats = gdal.zonalStatistics({layer: lyr, band: band, stats: ['count', 'max']});
+			assert.equal(stats.count[0], 3);
+			assert.equal(stats.max[0], 10);
+		});
+		it('should weight the sum and mean', function() {
+			var ds = gdal.open('temp', 'w', 'MEM', w, h, 1, gdal.GDT_Float64);
+			var weights = ds.bands.get(1);
+			weights.fill(1);
+			weights.pixels.set(1, 1, 3);
+			var stats = gdal.zonalStatistics({layer: lyr, band: band, weights: weights, stats: ['count', 'sum', 'mean']});
+			assert.equal(stats.count[0], 4);
+			assert.equal(stats.sum[0], 44);
+			assert.closeTo(stats.mean[0], 44 / 6, 1e-12);
+		});
+		it('should compute histograms', function() {
+			var stats = gdal.zonalStatistics({layer: lyr, band: band, stats: ['histogram'], buckets: 2, range: [0, 20]});
+			assert.instanceOf(stats.histogram, Uint32Array);
+			assert.equal(stats.histogram.length, 8);
+			assert.deepEqual(Array.from(stats.histogram.subarray(0, 2)), [2, 2]);
+			assert.deepEqual(Array.from(stats.histogram.subarray(6, 8)), [0, 0]);
+			assert.throws(function() {
+				gdal.zonalStatistics({layer: lyr, band: band, stats: ['histogram']});
+			}, /range/);
+		});
+		it('should compute statistics asynchronously', function() {
+			var expected = gdal.zonalStatistics({layer: lyr, band: band});
+			return gdal.zonalStatisticsAsync({layer: lyr, band: band}).then(function(stats) {
+				assert.deepEqual(Array.from(stats.count), Array.from(expected.count));
+				assert.deepEqual(Array.from(stats.mean.subarray(3)), Array.from(expected.mean.subarray(3)));
+			});
+		});
+		it('should give the same result with one or several threads', function() {
+			var size = 2000;
+			var big = gdal.open('temp', 'w', 'MEM', size, size, 1, gdal.GDT_Float64);
+			big.geoTransform = [0, 1, 0, size, 0, -1];
+			var data = new Float64Array(size * size);
+			for (var i = 0; i < data.length; i++) data[i] = (i * 7919) % 1000;
+			big.bands.get(1).pixels.write(0, 0, size, size, data);
+
+			var zones = dst.layers.create('grid', null, gdal.Polygon);
+			for (var x = 0; x < size; x += 180) {
+				for (var y = 0; y < size; y += 180) {
+					var feature = new gdal.Feature(zones);
+					var wkt = 'POLYGON ((' + [[x, y], [x + 300, y + 40], [x + 150, y + 310], [x, y]].map(function(p) {
+						return p.join(' ');
+					}).join(', ') + '))';
+					feature.setGeometry(gdal.Geometry.fromWKT(wkt));
+					zones.features.add(feature);
+				}
+			}
+
+			var options = {layer: zones, band: big.bands.get(1), stats: ['count', 'sum', 'min', 'max']};
+			gdal.config.set('GDAL_NUM_THREADS', '1');
+			var single = gdal.zonalStatistics(options);
+			gdal.config.set('GDAL_NUM_THREADS', '4');
+			var multi = gdal.zonalStatistics(options);
+			gdal.config.set('GDAL_NUM_THREADS', null);
+
+			assert.isAbove(single.count[0], 0);
+			['fid', 'count', 'sum', 'min', 'max'].forEach(function(stat) {
+				assert.deepEqual(Array.from(multi[stat]), Array.from(single[stat]));
+			});
+		});
 	});
 });
@@ -94,4 +94,184 @@ describe('gdal', function() {
 			assert.equal(gdal.decToDMS(14.12511, 'long', 1), ' 14d 7\'30.4"E');
 		});
 	});
+	describe('fromTypedArray()', function() {
+		var w = 4;
+		var h = 3;
+		it('should wrap a band interleaved array without copying', function() {
+			var data = new Float32Array(w * h * 2);
+			for (var i = 0; i < data.length; i++) data[i] = i;
+			var ds = gdal.fromTypedArray(data, {width: w, height: h, bands: 2});
+			assert.equal(ds.driver.description, 'MEM');
+			assert.deepEqual(ds.rasterSize, {x: w, y: h});
+			assert.equal(ds.bands.count(), 2);
+			assert.equal(ds.bands.get(1).dataType, gdal.GDT_Float32);
+			assert.equal(ds.bands.get(1).pixels.get(1, 2), 9);
+			assert.equal(ds.bands.get(2).pixels.get(1, 2), w * h + 9);
+
+			// changes to either side are visible through the other
+			data[0] = 42;
+			assert.equal(ds.bands.get(1).pixels.get(0, 0), 42);
+			ds.bands.get(2).pixels.set(3, 0, -1);
+			assert.equal(data[w * h + 3], -1);
+		});
+		it('should support pixel and line interleaving', function() {
+			var pixel = new Uint16Array([1, 10, 2, 20, 3, 30, 4, 40]);
+			var ds = gdal.fromTypedArray(pixel, {width: 2, height: 2, bands: 2, interleave: 'pixel'});
+			assert.deepEqual(Array.from(ds.bands.get(1).pixels.read(0, 0, 2, 2)), [1, 2, 3, 4]);
+			assert.deepEqual(Array.from(ds.bands.get(2).pixels.read(0, 0, 2, 2)), [10, 20, 30, 40]);
+
+			var line = new Uint16Array([1, 2, 10, 20, 3, 4, 30, 40]);
+			ds = gdal.fromTypedArray(line, {width: 2, height: 2, bands: 2, interleave: 'line'});
+			assert.deepEqual(Array.from(ds.bands.get(1).pixels.read(0, 0, 2, 2)), [1, 2, 3, 4]);
+			assert.deepEqual(Array.from(ds.bands.get(2).pixels.read(0, 0, 2, 2)), [10, 20, 30, 40]);
+		});
+		it('should respect the byte offset of the array', function() {
+			var buffer = new ArrayBuffer(8 * (w * h + 1));
+			var data = new Float64Array(buffer, 8, w * h);
+			data[0] = 5;
+			var ds = gdal.fromTypedArray(data, {width: w, height: h});
+			assert.equal(ds.bands.get(1).pixels.get(0, 0), 5);
+		});
+		it('should set the geotransform and srs', function() {
+			var srs = gdal.SpatialReference.fromEPSG(4326);
+			var ds = gdal.fromTypedArray(new Uint8Array(w * h), {
+				width: w,
+				height: h,
+				geoTransform: [10, 1, 0, 20, 0, -1],
+				srs: srs
+			});
+			assert.deepEqual(ds.geoTransform, [10, 1, 0, 20, 0, -1]);
+			assert.isTrue(ds.srs.isSame(srs));
+		});
+		it('should be usable as the source of an algorithm', function() {
+			var data = new Uint8Array(w * h);
+			for (var i = 0; i < data.length; i++) data[i] = i % w < 2 ? 1 : 2;
+			var src = gdal.fromTypedArray(data, {width: w, height: h});
+			var dst = gdal.open('temp', 'w', 'Memory');
+			var lyr = dst.layers.create('temp', null, gdal.Polygon);
+			lyr.fields.add(new gdal.FieldDefn('val', gdal.OFTInteger));
+			gdal.polygonize({src: src.bands.get(1), dst: lyr, pixValField: 0});
+			assert.equal(lyr.features.count(), 2);
+		});
+		it('should throw if the array is too short', function() {
+			assert.throws(function() {
+				gdal.fromTypedArray(new Uint8Array(w * h), {width: w, height: h, bands: 2});
+			}, /Array length must be greater than or equal to/);
+		});
+		it('should throw if interleave is invalid', function() {
+			assert.throws(function() {
+				gdal.fromTypedArray(new Uint8Array(w * h), {width: w, height: h, interleave: 'tile'});
+			}, /interleave must be/);
+		});
+		it('should throw if array is not a typed array', function() {
+			assert.throws(function() {
+				gdal.fromTypedArray([1, 2, 3], {width: 3, height: 1});
+			}, /array must be a TypedArray/);
+		});
+	});
+	describe('setThreadPoolSize()', function() {
+		afterEach(function() {
+			gdal.setThreadPoolSize(4);
+		});
+		it('should update the pool size', function() {
+			gdal.setThreadPoolSize(2);
+			assert.equal(gdal.getThreadPoolStats().size, 2);
+		});
+		it('should throw if size is less than 1', function() {
+			assert.throws(function() {
+				gdal.setThreadPoolSize(0);
+			}, /at least 1/);
+		});
+		it('should limit the number of jobs running at once', function() {
+			gdal.setThreadPoolSize(1);
+			var ds = gdal.open(__dirname + '/data/sample.tif');
+			var band = ds.bands.get(1);
+			var reads = [];
+			for (var i = 0; i < 4; i++) reads.push(band.pixels.readAsync(0, 0, 64, 64));
+			assert.isAtMost(gdal.getThreadPoolStats().active, 1);
+			return Promise.all(reads);
+		});
+	});
+	describe('getThreadPoolStats()', function() {
+		it('should report completed jobs with wait and run times', function() {
+			var ds = gdal.open(__dirname + '/data/sample.tif');
+			var before = gdal.getThreadPoolStats().completed;
+			return ds.bands.get(1).pixels.readAsync(0, 0, 64, 64).then(function() {
+				var stats = gdal.getThreadPoolStats();
+				assert.equal(stats.completed, before + 1);
+				assert.equal(stats.queued, 0);
+				assert.equal(stats.active, 0);
+				assert.isAtLeast(stats.totalRunTime, 0);
+				var job = stats.recent[stats.recent.length - 1];
+				assert.equal(job.state, 'completed');
+				assert.isString(job.name);
+				assert.isAtLeast(job.waitTime, 0);
+				assert.isAtLeast(job.runTime, 0);
+			});
+		});
+	});
+	describe('async job priority', function() {
+		afterEach(function() {
+			gdal.setThreadPoolSize(4);
+		});
+		it('should run interactive jobs before queued background jobs', function() {
+			gdal.setThreadPoolSize(1);
+			var big = gdal.drivers.get('MEM').create('', 2000, 2000, 1);
+			var small = gdal.open(__dirname + '/data/sample.tif');
+			var order = [];
+
+			var first = gdal.checksumImageAsync(big.bands.get(1), 0, 0, 2000, 2000);
+			var background = small.bands.get(1).pixels.readAsync(0, 0, 16, 16, null, {priority: 'background'}).then(function() {
+				order.push('background');
+			});
+			var interactive = small.bands.get(1).pixels.readAsync(0, 0, 16, 16, null, {priority: 'interactive'}).then(function() {
+				order.push('interactive');
+			});
+
+			return Promise.all([first, background, interactive]).then(function() {
+				assert.deepEqual(order, ['interactive', 'background']);
+			});
+		});
+		it('should not deadlock when interactive jobs need the dataset of a yielding job', function() {
+			gdal.setThreadPoolSize(1);
+			var big = gdal.drivers.get('MEM').create('', 2000, 2000, 1);
+			var band = big.bands.get(1);
+
+			var first = gdal.checksumImageAsync(band, 0, 0, 2000, 2000);
+			var reads = [
+				band.pixels.readAsync(0, 0, 16, 16, null, {priority: 'interactive'}),
+				band.pixels.readAsync(16, 16, 16, 16, null, {priority: 'interactive'})
+			];
+
+			return Promise.all([first].concat(reads)).then(function(results) {
+				assert.isNumber(results[0]);
+				assert.equal(results[1].length, 256);
+				assert.equal(results[2].length, 256);
+			});
+		});
+		it('should report the priority of jobs', function() {
+			var ds = gdal.open(__dirname + '/data/sample.tif');
+			return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16, null, {priority: 'background'}).then(function() {
+				var stats = gdal.getThreadPoolStats();
+				assert.equal(stats.recent[stats.recent.length - 1].priority, 'background');
+			});
+		});
+		it('should reset the priority after each call', function() {
+			var ds = gdal.open(__dirname + '/data/sample.tif');
+			return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16, null, {priority: 'interactive'}).then(function() {
+				return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16);
+			}).then(function() {
+				var stats = gdal.getThreadPoolStats();
+				assert.equal(stats.recent[stats.recent.length - 1].priority, 'normal');
+			});
+		});
+		it('should reject if priority is invalid', function() {
+			var ds = gdal.open(__dirname + '/data/sample.tif');
+			return ds.bands.get(1).pixels.readAsync(0, 0, 16, 16, null, {priority: 'urgent'}).then(function() {
+				assert.fail('should have been rejected');
+			}, function(err) {
+				assert.match(err.message, /priority must be/);
+			});
+		});
+	});
 });
@@ -281,6 +281,123 @@ describe('gdal.Dataset', function() {
 				});
 			});
 		});
+		describe('"pixels" property', function() {
+			var ds;
+			beforeEach(function() {
+				// band n holds n * 10 + x + y * 4
+				ds = gdal.open('temp', 'w', 'MEM', 4, 2, 3, gdal.GDT_Byte);
+				ds.bands.forEach(function(band, n) {
+					var data = new Uint8Array(8);
+					for (var i = 0; i < 8; i++) data[i] = n * 10 + i;
+					band.pixels.write(0, 0, 4, 2, data);
+				});
+			});
+			it('should exist', function() {
+				assert.instanceOf(ds.pixels, gdal.DatasetPixels);
+			});
+			describe('read()', function() {
+				it('should interleave by pixel by default', function() {
+					var data = ds.pixels.read(0, 0, 2, 1);
+					assert.instanceOf(data, Uint8Array);
+					assert.deepEqual(Array.from(data), [10, 20, 30, 11, 21, 31]);
+				});
+				it('should interleave by line', function() {
+					var data = ds.pixels.read(0, 0, 2, 2, null, {interleave: 'line'});
+					assert.deepEqual(Array.from(data), [10, 11, 20, 21, 30, 31, 14, 15, 24, 25, 34, 35]);
+				});
+				it('should interleave by band', function() {
+					var data = ds.pixels.read(0, 0, 2, 2, null, {interleave: 'band'});
+					assert.deepEqual(Array.from(data), [10, 11, 14, 15, 20, 21, 24, 25, 30, 31, 34, 35]);
+				});
+				it('should read the given bands in order', function() {
+					var data = ds.pixels.read(1, 1, 2, 1, null, {bands: [3, 1]});
+					assert.deepEqual(Array.from(data), [35, 15, 36, 16]);
+				});
+				it('should convert to data_type', function() {
+					var data = ds.pixels.read(0, 0, 1, 1, null, {data_type: gdal.GDT_Float32});
+					assert.instanceOf(data, Float32Array);
+					assert.deepEqual(Array.from(data), [10, 20, 30]);
+				});
+				it('should resample to buffer_width / buffer_height', function() {
+					var data = ds.pixels.read(0, 0, 4, 2, null, {buffer_width: 2, buffer_height: 1, bands: [1]});
+					assert.equal(data.length, 2);
+				});
+				it('should apply the resampling option', function() {
+					var data = ds.pixels.read(0, 0, 3, 1, null, {buffer_width: 1, buffer_height: 1, resampling: 'average', bands: [1]});
+					assert.deepEqual(Array.from(data), [11]);
+				});
+				it('should read from overviews with useOverviews', function() {
+					ds.buildOverviews('NEAREST', [2]);
+					var stats = {};
+					var data = ds.pixels.read(0, 0, 4, 2, null, {buffer_width: 2, buffer_height: 1, useOverviews: true, stats: stats});
+					assert.equal(stats.overview, 0);
+					assert.equal(stats.bytesDecoded, 2 * 3);
+					var expected = ds.bands.get(2).overviews.get(0).pixels.read(0, 0, 2, 1);
+					assert.equal(data[1], expected[0]);
+					assert.equal(data[4], expected[1]);
+				});
+				it('should read into the given array', function() {
+					var data = new Uint16Array(6);
+					var result = ds.pixels.read(0, 0, 2, 1, data);
+					assert.equal(result, data);
+					assert.deepEqual(Array.from(data), [10, 20, 30, 11, 21, 31]);
+				});
+				it('should throw if the array is too small', function() {
+					assert.throws(function() {
+						ds.pixels.read(0, 0, 2, 1, new Uint8Array(5));
+					});
+				});
+				it('should throw on an invalid band id', function() {
+					assert.throws(function() {
+						ds.pixels.read(0, 0, 2, 1, null, {bands: [4]});
+					}, /invalid band id/);
+				});
+				it('should throw on an invalid interleave', function() {
+					assert.throws(function() {
+						ds.pixels.read(0, 0, 2, 1, null, {interleave: 'foo'});
+					}, /interleave must be/);
+				});
+				it('should throw if dataset is closed', function() {
+					ds.close();
+					assert.throws(function() {
+						ds.pixels.read(0, 0, 2, 1);
+					}, /already been destroyed/);
+				});
+			});
+			describe('write()', function() {
+				it('should write pixel-interleaved data to each band', function() {
+					ds.pixels.write(0, 0, 2, 1, new Uint8Array([1, 2, 3, 4, 5, 6]));
+					assert.deepEqual(Array.from(ds.bands.get(1).pixels.read(0, 0, 2, 1)), [1, 4]);
+					assert.deepEqual(Array.from(ds.bands.get(2).pixels.read(0, 0, 2, 1)), [2, 5]);
+					assert.deepEqual(Array.from(ds.bands.get(3).pixels.read(0, 0, 2, 1)), [3, 6]);
+				});
+				it('should write band-interleaved data to the given bands', function() {
+					ds.pixels.write(0, 0, 2, 1, new Uint8Array([1, 2, 3, 4]), {bands: [2, 3], interleave: 'band'});
+					assert.deepEqual(Array.from(ds.bands.get(1).pixels.read(0, 0, 2, 1)), [10, 11]);
+					assert.deepEqual(Array.from(ds.bands.get(2).pixels.read(0, 0, 2, 1)), [1, 2]);
+					assert.deepEqual(Array.from(ds.bands.get(3).pixels.read(0, 0, 2, 1)), [3, 4]);
+				});
+				it('should throw if the array is too small', function() {
+					assert.throws(function() {
+						ds.pixels.write(0, 0, 2, 1, new Uint8Array(5));
+					});
+				});
+			});
+			describe('readAsync()', function() {
+				it('should resolve with the interleaved data', function() {
+					return ds.pixels.readAsync(0, 0, 2, 1, null, {interleave: 'band'}).then(function(data) {
+						assert.deepEqual(Array.from(data), [10, 11, 20, 21, 30, 31]);
+					});
+				});
+			});
+			describe('writeAsync()', function() {
+				it('should write the interleaved data', function() {
+					return ds.pixels.writeAsync(0, 0, 1, 1, new Uint8Array([7, 8, 9])).then(function() {
+						assert.deepEqual(Array.from(ds.pixels.read(0, 0, 1, 1)), [7, 8, 9]);
+					});
+				});
+			});
+		});
 		describe('"srs" property', function() {
 			describe('getter', function() {
 				it('should return SpatialReference', function() {
@@ -587,6 +704,181 @@ describe('gdal.Dataset', function() {
 				});
 			});
 		});
+		describe('buildOverviewsAsync()', function() {
+			it('should generate overviews for all bands', function() {
+				var ds = gdal.open(fileUtils.clone(__dirname + '/data/multiband.tif'), 'r+');
+				var progress = [];
+				return ds.buildOverviewsAsync('NEAREST', [2, 4], {
+					progress: function(complete) { progress.push(complete); }
+				}).then(function() {
+					ds.bands.forEach(function(band) {
+						assert.equal(band.overviews.count(), 2);
+					});
+					assert.equal(progress[progress.length - 1], 1);
+					ds.close();
+				});
+			});
+			it('should only generate overviews for the given bands', function() {
+				gdal.config.set('USE_RRD', 'YES');
+				var ds = gdal.open(fileUtils.clone(__dirname + '/data/multiband.tif'), 'r+');
+				return ds.buildOverviewsAsync('NEAREST', [2, 4], {bands: [1]}).then(function() {
+					gdal.config.set('USE_RRD', null);
+					assert.equal(ds.bands.get(1).overviews.count(), 2);
+					ds.close();
+				});
+			});
+			it('should reject with an AbortError when cancelled', function() {
+				var ds = gdal.open(fileUtils.clone(__dirname + '/data/multiband.tif'), 'r+');
+				var listeners = [];
+				var signal = {
+					aborted: false,
+					addEventListener: function(type, fn) { listeners.push(fn); },
+					removeEventListener: function() {}
+				};
+				var promise = ds.buildOverviewsAsync('NEAREST', [2, 4, 8], {signal: signal});
+				signal.aborted = true;
+				listeners.forEach(function(fn) { fn(); });
+				return promise.then(function() {
+					assert.fail('should have been rejected');
+				}, function(err) {
+					assert.equal(err.name, 'AbortError');
+					assert.equal(ds.bands.get(1).overviews.count(), 0);
+					ds.close();
+				});
+			});
+			it('should reject if band id is invalid', function() {
+				var ds = gdal.open(fileUtils.clone(__dirname + '/data/sample.tif'), 'r+');
+				return ds.buildOverviewsAsync('NEAREST', [2], {bands: [4]}).then(function() {
+					assert.fail('should have been rejected');
+				}, function(err) {
+					assert.match(err.message, /invalid band id/);
+				});
+			});
+		});
+		describe('computeStatistics()', function() {
+			var w = 600;
+			var h = 300;
+			var ds, columns;
+			beforeEach(function() {
+				// read in two tiles (the MEM driver's blocks are rows)
+				ds = gdal.drivers.get('MEM').create('temp', w, h, 0);
+				ds.bands.create(gdal.GDT_Byte);
+				ds.bands.create(gdal.GDT_Int16);
+				ds.bands.create(gdal.GDT_Float64);
+				columns = [new Uint8Array(w * h), new Int16Array(w * h), new Float64Array(w * h)];
+				for (var y = 0; y < h; y++) {
+					for (var x = 0; x < w; x++) {
+						var i = y * w + x;
+						columns[0][i] = (x + y) % 256;
+						columns[1][i] = x - 2 * y;
+						columns[2][i] = Math.sin(i) * 100 + columns[0][i];
+					}
+				}
+				for (var b = 0; b < 3; b++) ds.bands.get(b + 1).pixels.write(0, 0, w, h, columns[b]);
+			});
+			afterEach(function() {
+				try {
+					ds.close();
+				} catch (err) {
+					/* ignore */
+				}
+			});
+			function isValid(b, i) {
+				var nodata = ds.bands.get(b + 1).noDataValue;
+				return nodata === null || columns[b][i] !== nodata;
+			}
+			function expectedStats(b) {
+				var values = [];
+				for (var i = 0; i < w * h; i++) if (isValid(b, i)) values.push(columns[b][i]);
+				var mean = values.reduce(function(a, v) { return a + v; }, 0) / values.length;
+				var m2 = values.reduce(function(a, v) { return a + (v - mean) * (v - mean); }, 0);
+				values.sort(function(a, c) { return a - c; });
+				return {values: values, mean: mean, stddev: Math.sqrt(m2 / values.length)};
+			}
+			function expectedCovariance(a, b) {
+				var n = 0, sum_a = 0, sum_b = 0, i;
+				var joint = function(i) { return isValid(0, i) && isValid(1, i) && isValid(2, i); };
+				for (i = 0; i < w * h; i++) {
+					if (!joint(i)) continue;
+					n++;
+					sum_a += columns[a][i];
+					sum_b += columns[b][i];
+				}
+				var c = 0;
+				for (i = 0; i < w * h; i++) {
+					if (joint(i)) c += (columns[a][i] - sum_a / n) * (columns[b][i] - sum_b / n);
+				}
+				return c / n;
+			}
+			function expectedPercentile(values, p) {
+				var rank = p / 100 * (values.length - 1);
+				var lo = Math.floor(rank);
+				var hi = Math.ceil(rank);
+				return values[lo] + (values[hi] - values[lo]) * (rank - lo);
+			}
+			it('should compute the statistics of every band', function() {
+				var stats = ds.computeStatistics();
+				assert.deepEqual(Array.from(stats.bands), [1, 2, 3]);
+				assert.instanceOf(stats.mean, Float64Array);
+				for (var b = 0; b < 3; b++) {
+					var expected = expectedStats(b);
+					assert.equal(stats.count[b], w * h);
+					assert.equal(stats.min[b], expected.values[0]);
+					assert.equal(stats.max[b], expected.values[expected.values.length - 1]);
+					assert.closeTo(stats.mean[b], expected.mean, 1e-9);
+					assert.closeTo(stats.stddev[b], expected.stddev, 1e-9);
+				}
+				assert.isUndefined(stats.covariance);
+				assert.isUndefined(stats.percentiles);
+			});
+			it('should compute the covariance matrix', function() {
+				var stats = ds.computeStatistics({bands: [3, 1], covariance: true});
+				assert.deepEqual(Array.from(stats.bands), [3, 1]);
+				assert.equal(stats.covariance.length, 4);
+				assert.closeTo(stats.covariance[0], expectedCovariance(2, 2), 1e-6);
+				assert.closeTo(stats.covariance[1], expectedCovariance(2, 0), 1e-6);
+				assert.equal(stats.covariance[1], stats.covariance[2]);
+				assert.closeTo(stats.covariance[3], Math.pow(stats.stddev[1], 2), 1e-6);
+			});
+			it('should leave out nodata values', function() {
+				ds.bands.get(2).noDataValue = 0;
+				var stats = ds.computeStatistics({covariance: true});
+				var expected = expectedStats(1);
+				assert.equal(stats.count[1], expected.values.length);
+				assert.isBelow(stats.count[1], w * h);
+				assert.closeTo(stats.mean[1], expected.mean, 1e-9);
+				assert.closeTo(stats.covariance[1], expectedCovariance(0, 1), 1e-6);
+			});
+			it('should compute percentiles', function() {
+				var percentiles = [0, 10, 50, 99.9, 100];
+				var stats = ds.computeStatistics({percentiles: percentiles});
+				assert.equal(stats.percentiles.length, 15);
+				for (var b = 0; b < 3; b++) {
+					var values = expectedStats(b).values;
+					percentiles.forEach(function(p, j) {
+						// exact for the integer bands, within a histogram bucket otherwise
+						var tolerance = b < 2 ? 1e-9 : (values[values.length - 1] - values[0]) / 65536;
+						assert.closeTo(stats.percentiles[b * 5 + j], expectedPercentile(values, p), tolerance);
+					});
+				}
+			});
+			it('should throw on invalid options', function() {
+				assert.throws(function() {
+					ds.computeStatistics({bands: [4]});
+				}, /invalid band id/);
+				assert.throws(function() {
+					ds.computeStatistics({percentiles: [101]});
+				}, /between 0 and 100/);
+			});
+			it('should compute statistics asynchronously', function() {
+				var expected = ds.computeStatistics({covariance: true, percentiles: [50]});
+				return ds.computeStatisticsAsync({covariance: true, percentiles: [50]}).then(function(stats) {
+					assert.deepEqual(Array.from(stats.mean), Array.from(expected.mean));
+					assert.deepEqual(Array.from(stats.covariance), Array.from(expected.covariance));
+					assert.deepEqual(Array.from(stats.percentiles), Array.from(expected.percentiles));
+				});
+			});
+		});
 	});
 	describe('setGCPs()', function() {
 		it('should update gcps', function() {
@@ -137,4 +137,61 @@ describe('gdal.drivers', function() {
 			assert.equal(result.length, gdal.drivers.count());
 		});
 	});
+
+	describe('Driver.createCopyAsync()', function() {
+		function createSignal() {
+			var listeners = [];
+			return {
+				aborted: false,
+				addEventListener: function(type, fn) { listeners.push(fn); },
+				removeEventListener: function(type, fn) { listeners.splice(listeners.indexOf(fn), 1); },
+				abort: function() {
+					this.aborted = true;
+					listeners.slice().forEach(function(fn) { fn(); });
+				}
+			};
+		}
+
+		it('should resolve with a copy of the dataset', function() {
+			var src = gdal.open(__dirname + '/data/sample.tif');
+			var driver = gdal.drivers.get('GTiff');
+			var filename = '/vsimem/create_copy_async.' + String(Math.random()).substring(2) + '.tif';
+			var progress = [];
+			return driver.createCopyAsync(filename, src, {
+				options: {TILED: 'YES'},
+				progress: function(complete) { progress.push(complete); }
+			}).then(function(ds) {
+				assert.instanceOf(ds, gdal.Dataset);
+				assert.deepEqual(ds.rasterSize, src.rasterSize);
+				assert.equal(ds.bands.get(1).pixels.read(0, 0, 10, 10)[55], src.bands.get(1).pixels.read(0, 0, 10, 10)[55]);
+				assert.isAbove(progress.length, 0);
+				assert.equal(progress[progress.length - 1], 1);
+				ds.close();
+				gdal.drivers.get('GTiff').deleteDataset(filename);
+			});
+		});
+		it('should reject and leave no output when cancelled', function() {
+			var src = gdal.open(__dirname + '/data/sample.tif');
+			var driver = gdal.drivers.get('GTiff');
+			var filename = '/vsimem/create_copy_async.' + String(Math.random()).substring(2) + '.tif';
+			var signal = createSignal();
+			var promise = driver.createCopyAsync(filename, src, {signal: signal});
+			signal.abort();
+			return promise.then(function() {
+				assert.fail('should have been rejected');
+			}, function(err) {
+				assert.equal(err.name, 'AbortError');
+				assert.throws(function() {
+					gdal.open(filename);
+				});
+			});
+		});
+		it('should reject if source dataset is not a Dataset', function() {
+			return gdal.drivers.get('MEM').createCopyAsync('', {}).then(function() {
+				assert.fail('should have been rejected');
+			}, function(err) {
+				assert.match(err.message, /source dataset must be a Dataset object/);
+			});
+		});
+	});
 });
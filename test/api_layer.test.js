@@ -477,6 +477,146 @@ describe('gdal.Layer', function() {
 					});
 				});
 			});
+			describe('cursor()', function() {
+				var dataset, layer;
+				beforeEach(function() {
+					dataset = gdal.open(fileUtils.cloneDir(__dirname + '/data/shp') + '/sample.shp');
+					layer = dataset.layers.get(0);
+				});
+				afterEach(function() {
+					try { dataset.close(); } catch (e) { /* ignore */ }
+				});
+
+				function readAll(cursor, batches) {
+					return cursor.nextBatch().then(function(batch) {
+						if (!batch) return batches;
+						batches.push(batch);
+						return readAll(cursor, batches);
+					});
+				}
+
+				it('should return a LayerFeatureCursor', function() {
+					var cursor = layer.features.cursor({batchSize: 5});
+					assert.instanceOf(cursor, gdal.LayerFeatureCursor);
+					assert.equal(cursor.batchSize, 5);
+					cursor.close();
+				});
+				it('should deliver all features in batches', function() {
+					var cursor = layer.features.cursor({batchSize: 5});
+					return readAll(cursor, []).then(function(batches) {
+						assert.equal(batches.length, 5);
+						assert.equal(batches[0].length, 5);
+						assert.equal(batches[4].length, 3);
+						var fids = [];
+						batches.forEach(function(batch) {
+							batch.forEach(function(feature) {
+								assert.instanceOf(feature, gdal.Feature);
+								fids.push(feature.fid);
+							});
+						});
+						assert.equal(fids.length, 23);
+						assert.equal(fids[0], 0);
+						assert.equal(fids[22], 22);
+					});
+				});
+				it('should only read the given fields', function() {
+					var cursor = layer.features.cursor({fields: ['name'], ignoreGeometry: true});
+					return cursor.nextBatch().then(function(batch) {
+						assert.equal(batch.length, 23);
+						assert.isString(batch[0].fields.get('name'));
+						assert.isNull(batch[0].fields.get('fips'));
+						assert.isNull(batch[0].getGeometry());
+						cursor.close();
+					});
+				});
+				it('should throw if a field doesn\'t exist', function() {
+					assert.throws(function() {
+						layer.features.cursor({fields: ['nope']});
+					}, /does not exist/);
+				});
+				it('should resolve null after close()', function() {
+					var cursor = layer.features.cursor();
+					cursor.close();
+					return cursor.nextBatch().then(function(batch) {
+						assert.isNull(batch);
+					});
+				});
+				it('should throw error if dataset is destroyed', function() {
+					dataset.close();
+					assert.throws(function() {
+						layer.features.cursor();
+					}, /already destroyed/);
+				});
+			});
+			describe('Symbol.asyncIterator', function() {
+				var dataset, layer;
+				beforeEach(function() {
+					dataset = gdal.open(fileUtils.cloneDir(__dirname + '/data/shp') + '/sample.shp');
+					layer = dataset.layers.get(0);
+				});
+				afterEach(function() {
+					try { dataset.close(); } catch (e) { /* ignore */ }
+				});
+				it('should iterate through all features', function() {
+					var iterator = layer.features[Symbol.asyncIterator]();
+					var count = 0;
+					var step = function() {
+						return iterator.next().then(function(result) {
+							if (result.done) return;
+							assert.instanceOf(result.value, gdal.Feature);
+							count++;
+							return step();
+						});
+					};
+					return step().then(function() {
+						assert.equal(count, 23);
+					});
+				});
+				it('should stop when return() is called', function() {
+					var iterator = layer.features[Symbol.asyncIterator]();
+					return iterator.next().then(function(result) {
+						assert.isFalse(result.done);
+						return iterator.return();
+					}).then(function() {
+						return iterator.next();
+					}).then(function(result) {
+						assert.isTrue(result.done);
+					});
+				});
+			});
+			describe('stream()', function() {
+				var dataset, layer;
+				beforeEach(function() {
+					dataset = gdal.open(fileUtils.cloneDir(__dirname + '/data/shp') + '/sample.shp');
+					layer = dataset.layers.get(0);
+				});
+				afterEach(function() {
+					try { dataset.close(); } catch (e) { /* ignore */ }
+				});
+				it('should emit every feature', function(done) {
+					var count = 0;
+					layer.features.stream({batchSize: 4})
+						.on('data', function(feature) {
+							assert.instanceOf(feature, gdal.Feature);
+							count++;
+						})
+						.on('error', done)
+						.on('end', function() {
+							assert.equal(count, 23);
+							done();
+						});
+				});
+				it('should not read ahead of a paused consumer', function(done) {
+					var stream = layer.features.stream({batchSize: 2, highWaterMark: 2});
+					stream.read(0);
+					setTimeout(function() {
+						// one batch pushed into the buffer, nothing more requested
+						assert.isAtMost(stream.readableLength !== undefined ? stream.readableLength : stream._readableState.length, 2);
+						stream.destroy();
+						done();
+					}, 50);
+				});
+			});
 			describe('map()', function() {
 				it('should operate normally', function() {
 					prepare_dataset_layer_test('r', function(dataset, layer) {
@@ -487,6 +487,112 @@ describe('gdal.RasterBand', function() {
 					assert.equal(data.length, w * h);
 					assert.equal(data[10 * 20 + 10], 10);
 				});
+				(typeof SharedArrayBuffer === 'function' ? describe : describe.skip)('w/shared option', function() {
+					it('should allocate the array on a SharedArrayBuffer', function() {
+						var ds   = gdal.open(__dirname + '/data/sample.tif');
+						var band = ds.bands.get(1);
+						var data = band.pixels.read(190, 290, 20, 30, null, {shared: true});
+						assert.instanceOf(data, Uint8Array);
+						assert.instanceOf(data.buffer, SharedArrayBuffer);
+						assert.deepEqual(Array.from(data), Array.from(band.pixels.read(190, 290, 20, 30)));
+					});
+					it('should read into an existing shared array', function() {
+						var ds   = gdal.open(__dirname + '/data/sample.tif');
+						var band = ds.bands.get(1);
+						var data = new Uint8Array(new SharedArrayBuffer(20 * 30));
+						var result = band.pixels.read(190, 290, 20, 30, data);
+						assert.equal(result, data);
+						assert.equal(data[10 * 20 + 10], 10);
+					});
+					it('should allocate shared arrays in readAsync()', function() {
+						var ds   = gdal.open(__dirname + '/data/sample.tif');
+						var band = ds.bands.get(1);
+						return band.pixels.readAsync(190, 290, 20, 30, null, {shared: true}).then(function(data) {
+							assert.instanceOf(data.buffer, SharedArrayBuffer);
+							assert.equal(data[10 * 20 + 10], 10);
+						});
+					});
+					it('should allocate shared arrays in readBlock()', function() {
+						var ds   = gdal.open(__dirname + '/data/sample.tif');
+						var band = ds.bands.get(1);
+						var data = band.pixels.readBlock(0, 0, {shared: true});
+						assert.instanceOf(data.buffer, SharedArrayBuffer);
+						assert.deepEqual(Array.from(data), Array.from(band.pixels.readBlock(0, 0)));
+					});
+				});
+				describe('w/useOverviews option', function() {
+					var band;
+					beforeEach(function() {
+						var ds = gdal.open('temp', 'w', 'MEM', 64, 64, 1, gdal.GDT_Byte);
+						band = ds.bands.get(1);
+						var data = new Uint8Array(64 * 64);
+						for (var i = 0; i < data.length; i++) data[i] = i % 64;
+						band.pixels.write(0, 0, 64, 64, data);
+						ds.buildOverviews('NEAREST', [2, 4]);
+					});
+					it('should read from the best matching overview', function() {
+						var stats = {};
+						var data = band.pixels.read(0, 0, 64, 64, null, {buffer_width: 16, buffer_height: 16, useOverviews: true, stats: stats});
+						assert.equal(data.length, 256);
+						assert.equal(stats.overview, 1);
+						assert.equal(stats.bytesDecoded, 256);
+						assert.deepEqual(Array.from(data), Array.from(band.overviews.get(1).pixels.read(0, 0, 16, 16)));
+					});
+					it('should rescale the window to the overview', function() {
+						var stats = {};
+						var data = band.pixels.read(32, 32, 32, 32, null, {buffer_width: 16, buffer_height: 16, useOverviews: true, stats: stats});
+						assert.equal(stats.overview, 0);
+						assert.equal(stats.bytesDecoded, 256);
+						assert.deepEqual(Array.from(data), Array.from(band.overviews.get(0).pixels.read(16, 16, 16, 16)));
+					});
+					it('should read full resolution without it', function() {
+						var stats = {};
+						band.pixels.read(0, 0, 64, 64, null, {buffer_width: 16, buffer_height: 16, stats: stats});
+						assert.equal(stats.overview, -1);
+						assert.equal(stats.bytesDecoded, 64 * 64);
+					});
+					it('should fill stats in readAsync()', function() {
+						var stats = {};
+						return band.pixels.readAsync(0, 0, 64, 64, null, {buffer_width: 16, buffer_height: 16, useOverviews: true, stats: stats}).then(function(data) {
+							assert.equal(data.length, 256);
+							assert.equal(stats.overview, 1);
+						});
+					});
+				});
+				describe('w/resampling option', function() {
+					var band;
+					beforeEach(function() {
+						var ds = gdal.open('temp', 'w', 'MEM', 4, 4, 1, gdal.GDT_Float32);
+						band = ds.bands.get(1);
+						var data = new Float32Array(16);
+						for (var i = 0; i < 16; i++) data[i] = i;
+						band.pixels.write(0, 0, 4, 4, data);
+					});
+					it('should resample to the buffer size', function() {
+						var data = band.pixels.read(0, 0, 4, 4, null, {buffer_width: 2, buffer_height: 2, resampling: 'average'});
+						assert.deepEqual(Array.from(data), [2.5, 4.5, 10.5, 12.5]);
+					});
+					it('should accept every resampling algorithm', function() {
+						['nearest', 'bilinear', 'cubic', 'cubicspline', 'lanczos', 'average', 'mode', 'gauss'].forEach(function(resampling) {
+							var data = band.pixels.read(0, 0, 4, 4, null, {buffer_width: 2, buffer_height: 2, resampling: resampling});
+							assert.equal(data.length, 4);
+						});
+					});
+					it('should read fractional windows', function() {
+						var data = band.pixels.read(0.5, 0, 2, 1, null, {buffer_width: 2, buffer_height: 1});
+						assert.deepEqual(Array.from(data), [1, 2]);
+					});
+					it('should resample in readAsync()', function() {
+						return band.pixels.readAsync(0, 0, 4, 4, null, {buffer_width: 2, buffer_height: 2, resampling: 'average'}).then(function(data) {
+							assert.deepEqual(Array.from(data), [2.5, 4.5, 10.5, 12.5]);
+						});
+					});
+					it('should throw on an unknown algorithm', function() {
+						assert.throws(function() {
+							band.pixels.read(0, 0, 4, 4, null, {buffer_width: 2, buffer_height: 2, resampling: 'foo'});
+						}, /Invalid resampling algorithm/);
+					});
+				});
 				describe('w/data argument', function() {
 					it('should put the data in the existing array', function() {
 						var ds   = gdal.open('temp', 'w', 'MEM', 256, 256, 1, gdal.GDT_Byte);
@@ -812,6 +918,251 @@ describe('gdal.RasterBand', function() {
 					});
 				});
 			});
+			describe('lockBlock()', function() {
+				it('should return the block data without copying', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var data = band.pixels.lockBlock(0, 0);
+					assert.instanceOf(data, Uint8Array);
+					assert.equal(data.length, band.blockSize.x * band.blockSize.y);
+					assert.deepEqual(Array.from(data), Array.from(band.pixels.readBlock(0, 0)));
+					data.release();
+				});
+				it('should detach the array when released', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var data = band.pixels.lockBlock(0, 0);
+					data.release();
+					assert.equal(data.length, 0);
+					// releasing twice is a no-op
+					data.release();
+					band.pixels.releaseBlock(data);
+				});
+				it('should release blocks when the band is flushed', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var data = band.pixels.lockBlock(0, 0);
+					band.flush();
+					assert.equal(data.length, 0);
+				});
+				it('should not release blocks when reading', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var data = band.pixels.lockBlock(0, 0);
+					band.pixels.read(0, 0, 16, 16);
+					assert.equal(data.length, band.blockSize.x * band.blockSize.y);
+					data.release();
+				});
+				it('should throw on in-memory datasets', function() {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					assert.throws(function() {
+						band.pixels.lockBlock(0, 0);
+					}, /in-memory/);
+				});
+				it('should release blocks when the dataset is closed', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var data = band.pixels.lockBlock(0, 0);
+					ds.close();
+					assert.equal(data.length, 0);
+				});
+				it('should throw if the block is out of range', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					assert.throws(function() {
+						band.pixels.lockBlock(100, 100);
+					});
+				});
+				it('should throw if not given a locked block', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					assert.throws(function() {
+						band.pixels.releaseBlock(new Uint8Array(4));
+					}, /not returned by lockBlock/);
+				});
+			});
+			describe('blocks()', function() {
+				var filename, ds, band;
+				beforeEach(function() {
+					// 40x24 with 16x16 tiles: 3x2 blocks, the last column / row partial
+					filename = '/vsimem/blocks.' + String(Math.random()).substring(2) + '.tif';
+					ds = gdal.drivers.get('GTiff').create(filename, 40, 24, 1, gdal.GDT_UInt16, {TILED: 'YES', BLOCKXSIZE: 16, BLOCKYSIZE: 16});
+					band = ds.bands.get(1);
+					var data = new Uint16Array(40 * 24);
+					for (var i = 0; i < data.length; i++) data[i] = i;
+					band.pixels.write(0, 0, 40, 24, data);
+				});
+				afterEach(function() {
+					ds.close();
+					gdal.drivers.get('GTiff').deleteDataset(filename);
+				});
+				function collect(iterator) {
+					var blocks = [];
+					for (var next = iterator.next(); !next.done; next = iterator.next()) {
+						blocks.push(next.value);
+					}
+					return blocks;
+				}
+				function assertBlockData(block) {
+					assert.instanceOf(block.data, Uint16Array);
+					assert.equal(block.data.length, block.width * block.height);
+					for (var i = 0; i < block.data.length; i++) {
+						var x = block.x + i % block.width;
+						var y = block.y + Math.floor(i / block.width);
+						assert.equal(block.data[i], y * 40 + x);
+					}
+				}
+				it('should yield clipped blocks in tile order', function() {
+					var blocks = collect(band.pixels.blocks());
+					assert.deepEqual(blocks.map(function(b) { return [b.x, b.y, b.width, b.height]; }), [
+						[0, 0, 16, 16], [16, 0, 16, 16], [32, 0, 8, 16],
+						[0, 16, 16, 8], [16, 16, 16, 8], [32, 16, 8, 8]
+					]);
+					blocks.forEach(assertBlockData);
+				});
+				it('should yield full-width strips in row order', function() {
+					var iterator = band.pixels.blocks({order: 'row'});
+					assert.equal(iterator.order, 'row');
+					var blocks = collect(iterator);
+					assert.deepEqual(blocks.map(function(b) { return [b.x, b.y, b.width, b.height]; }), [
+						[0, 0, 40, 16], [0, 16, 40, 8]
+					]);
+					blocks.forEach(assertBlockData);
+				});
+				it('should clip blocks to the window', function() {
+					var blocks = collect(band.pixels.blocks({window: {x: 10, y: 12, width: 20, height: 8}}));
+					assert.deepEqual(blocks.map(function(b) { return [b.x, b.y, b.width, b.height]; }), [
+						[10, 12, 6, 4], [16, 12, 14, 4], [10, 16, 6, 4], [16, 16, 14, 4]
+					]);
+					blocks.forEach(assertBlockData);
+				});
+				it('should reuse one buffer if "reuse" is set', function() {
+					var buffers = [];
+					collect(band.pixels.blocks({reuse: true})).forEach(function(block) {
+						if (buffers.indexOf(block.data.buffer) < 0) buffers.push(block.data.buffer);
+					});
+					assert.lengthOf(buffers, 1);
+					assert.equal(buffers[0].byteLength, 16 * 16 * 2);
+
+					var iterator = band.pixels.blocks({reuse: true});
+					for (var next = iterator.next(); !next.done; next = iterator.next()) {
+						assertBlockData(next.value);
+					}
+				});
+				it('should be iterable', function() {
+					var count = 0;
+					for (var block of band.pixels.blocks()) {
+						assertBlockData(block);
+						count++;
+					}
+					assert.equal(count, 6);
+				});
+				it('should throw if the window is outside of the raster', function() {
+					assert.throws(function() {
+						band.pixels.blocks({window: {x: 30, y: 0, width: 20, height: 10}});
+					}, RangeError);
+				});
+				it('should throw if the order is invalid', function() {
+					assert.throws(function() {
+						band.pixels.blocks({order: 'column'});
+					}, /order/);
+				});
+				it('should throw if the band has been destroyed', function() {
+					var iterator = band.pixels.blocks();
+					ds.close();
+					assert.throws(function() {
+						iterator.next();
+					}, /already been destroyed/);
+					ds = gdal.open(filename);
+				});
+			});
+			describe('sampler()', function() {
+				var filename, ds, band;
+				beforeEach(function() {
+					filename = '/vsimem/sampler.' + String(Math.random()).substring(2) + '.tif';
+					ds = gdal.drivers.get('GTiff').create(filename, 40, 24, 1, gdal.GDT_UInt16, {TILED: 'YES', BLOCKXSIZE: 16, BLOCKYSIZE: 16});
+					band = ds.bands.get(1);
+					var data = new Uint16Array(40 * 24);
+					for (var i = 0; i < data.length; i++) data[i] = i;
+					band.pixels.write(0, 0, 40, 24, data);
+				});
+				afterEach(function() {
+					try {
+						ds.close();
+					} catch (err) {
+						/* ignore */
+					}
+					gdal.drivers.get('GTiff').deleteDataset(filename);
+				});
+				it('should return the same values as pixels.get()', function() {
+					var sampler = band.pixels.sampler();
+					assert.equal(sampler.get(0, 0), 0);
+					assert.equal(sampler.get(5, 0), 5);
+					assert.equal(sampler.get(39, 23), 23 * 40 + 39);
+					assert.equal(sampler.get(7, 3), band.pixels.get(7, 3));
+					sampler.release();
+				});
+				it('should see values written after the block was locked', function() {
+					var sampler = band.pixels.sampler();
+					assert.equal(sampler.get(1, 1), 41);
+					band.pixels.set(2, 1, 1000);
+					assert.equal(sampler.get(2, 1), 1000);
+					band.flush();
+					band.pixels.set(3, 1, 2000);
+					assert.equal(sampler.get(3, 1), 2000);
+				});
+				it('should read in-memory datasets with RasterIO', function() {
+					var mem = gdal.open('temp', 'w', 'MEM', 40, 24, 1, gdal.GDT_UInt16);
+					mem.bands.get(1).pixels.write(0, 0, 40, 24, band.pixels.read(0, 0, 40, 24));
+					var sampler = mem.bands.get(1).pixels.sampler();
+					assert.equal(sampler.get(7, 3), 3 * 40 + 7);
+					mem.bands.get(1).pixels.set(7, 3, 1000);
+					assert.equal(sampler.get(7, 3), 1000);
+				});
+				it('should throw if the pixel is outside of the raster', function() {
+					var sampler = band.pixels.sampler();
+					assert.throws(function() {
+						sampler.get(40, 0);
+					}, RangeError);
+					assert.throws(function() {
+						sampler.get(-1, 0);
+					}, RangeError);
+				});
+				it('should throw once the dataset is closed', function() {
+					var sampler = band.pixels.sampler();
+					sampler.get(0, 0);
+					ds.close();
+					assert.throws(function() {
+						sampler.get(0, 0);
+					}, /already been destroyed/);
+				});
+				describe('getMany()', function() {
+					it('should return the values in the order of the coordinates', function() {
+						var xs = new Int32Array([39, 0, 20, 1, 39]);
+						var ys = new Int32Array([23, 0, 10, 0, 0]);
+						var values = band.pixels.sampler().getMany(xs, ys);
+						assert.instanceOf(values, Float64Array);
+						assert.deepEqual(Array.from(values), [959, 0, 420, 1, 39]);
+					});
+					it('should write to the given array', function() {
+						var data = new Float64Array(2);
+						var result = band.pixels.sampler().getMany(new Int32Array([1, 2]), new Int32Array([1, 1]), data);
+						assert.equal(result, data);
+						assert.deepEqual(Array.from(data), [41, 42]);
+					});
+					it('should throw if the coordinates are not Int32Arrays', function() {
+						assert.throws(function() {
+							band.pixels.sampler().getMany([1, 2], [1, 2]);
+						}, /Int32Array/);
+					});
+					it('should throw if the lengths differ', function() {
+						assert.throws(function() {
+							band.pixels.sampler().getMany(new Int32Array(2), new Int32Array(3));
+						}, /same length/);
+					});
+				});
+			});
 			describe('writeBlock()', function() {
 				it('should write data from TypedArray', function() {
 					var i;
@@ -874,6 +1225,90 @@ describe('gdal.RasterBand', function() {
 					});
 				});
 			});
+			describe('readAsync()', function() {
+				it('should resolve with a TypedArray', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					var w = 20;
+					var h = 30;
+					var expected = band.pixels.read(190, 290, w, h);
+					return band.pixels.readAsync(190, 290, w, h).then(function(data) {
+						assert.instanceOf(data, Uint8Array);
+						assert.equal(data.length, w * h);
+						assert.deepEqual(Array.from(data), Array.from(expected));
+					});
+				});
+				it('should reject if region is out of bounds', function() {
+					var ds   = gdal.open(__dirname + '/data/sample.tif');
+					var band = ds.bands.get(1);
+					return band.pixels.readAsync(2000, 2000, 16, 16).then(function() {
+						assert.fail('expected rejection');
+					}, function(err) {
+						assert.instanceOf(err, Error);
+					});
+				});
+				it('should reject if dataset already closed', function() {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					ds.close();
+					return band.pixels.readAsync(0, 0, 16, 16).then(function() {
+						assert.fail('expected rejection');
+					}, function(err) {
+						assert.instanceOf(err, Error);
+					});
+				});
+				it('should settle if the dataset is closed while pending', function() {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					var promise = band.pixels.readAsync(0, 0, 16, 16);
+					ds.close();
+					return promise.then(function(data) {
+						assert.equal(data.length, 16 * 16);
+					}, function(err) {
+						assert.match(err.message, /already been destroyed/);
+					});
+				});
+				it('should allow parallel reads across datasets', function() {
+					var datasets = [];
+					for (var i = 0; i < 4; i++) {
+						datasets.push(gdal.open(__dirname + '/data/sample.tif'));
+					}
+					return Promise.all(datasets.map(function(ds) {
+						return ds.bands.get(1).pixels.readAsync(0, 0, 64, 64);
+					})).then(function(results) {
+						var expected = datasets[0].bands.get(1).pixels.read(0, 0, 64, 64);
+						results.forEach(function(data) {
+							assert.deepEqual(Array.from(data), Array.from(expected));
+						});
+					});
+				});
+			});
+			describe('writeAsync()', function() {
+				it('should write data from TypedArray', function() {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					var data = new Uint8Array(new ArrayBuffer(16 * 16));
+					for (var i = 0; i < data.length; i++) data[i] = i;
+					return band.pixels.writeAsync(0, 0, 16, 16, data).then(function() {
+						var result = band.pixels.read(0, 0, 16, 16);
+						assert.deepEqual(Array.from(result), Array.from(data));
+					});
+				});
+			});
+			describe('readBlockAsync() / writeBlockAsync()', function() {
+				it('should round-trip a block', function() {
+					var ds   = gdal.open('temp', 'w', 'MEM', 16, 16, 1, gdal.GDT_Byte);
+					var band = ds.bands.get(1);
+					var length = band.blockSize.x * band.blockSize.y;
+					var data = new Uint8Array(new ArrayBuffer(length));
+					for (var i = 0; i < length; i++) data[i] = i;
+					return band.pixels.writeBlockAsync(0, 0, data).then(function() {
+						return band.pixels.readBlockAsync(0, 0);
+					}).then(function(result) {
+						assert.deepEqual(Array.from(result), Array.from(data));
+					});
+				});
+			});
 		});
 		describe('"overviews" property', function() {
 			describe('getter', function() {
@@ -990,5 +1425,199 @@ describe('gdal.RasterBand', function() {
 				});
 			});
 		});
+		describe('sampleAt()', function() {
+			var ds, band;
+			beforeEach(function() {
+				// value = x + 10 * y, pixel x, y covering [x, x + 1] x [3 - y, 4 - y]
+				ds = gdal.open('temp', 'w', 'MEM', 4, 4, 1, gdal.GDT_Float64);
+				ds.geoTransform = [0, 1, 0, 4, 0, -1];
+				ds.srs = gdal.SpatialReference.fromEPSG(4326);
+				band = ds.bands.get(1);
+				var data = new Float64Array(16);
+				for (var i = 0; i < 16; i++) data[i] = i % 4 + 10 * Math.floor(i / 4);
+				band.pixels.write(0, 0, 4, 4, data);
+			});
+			it('should return the nearest pixel values', function() {
+				var values = band.sampleAt(new Float64Array([0.5, 3.5, 2.2, 1.1, 3.9, 0.1]));
+				assert.instanceOf(values, Float64Array);
+				assert.deepEqual(Array.from(values), [0, 22, 33]);
+			});
+			it('should interpolate', function() {
+				var values = band.sampleAt(new Float64Array([1, 3.5, 2, 2]), {interpolation: 'bilinear'});
+				assert.closeTo(values[0], 0.5, 1e-9);
+				assert.closeTo(values[1], 16.5, 1e-9);
+				values = band.sampleAt(new Float64Array([2, 2]), {interpolation: 'cubic'});
+				assert.closeTo(values[0], 16.5, 1e-9);
+			});
+			it('should leave nodata pixels out of the interpolation', function() {
+				band.noDataValue = 1;
+				var values = band.sampleAt(new Float64Array([1, 3.5, 1.5, 3.5]), {interpolation: 'bilinear', nodataValue: -9999});
+				assert.closeTo(values[0], 0, 1e-9);
+				assert.equal(values[1], -9999);
+			});
+			it('should return nodataValue outside of the raster', function() {
+				var values = band.sampleAt(new Float64Array([-1, 2, 2, 5]));
+				assert.isNaN(values[0]);
+				assert.isNaN(values[1]);
+				values = band.sampleAt(new Float64Array([-1, 2]), {nodataValue: -1});
+				assert.equal(values[0], -1);
+			});
+			it('should transform the points from srs', function() {
+				ds.srs = gdal.SpatialReference.fromEPSG(3857);
+				ds.geoTransform = [0, 1000, 0, 4000, 0, -1000];
+				var wgs84 = gdal.SpatialReference.fromEPSG(4326);
+				var ct = new gdal.CoordinateTransformation(ds.srs, wgs84);
+				var a = ct.transformPoint(1500, 2500);
+				var b = ct.transformPoint(3500, 500);
+				var values = band.sampleAt(new Float64Array([a.x, a.y, b.x, b.y]), {srs: wgs84});
+				assert.deepEqual(Array.from(values), [11, 33]);
+			});
+			it('should throw if coords is not a Float64Array', function() {
+				assert.throws(function() {
+					band.sampleAt([1, 2]);
+				}, /Float64Array/);
+			});
+			it('should throw if the interpolation is invalid', function() {
+				assert.throws(function() {
+					band.sampleAt(new Float64Array([1, 2]), {interpolation: 'lanczos'});
+				}, /interpolation/);
+			});
+			it('should throw error if dataset already closed', function() {
+				ds.close();
+				assert.throws(function() {
+					band.sampleAt(new Float64Array([1, 2]));
+				});
+			});
+		});
+		describe('profile()', function() {
+			var ds, band;
+			beforeEach(function() {
+				// value = x + 10 * y, pixel x, y covering [x, x + 1] x [3 - y, 4 - y]
+				ds = gdal.open('temp', 'w', 'MEM', 4, 4, 1, gdal.GDT_Float64);
+				ds.geoTransform = [0, 1, 0, 4, 0, -1];
+				ds.srs = gdal.SpatialReference.fromEPSG(4326);
+				band = ds.bands.get(1);
+				var data = new Float64Array(16);
+				for (var i = 0; i < 16; i++) data[i] = i % 4 + 10 * Math.floor(i / 4);
+				band.pixels.write(0, 0, 4, 4, data);
+			});
+			function line(coords) {
+				var result = new gdal.LineString();
+				for (var i = 0; i < coords.length; i += 2) result.points.add(coords[i], coords[i + 1]);
+				return result;
+			}
+			it('should sample a point every pixel by default', function() {
+				var profile = band.profile(line([0.5, 3.5, 3.5, 3.5]));
+				assert.instanceOf(profile.distances, Float64Array);
+				assert.instanceOf(profile.values, Float64Array);
+				assert.deepEqual(Array.from(profile.distances), [0, 1, 2, 3]);
+				assert.deepEqual(Array.from(profile.values), [0, 1, 2, 3]);
+			});
+			it('should follow every segment and end on the last vertex', function() {
+				var profile = band.profile(line([0.5, 3.5, 0.5, 1.5, 2, 1.5]), {step: 1.5});
+				assert.deepEqual(Array.from(profile.distances), [0, 1.5, 3, 3.5]);
+				assert.deepEqual(Array.from(profile.values), [0, 20, 21, 22]);
+			});
+			it('should interpolate', function() {
+				var profile = band.profile(line([1, 3.5, 2, 3.5]), {step: 0.5, interpolation: 'bilinear'});
+				assert.deepEqual(Array.from(profile.values), [0.5, 1, 1.5]);
+			});
+			it('should return nodataValue outside of the raster', function() {
+				var profile = band.profile(line([3.5, 3.5, 5.5, 3.5]), {nodataValue: -1});
+				assert.deepEqual(Array.from(profile.values), [3, -1, -1]);
+			});
+			it('should throw if step is not positive', function() {
+				assert.throws(function() {
+					band.profile(line([0, 0, 1, 1]), {step: 0});
+				}, RangeError);
+			});
+			it('should throw if not given a LineString', function() {
+				assert.throws(function() {
+					band.profile(new gdal.Point(1, 1));
+				});
+			});
+		});
+		describe('getHistogram()', function() {
+			var ds, band;
+			beforeEach(function() {
+				// values 0-9, ten pixels each
+				ds = gdal.open('temp', 'w', 'MEM', 10, 10, 1, gdal.GDT_Byte);
+				band = ds.bands.get(1);
+				var data = new Uint8Array(100);
+				for (var i = 0; i < 100; i++) data[i] = i % 10;
+				band.pixels.write(0, 0, 10, 10, data);
+			});
+			it('should count every byte value by default', function() {
+				var counts = band.getHistogram();
+				assert.instanceOf(counts, Uint32Array);
+				assert.equal(counts.length, 256);
+				for (var i = 0; i < 256; i++) assert.equal(counts[i], i < 10 ? 10 : 0);
+			});
+			it('should use the given buckets and range', function() {
+				assert.deepEqual(Array.from(band.getHistogram({buckets: 5, range: [0, 10]})), [20, 20, 20, 20, 20]);
+				assert.deepEqual(Array.from(band.getHistogram({buckets: 5, range: [0, 5]})), [10, 10, 10, 10, 10]);
+				assert.deepEqual(Array.from(band.getHistogram({buckets: 5, range: [0, 5], includeOutOfRange: true})), [10, 10, 10, 10, 60]);
+			});
+			it('should not count nodata values', function() {
+				band.noDataValue = 0;
+				var counts = band.getHistogram();
+				assert.equal(counts[0], 0);
+				assert.equal(counts[1], 10);
+			});
+			it('should span the values of non-byte bands', function() {
+				var fds = gdal.open('temp', 'w', 'MEM', 10, 10, 1, gdal.GDT_Float32);
+				var fband = fds.bands.get(1);
+				var data = new Float32Array(100);
+				for (var i = 0; i < 100; i++) data[i] = (i % 10) / 4 - 1;
+				fband.pixels.write(0, 0, 10, 10, data);
+				var counts = fband.getHistogram({buckets: 10});
+				assert.deepEqual(Array.from(counts), [10, 10, 10, 10, 10, 10, 10, 10, 10, 10]);
+			});
+			it('should throw on an invalid range', function() {
+				assert.throws(function() {
+					band.getHistogram({range: [10, 0]});
+				}, /min < max/);
+				assert.throws(function() {
+					band.getHistogram({buckets: 0});
+				}, /buckets/);
+			});
+			it('should compute the histogram asynchronously', function() {
+				var expected = Array.from(band.getHistogram({buckets: 5, range: [0, 10]}));
+				return band.getHistogramAsync({buckets: 5, range: [0, 10]}).then(function(counts) {
+					assert.instanceOf(counts, Uint32Array);
+					assert.deepEqual(Array.from(counts), expected);
+				});
+			});
+		});
+		describe('getDefaultHistogram()', function() {
+			var filename, ds, band;
+			beforeEach(function() {
+				filename = '/vsimem/histogram.' + String(Math.random()).substring(2) + '.tif';
+				ds = gdal.drivers.get('GTiff').create(filename, 10, 10, 1, gdal.GDT_Byte);
+				band = ds.bands.get(1);
+				band.fill(3);
+			});
+			afterEach(function() {
+				ds.close();
+				gdal.drivers.get('GTiff').deleteDataset(filename);
+			});
+			it('should return null if there is none and force is false', function() {
+				assert.isNull(band.getDefaultHistogram({force: false}));
+			});
+			it('should compute one by default', function() {
+				var result = band.getDefaultHistogram();
+				assert.equal(result.min, -0.5);
+				assert.equal(result.max, 255.5);
+				assert.equal(result.histogram.length, 256);
+				assert.equal(result.histogram[3], 100);
+			});
+			it('should return the histogram set with setDefaultHistogram()', function() {
+				band.setDefaultHistogram(0, 10, new Uint32Array([1, 2, 3]));
+				var result = band.getDefaultHistogram({force: false});
+				assert.equal(result.min, 0);
+				assert.equal(result.max, 10);
+				assert.deepEqual(Array.from(result.histogram), [1, 2, 3]);
+			});
+		});
 	});
 });
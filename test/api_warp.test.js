@@ -484,4 +484,76 @@ describe('gdal', function() {
 			it.skip('should throw error if GDAL can\'t create transformer', function() {});
 		}
 	});
+	describe('reprojectImageAsync()', function() {
+		var src;
+		beforeEach(function() {
+			src = gdal.open(__dirname + '/data/sample.tif');
+		});
+
+		function createOptions() {
+			var options = {
+				src: src,
+				s_srs: src.srs,
+				t_srs: gdal.SpatialReference.fromEPSG(4326)
+			};
+			var info = gdal.suggestedWarpOutput(options);
+			options.dst = gdal.open('temp', 'w', 'MEM', info.rasterSize.x, info.rasterSize.y, 1, gdal.GDT_Byte);
+			options.dst.geoTransform = info.geoTransform;
+			return options;
+		}
+
+		function createSignal() {
+			var listeners = [];
+			return {
+				aborted: false,
+				addEventListener: function(type, fn) { listeners.push(fn); },
+				removeEventListener: function(type, fn) { listeners.splice(listeners.indexOf(fn), 1); },
+				abort: function() {
+					this.aborted = true;
+					listeners.slice().forEach(function(fn) { fn(); });
+				}
+			};
+		}
+
+		it('should produce the same result as reprojectImage()', function() {
+			var options = createOptions();
+			gdal.reprojectImage(options);
+			var expected_checksum = gdal.checksumImage(options.dst.bands.get(1));
+
+			options = createOptions();
+			return gdal.reprojectImageAsync(options).then(function() {
+				assert.equal(gdal.checksumImage(options.dst.bands.get(1)), expected_checksum);
+			});
+		});
+		it('should report progress', function() {
+			var options = createOptions();
+			var values = [];
+			options.progress = function(complete) { values.push(complete); };
+			return gdal.reprojectImageAsync(options).then(function() {
+				assert.isAbove(values.length, 0);
+				assert.equal(values[values.length - 1], 1);
+			});
+		});
+		it('should reject with AbortError when cancelled', function() {
+			var options = createOptions();
+			var signal = createSignal();
+			options.signal = signal;
+			var promise = gdal.reprojectImageAsync(options);
+			signal.abort();
+			return promise.then(function() {
+				assert.fail('expected rejection');
+			}, function(err) {
+				assert.equal(err.name, 'AbortError');
+			});
+		});
+		it('should reject if src dataset has been closed', function() {
+			var options = createOptions();
+			src.close();
+			return gdal.reprojectImageAsync(options).then(function() {
+				assert.fail('expected rejection');
+			}, function(err) {
+				assert.instanceOf(err, Error);
+			});
+		});
+	});
 });
@@ -11,4 +11,46 @@ describe('Open', function() {
 			gdal.open(filename);
 		}, /Error opening dataset/);
 	});
+
+	describe('openAsync()', function() {
+		it('should resolve with a dataset', function() {
+			var filename = path.join(__dirname, 'data/sample.tif');
+			return gdal.openAsync(filename).then(function(ds) {
+				assert.ok(ds instanceof gdal.Dataset);
+				assert.equal(ds.driver.description, 'GTiff');
+			});
+		});
+		it('should reject when invalid file', function() {
+			var filename = path.join(__dirname, 'data/invalid');
+			return gdal.openAsync(filename).then(function() {
+				assert.fail('expected rejection');
+			}, function(err) {
+				assert.ok(err instanceof Error);
+			});
+		});
+		it('should respect allowedDrivers', function() {
+			var filename = path.join(__dirname, 'data/sample.tif');
+			return gdal.openAsync(filename, 'r', {allowedDrivers: 'PNG'}).then(function() {
+				assert.fail('expected rejection');
+			}, function(err) {
+				assert.ok(err instanceof Error);
+			});
+		});
+		it('should open many datasets concurrently', function() {
+			var filename = path.join(__dirname, 'data/sample.tif');
+			var pending = [];
+			for (var i = 0; i < 8; i++) pending.push(gdal.openAsync(filename));
+			return Promise.all(pending).then(function(datasets) {
+				datasets.forEach(function(ds) {
+					assert.equal(ds.bands.count(), 1);
+				});
+			});
+		});
+		it('should be available on drivers', function() {
+			var filename = path.join(__dirname, 'data/sample.tif');
+			return gdal.drivers.get('GTiff').openAsync(filename).then(function(ds) {
+				assert.ok(ds instanceof gdal.Dataset);
+			});
+		});
+	});
 });
@@ -0,0 +1,89 @@
+var gdal = require('../lib/gdal.js');
+var assert = require('chai').assert;
+var path = require('path');
+
+var worker_threads;
+try {
+	worker_threads = require('worker_threads');
+} catch (e) {
+	/* not available */
+}
+
+var GDAL_PATH = path.resolve(__dirname, '../lib/gdal.js');
+var SAMPLE_PATH = path.resolve(__dirname, 'data/sample.tif');
+
+function runWorker(source) {
+	return new Promise(function(resolve, reject) {
+		var worker = new worker_threads.Worker(source, {
+			eval: true,
+			workerData: {gdal: GDAL_PATH, sample: SAMPLE_PATH}
+		});
+		var result;
+		worker.on('message', function(msg) { result = msg; });
+		worker.on('error', reject);
+		worker.on('exit', function(code) {
+			if (code !== 0) reject(new Error('Worker exited with code ' + code));
+			else resolve(result);
+		});
+	});
+}
+
+(worker_threads ? describe : describe.skip)('worker_threads', function() {
+	afterEach(gc);
+
+	it('should load the module in several workers at once', function() {
+		var source = [
+			'var wt = require("worker_threads");',
+			'var gdal = require(wt.workerData.gdal);',
+			'var ds = gdal.open(wt.workerData.sample);',
+			'var band = ds.bands.get(1);',
+			'var data = band.pixels.read(0, 0, ds.rasterSize.x, ds.rasterSize.y);',
+			'var sum = 0;',
+			'for (var i = 0; i < data.length; i++) sum += data[i];',
+			'ds.close();',
+			'wt.parentPort.postMessage({sum: sum, drivers: gdal.drivers.count()});'
+		].join('\n');
+
+		var ds = gdal.open(SAMPLE_PATH);
+		var data = ds.bands.get(1).pixels.read(0, 0, ds.rasterSize.x, ds.rasterSize.y);
+		var expected = 0;
+		for (var i = 0; i < data.length; i++) expected += data[i];
+
+		return Promise.all([runWorker(source), runWorker(source), runWorker(source)]).then(function(results) {
+			results.forEach(function(result) {
+				assert.equal(result.sum, expected);
+				assert.equal(result.drivers, gdal.drivers.count());
+			});
+			// the main thread's objects are unaffected by the workers
+			assert.deepEqual(ds.rasterSize, gdal.open(SAMPLE_PATH).rasterSize);
+			ds.close();
+		});
+	});
+	it('should run async jobs inside a worker', function() {
+		var source = [
+			'var wt = require("worker_threads");',
+			'var gdal = require(wt.workerData.gdal);',
+			'var ds = gdal.open(wt.workerData.sample);',
+			'ds.bands.get(1).pixels.readAsync(0, 0, 16, 16).then(function(data) {',
+			'	wt.parentPort.postMessage({length: data.length});',
+			'});'
+		].join('\n');
+
+		return runWorker(source).then(function(result) {
+			assert.equal(result.length, 256);
+		});
+	});
+	it('should exit cleanly while datasets are open', function() {
+		var source = [
+			'var wt = require("worker_threads");',
+			'var gdal = require(wt.workerData.gdal);',
+			'var ds = gdal.open("temp", "w", "MEM", 64, 64, 1);',
+			'ds.bands.get(1).pixels.readAsync(0, 0, 64, 64);',
+			'wt.parentPort.postMessage({ok: true});'
+		].join('\n');
+
+		return runWorker(source).then(function(result) {
+			assert.isTrue(result.ok);
+		});
+	});
+});